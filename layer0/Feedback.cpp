@@ -21,6 +21,7 @@ Z* -------------------------------------------------------------------
 #include"MemoryDebug.h"
 #include"Feedback.h"
 #include"Ortho.h"
+#include"Parallel.h"
 
 int FeedbackInit(PyMOLGlobals * G, int quiet)
 {
@@ -149,6 +150,10 @@ void FeedbackAutoAdd(PyMOLGlobals * G, unsigned int sysmod, unsigned char mask,
 
 void FeedbackAdd(PyMOLGlobals * G, const char *str)
 {
+  if(auto scope = pymol::DetachedScope::current()) {
+    scope->output += str;
+    return;
+  }
   OrthoAddOutput(G, str);
 }
 
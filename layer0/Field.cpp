@@ -171,6 +171,8 @@ CField *FieldNewCopy(PyMOLGlobals * G, const CField * src)
       OOFreeP(I);
     }
     I = NULL;
+  } else {
+    MemoryTagAdd(cMemoryField, I->size, 1);
   }
   return I;
 }
@@ -231,6 +233,8 @@ CField *FieldNewFromPyList(PyMOLGlobals * G, PyObject * list)
   if(!ok) {
     OOFreeP(I);
     I = NULL;
+  } else {
+    MemoryTagAdd(cMemoryField, I->size, 1);
   }
   return (I);
 }
@@ -478,12 +482,14 @@ CField *FieldNew(PyMOLGlobals * G, int *dim, int n_dim, unsigned int base_size,
   I->data = (char *) mmalloc(stride);
   I->n_dim = n_dim;
   I->size = stride;
+  MemoryTagAdd(cMemoryField, I->size, 1);
   return (I);
 }
 
 void FieldFree(CField * I)
 {
   if(I) {
+    MemoryTagAdd(cMemoryField, -(long long) I->size, -1);
     FreeP(I->dim);
     FreeP(I->stride);
     FreeP(I->data);
@@ -3,6 +3,10 @@
  * Copyright (c) Schrodinger, LLC.
  *
  * Handling of "interned" strings in PyMOLGlobals::Lexicon
+ *
+ * All functions may be called concurrently (e.g. from file readers running
+ * on worker threads). A string returned by LexStr stays valid as long as
+ * a reference to its index is held.
  */
 
 #pragma once
@@ -17,6 +17,8 @@ Z* -------------------------------------------------------------------
 
 /* This file can be compiled under C as a .c file, or under C++ as a .cc file*/
 
+#include <atomic>
+
 #include"os_predef.h"
 #include"ov_port.h"
 
@@ -67,6 +69,58 @@ static void DieOutOfMemory(void)
   exit(EXIT_FAILURE);
 }
 
+/*
+ * Live bytes and number of allocations per memory tag. VLAs carry their
+ * tag in the header (untagged = cMemoryOther) and are accounted on every
+ * (re)allocation, other buffers are accounted with MemoryTagAdd. Process
+ * wide, since VLAs don't know their PyMOL instance.
+ */
+static std::atomic<long long> MemoryTagBytes[cMemoryTagCount];
+static std::atomic<long long> MemoryTagCounts[cMemoryTagCount];
+
+static const char * MemoryTagNames[cMemoryTagCount] = {
+  "other", "atoms", "coords", "cgo", "fields", "selector"
+};
+
+void MemoryTagAdd(int tag, long long bytes, int count)
+{
+  MemoryTagBytes[tag] += bytes;
+  MemoryTagCounts[tag] += count;
+}
+
+#define VLAByteSize(vla) ((long long) ((vla)->unit_size * (vla)->size))
+
+/*
+ * Move the accounting of a VLA to another subsystem. Tags are kept by
+ * VLAExpand, VLASetSize, etc. and copied by VLANewCopy.
+ */
+void VLASetTag(void *ptr, int tag)
+{
+  if(ptr) {
+    VLARec *vla = ((VLARec *) ptr) - 1;
+    if(vla->tag != tag) {
+      MemoryTagAdd(vla->tag, -VLAByteSize(vla), -1);
+      MemoryTagAdd(tag, VLAByteSize(vla), 1);
+      vla->tag = tag;
+    }
+  }
+}
+
+void MemoryGetUsage(long long *bytes, long long *counts)
+{
+  for(int a = 0; a < cMemoryTagCount; a++) {
+    if(bytes)
+      bytes[a] = MemoryTagBytes[a];
+    if(counts)
+      counts[a] = MemoryTagCounts[a];
+  }
+}
+
+const char *MemoryTagName(int tag)
+{
+  return (tag >= 0 && tag < cMemoryTagCount) ? MemoryTagNames[tag] : "";
+}
+
 void MemoryZero(char *p, char *q)
 {
   if(q - p)
@@ -80,6 +134,7 @@ void *VLAExpand(void *ptr, ov_size rec)
   unsigned int soffset = 0;
   vla = &(((VLARec *) ptr)[-1]);
   if(rec >= vla->size) {
+    long long old_bytes = VLAByteSize(vla);
     if(vla->auto_zero)
       soffset = sizeof(VLARec) + (vla->unit_size * vla->size);
     vla->size = ((unsigned int) (rec * vla->grow_factor)) + 1;
@@ -103,6 +158,7 @@ void *VLAExpand(void *ptr, ov_size rec)
         }
       }
     }
+    MemoryTagAdd(vla->tag, VLAByteSize(vla) - old_bytes, 0);
     if(vla->auto_zero) {
       start = ((char *) vla) + soffset;
       stop = ((char *) vla) + sizeof(VLARec) + (vla->unit_size * vla->size);
@@ -127,6 +183,8 @@ void *VLAMalloc(ov_size init_size, ov_size unit_size, unsigned int grow_factor,
   vla->unit_size = unit_size;
   vla->grow_factor = (1.0F + grow_factor * 0.1F);
   vla->auto_zero = auto_zero;
+  vla->tag = cMemoryOther;
+  MemoryTagAdd(vla->tag, VLAByteSize(vla), 1);
   if(vla->auto_zero) {
     start = ((char *) vla) + sizeof(VLARec);
     stop = ((char *) vla) + sizeof(VLARec) + (vla->unit_size * vla->size);
@@ -143,6 +201,7 @@ void VLAFree(void *ptr)
     exit(EXIT_FAILURE);
   }
   vla = &(((VLARec *) ptr)[-1]);
+  MemoryTagAdd(vla->tag, -VLAByteSize(vla), -1);
   mfree(vla);
 }
 
@@ -167,6 +226,7 @@ void *VLANewCopy(const void *ptr)
       exit(EXIT_FAILURE);
     } else {
       memcpy(new_vla, vla, size);
+      MemoryTagAdd(vla->tag, VLAByteSize(vla), 1);
     }
     return ((void *) &(new_vla[1]));
   } else {
@@ -181,6 +241,7 @@ void *VLASetSize(void *ptr, unsigned int new_size)
   char *stop;
   unsigned int soffset = 0;
   vla = &((VLARec *) ptr)[-1];
+  long long old_bytes = VLAByteSize(vla);
   if(vla->auto_zero) {
     soffset = sizeof(VLARec) + (vla->unit_size * vla->size);
   }
@@ -190,6 +251,7 @@ void *VLASetSize(void *ptr, unsigned int new_size)
     printf("VLASetSize-ERR: realloc failed.\n");
     DieOutOfMemory();
   }
+  MemoryTagAdd(vla->tag, VLAByteSize(vla) - old_bytes, 0);
   if(vla->auto_zero) {
     start = ((char *) vla) + soffset;
     stop = ((char *) vla) + sizeof(VLARec) + (vla->unit_size * vla->size);
@@ -275,6 +337,7 @@ void *VLASetSizeForSure(void *ptr, unsigned int new_size)
   char *stop;
   unsigned int soffset = 0;
   vla = &((VLARec *) ptr)[-1];
+  long long old_bytes = VLAByteSize(vla);
   if(vla->auto_zero) {
     soffset = sizeof(VLARec) + (vla->unit_size * vla->size);
   }
@@ -291,6 +354,7 @@ void *VLASetSizeForSure(void *ptr, unsigned int new_size)
     printf("VLASetSize-ERR: realloc failed.\n");
     DieOutOfMemory();
   }
+  MemoryTagAdd(vla->tag, VLAByteSize(vla) - old_bytes, 0);
   if(vla->auto_zero) {
     start = ((char *) vla) + soffset;
     stop = ((char *) vla) + sizeof(VLARec) + (vla->unit_size * vla->size);
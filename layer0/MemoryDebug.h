@@ -30,9 +30,26 @@ void UtilMemCpy(void *dst, void *src, unsigned int *size);
 typedef struct VLARec {
   ov_size size, unit_size;
   float grow_factor;
-  int auto_zero;
+  unsigned char auto_zero;
+  unsigned char tag;            /* cMemory*, see MemoryGetUsage */
 } VLARec;
 
+/* subsystems for memory accounting */
+enum {
+  cMemoryOther = 0,
+  cMemoryAtoms,                 /* atom info and bonds */
+  cMemoryCoords,                /* coordinate sets */
+  cMemoryCGO,                   /* CGO buffers (representations, CGO objects) */
+  cMemoryField,                 /* map and volume data */
+  cMemorySelector,              /* selector tables and members */
+  cMemoryTagCount
+};
+
+void VLASetTag(void *ptr, int tag);
+void MemoryTagAdd(int tag, long long bytes, int count);
+void MemoryGetUsage(long long *bytes, long long *counts);
+const char *MemoryTagName(int tag);
+
 
 /* NOTE: in VLACheck, rec is a zero based array index, not a record count */
 #define VLACheck(ptr,type,rec) VLACheck2<type>(ptr, rec)
@@ -0,0 +1,139 @@
+/*
+ * This file contains source code for the PyMOL computer program
+ * Copyright (c) Schrodinger, LLC.
+ *
+ * Minimal fork/join helpers for data-parallel loops over atoms, states
+ * or other independent work items. Thread counts are normally taken
+ * from the "max_threads" setting by the caller.
+ *
+ * Workers must not call into Python, the feedback system or anything
+ * else which touches global PyMOL state, unless they run inside a
+ * DetachedScope (see below).
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace pymol {
+
+/*
+ * Number of contiguous chunks to split `n` items into. Returns 1 (serial)
+ * if only one thread is available or if the input is too small to be
+ * worth spawning threads for.
+ *
+ * @param n_thread thread budget (e.g. "max_threads" setting)
+ * @param n number of items
+ * @param min_chunk minimum number of items per chunk
+ */
+inline int parallel_chunk_count(int n_thread, size_t n, size_t min_chunk = 4096)
+{
+  if (n_thread < 2 || n < 2 * min_chunk)
+    return 1;
+  return (int) std::min<size_t>(n_thread, n / min_chunk);
+}
+
+/*
+ * Calls `func(chunk, begin, end)` for `n_chunk` contiguous sub-ranges of
+ * [0, n). Chunk 0 runs on the calling thread. Chunks are numbered in
+ * order, so per-chunk results can be merged deterministically.
+ */
+template <typename Func>
+void parallel_for_chunks(int n_chunk, size_t n, Func func)
+{
+  if (n_chunk < 2) {
+    func(0, size_t(0), n);
+    return;
+  }
+
+  std::vector<std::thread> threads;
+  threads.reserve(n_chunk - 1);
+
+  for (int c = 1; c < n_chunk; ++c) {
+    size_t begin = n * c / n_chunk;
+    size_t end = n * (c + 1) / n_chunk;
+    threads.emplace_back([&func, c, begin, end]() { func(c, begin, end); });
+  }
+
+  func(0, size_t(0), n / n_chunk);
+
+  for (auto& t : threads)
+    t.join();
+}
+
+/*
+ * Calls `func(i)` for every i in [0, n) on at most `n_thread` threads.
+ * Items are handed out dynamically, which balances work items of
+ * uneven cost (e.g. states or object pairs).
+ */
+template <typename Func>
+void parallel_for(int n_thread, int n, Func func)
+{
+  n_thread = std::min(n_thread, n);
+
+  if (n_thread < 2) {
+    for (int i = 0; i < n; ++i)
+      func(i);
+    return;
+  }
+
+  std::atomic<int> next(0);
+  auto worker = [&]() {
+    for (int i; (i = next++) < n;)
+      func(i);
+  };
+
+  std::vector<std::thread> threads;
+  threads.reserve(n_thread - 1);
+
+  for (int t = 1; t < n_thread; ++t)
+    threads.emplace_back(worker);
+
+  worker();
+
+  for (auto& t : threads)
+    t.join();
+}
+
+/*
+ * Marks the current thread as building objects which are not (yet) known
+ * to the Executive, e.g. parsing files in ExecutiveLoadBatch. While a
+ * scope is active, functions which would otherwise update global state
+ * for the new object (scene frame count, selector eval cache, auto color,
+ * ...) leave it alone, and feedback goes to `output` instead of the
+ * output window. The caller replays `output` and does the global updates
+ * once the objects get registered on the main thread.
+ */
+class DetachedScope {
+  DetachedScope* m_prev;
+
+public:
+  std::string output;
+
+  DetachedScope() : m_prev(current()) { current() = this; }
+  ~DetachedScope() { current() = m_prev; }
+
+  DetachedScope(const DetachedScope&) = delete;
+  DetachedScope& operator=(const DetachedScope&) = delete;
+
+  /*
+   * Innermost scope of the calling thread, or NULL
+   */
+  static DetachedScope*& current()
+  {
+    static thread_local DetachedScope* scope = nullptr;
+    return scope;
+  }
+};
+
+inline bool is_detached()
+{
+  return DetachedScope::current() != nullptr;
+}
+
+} // namespace pymol
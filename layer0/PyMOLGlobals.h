@@ -55,6 +55,7 @@ typedef struct _CText CText;
 struct CWizard;
 typedef struct _CAtomInfo CAtomInfo;
 typedef struct _CSculptCache CSculptCache;
+struct CRepCache;
 typedef struct _CVFont CVFont;
 typedef struct _CEditor CEditor;
 struct CExecutive;
@@ -140,6 +141,7 @@ struct _PyMOLGlobals {
   CWizard *Wizard;
   CAtomInfo *AtomInfo;
   CSculptCache *SculptCache;
+  CRepCache *RepCache;
   CVFont *VFont;
   CEditor *Editor;
   CExecutive *Executive;
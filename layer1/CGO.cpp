@@ -280,7 +280,8 @@ static float *CGO_add(CGO * I, int c);
 static float *CGO_size(CGO * I, int sz);
 static int CGOSimpleCylinder(CGO * I, float *v1, float *v2, float tube_size, float *c1,
                              float *c2, bool interp, int cap1, int cap2,
-                             Pickable *pickcolor2 = NULL, bool stick_round_nub = false);
+                             Pickable *pickcolor2 = NULL, bool stick_round_nub = false,
+                             int stick_quality = -1);
 static int CGOSimpleEllipsoid(CGO * I, float *v, float vdw, float *n0, float *n1,
 			      float *n2);
 static int CGOSimpleQuadric(CGO * I, float *v, float vdw, float *q);
@@ -468,6 +469,7 @@ CGO *CGONew(PyMOLGlobals * G, int size)
   auto I = new CGO();
   I->G = G;
   I->op = VLACalloc(float, size + 32);
+  VLASetTag(I->op, cMemoryCGO);
 #ifdef _PYMOL_IOS
   if (!I->op){
     delete I;
@@ -1574,7 +1576,8 @@ CGO *CGOCombineBeginEnd(const CGO * I, int est, bool do_not_split_lines)
   int ok = true;
   if (!I)
       return NULL;
-  cgo = CGONewSized(I->G, 0);
+  /* arrays take about as much space as the BEGIN/END blocks they replace */
+  cgo = CGONewSized(I->G, I->c + est);
   ok &= cgo ? true : false;
 
   for (auto it = I->begin(); ok && !it.is_stop(); ++it) {
@@ -4108,8 +4111,10 @@ CGO *CGOOptimizeSpheresToVBONonIndexed(const CGO * I, int est, bool addshaders,
  *                     (if -1, defaults to cgo_sphere_quality)
  * stick_round_nub: if true, a round cap is generated, otherwise, it generates
  *                  the old "pointed" caps
+ * stick_quality:   number of cylinder edges (if -1, defaults to stick_quality)
  */
-CGO *CGOSimplify(const CGO * I, int est, short sphere_quality, bool stick_round_nub)
+CGO *CGOSimplify(const CGO * I, int est, short sphere_quality, bool stick_round_nub,
+                 int stick_quality)
 {
   CGO *cgo;
   float *pc = I->op;
@@ -4141,7 +4146,7 @@ CGO *CGOSimplify(const CGO * I, int est, short sphere_quality, bool stick_round_
         int bcap = (cap & 2) ? ((cap & cCylShaderCap2RoundBit) ? 2 : 1) : 0;
 	add3f(pc, pc + 3, v2);
         ok &= CGOSimpleCylinder(cgo, pc, v2, *(pc + 6), 0, 0, (cap & cCylShaderInterpColor),
-                                fcap, bcap, NULL, stick_round_nub);
+                                fcap, bcap, NULL, stick_round_nub, stick_quality);
       }
       break;
     case CGO_SHADER_CYLINDER_WITH_2ND_COLOR:
@@ -4157,29 +4162,29 @@ CGO *CGOSimplify(const CGO * I, int est, short sphere_quality, bool stick_round_
         mult3f(pc + 3, .5f, mid);
         add3f(pc, mid, mid);
         if (cap & cCylShaderInterpColor){
-          ok &= CGOSimpleCylinder(cgo, pc, v1, *(pc + 6), color1, pc+8, true, bcap, fcap, &pickcolor2, stick_round_nub);
+          ok &= CGOSimpleCylinder(cgo, pc, v1, *(pc + 6), color1, pc+8, true, bcap, fcap, &pickcolor2, stick_round_nub, stick_quality);
         } else {
           ok &= CGOColorv(cgo, color1);
-          ok &= CGOSimpleCylinder(cgo, pc, mid, *(pc + 6), color1, NULL, false, fcap, 0, NULL, stick_round_nub);
+          ok &= CGOSimpleCylinder(cgo, pc, mid, *(pc + 6), color1, NULL, false, fcap, 0, NULL, stick_round_nub, stick_quality);
           ok &= CGOColorv(cgo, pc+8);
           ok &= CGOPickColor(cgo, pickcolor2.index, pickcolor2.bond);
-          ok &= CGOSimpleCylinder(cgo, mid, v1, *(pc + 6), pc+8, NULL, false, 0, bcap, NULL, stick_round_nub);
+          ok &= CGOSimpleCylinder(cgo, mid, v1, *(pc + 6), pc+8, NULL, false, 0, bcap, NULL, stick_round_nub, stick_quality);
         }
       }
       break;
     case CGO_CYLINDER:
-      ok &= CGOSimpleCylinder(cgo, pc, pc + 3, *(pc + 6), pc + 7, pc + 10, true, 1, 1, NULL, stick_round_nub);
+      ok &= CGOSimpleCylinder(cgo, pc, pc + 3, *(pc + 6), pc + 7, pc + 10, true, 1, 1, NULL, stick_round_nub, stick_quality);
       break;
     case CGO_CONE:
       ok &= CGOSimpleCone(cgo, pc, pc + 3, *(pc + 6), *(pc + 7), pc + 8, pc + 11,
                     (int) *(pc + 14), (int) *(pc + 15));
       break;
     case CGO_SAUSAGE:
-      ok &= CGOSimpleCylinder(cgo, pc, pc + 3, *(pc + 6), pc + 7, pc + 10, true, 2, 2, NULL, stick_round_nub);
+      ok &= CGOSimpleCylinder(cgo, pc, pc + 3, *(pc + 6), pc + 7, pc + 10, true, 2, 2, NULL, stick_round_nub, stick_quality);
       break;
     case CGO_CUSTOM_CYLINDER:
       ok &= CGOSimpleCylinder(cgo, pc, pc + 3, *(pc + 6), pc + 7, pc + 10, true, (int) *(pc + 13),
-                              (int) *(pc + 14), NULL, stick_round_nub);
+                              (int) *(pc + 14), NULL, stick_round_nub, stick_quality);
       break;
     case CGO_SPHERE:
       ok &= CGOSimpleSphere(cgo, pc, *(pc + 3), sphere_quality);
@@ -4405,6 +4410,37 @@ CGO *CGOSimplify(const CGO * I, int est, short sphere_quality, bool stick_round_
   return (cgo);
 }
 
+/*
+ * CGOSimplify -> CGOCombineBeginEnd -> CGOOptimizeToVBONotIndexed (only
+ * with use_shader), the pipeline used by most representations. Every
+ * stage is allocated at its expected size up front (the simplified CGO
+ * from `size_hint`, if given, which is updated for the next build) and
+ * intermediates are freed as soon as they have been consumed.
+ *
+ * size_hint: RepSizeHint::simplified (or ::simplified_alpha) of the rep
+ */
+CGO *CGOSimplifyCombineOptimize(const CGO * I, bool use_shader, int * size_hint,
+                                short sphere_quality, bool stick_round_nub,
+                                int stick_quality)
+{
+  int est = (size_hint && *size_hint > I->c) ? *size_hint - I->c : 0;
+  CGO *simplified = CGOSimplify(I, est, sphere_quality, stick_round_nub, stick_quality);
+  if (!simplified)
+    return NULL;
+  if (size_hint)
+    *size_hint = simplified->c;
+
+  CGO *cgo = CGOCombineBeginEnd(simplified, 0);
+  CGOFree(simplified);
+
+  if (cgo && use_shader) {
+    CGO *optimized = CGOOptimizeToVBONotIndexed(cgo, 0);
+    CGOFree(cgo);
+    cgo = optimized;
+  }
+  return cgo;
+}
+
 /*
  * converts a CGO that has primitives into pure geomtry, just like CGOSimplify
  *    but without converting the CGO_BEGIN/CGO_END blocks.
@@ -5208,6 +5244,88 @@ int CGOGetExtent(CGO * I, float *mn, float *mx)
   return (result);
 }
 
+template <typename T>
+static size_t CGOOpHeapSize(const float * pc)
+{
+  auto sp = reinterpret_cast<const T *>(pc);
+  return sp->get_data() ? sp->get_data_length() * sizeof(float) : 0;
+}
+
+/*
+ * Approximate memory footprint of a CGO in bytes: the op buffer, the
+ * per-op data heap, and an estimate of the vertex/index buffers which
+ * the draw buffer ops hold on the GPU.
+ */
+size_t CGOGetMemSize(const CGO * I)
+{
+  if(!I)
+    return 0;
+
+  size_t size = sizeof(CGO) + I->c * sizeof(float);
+
+  for (auto it = I->begin(); !it.is_stop(); ++it) {
+    auto pc = it.data();
+    switch (it.op_code()) {
+    case CGO_DRAW_ARRAYS:
+      size += CGOOpHeapSize<cgo::draw::arrays>(pc);
+      break;
+    case CGO_DRAW_BUFFERS_INDEXED:
+      {
+        auto sp = it.cast<cgo::draw::buffers_indexed>();
+        size += CGOOpHeapSize<cgo::draw::buffers_indexed>(pc);
+        size += sp->nverts * sp->narrays * 3 * sizeof(float) + sp->nindices * sizeof(GL_C_INT_TYPE);
+      }
+      break;
+    case CGO_DRAW_BUFFERS_NOT_INDEXED:
+      {
+        auto sp = it.cast<cgo::draw::buffers_not_indexed>();
+        size += CGOOpHeapSize<cgo::draw::buffers_not_indexed>(pc);
+        size += sp->nverts * sp->narrays * 3 * sizeof(float);
+      }
+      break;
+    case CGO_DRAW_SPHERE_BUFFERS:
+      {
+        auto sp = it.cast<cgo::draw::sphere_buffers>();
+        size += CGOOpHeapSize<cgo::draw::sphere_buffers>(pc);
+        /* 4 vertices: position, radius/corner, color */
+        size += sp->num_spheres * 4 * 5 * sizeof(float);
+      }
+      break;
+    case CGO_DRAW_CYLINDER_BUFFERS:
+      {
+        auto sp = it.cast<cgo::draw::cylinder_buffers>();
+        size += CGOOpHeapSize<cgo::draw::cylinder_buffers>(pc);
+        /* 8 box vertices: origin, axis, radius/flags, 2 colors; 36 indices */
+        size += sp->num_cyl * (8 * 9 * sizeof(float) + 36 * sizeof(GL_C_INT_TYPE));
+      }
+      break;
+    case CGO_DRAW_TEXTURES:
+      {
+        auto sp = it.cast<cgo::draw::textures>();
+        size += CGOOpHeapSize<cgo::draw::textures>(pc);
+        size += sp->ntextures * 6 * 8 * sizeof(float);
+      }
+      break;
+    case CGO_DRAW_LABELS:
+      {
+        auto sp = it.cast<cgo::draw::labels>();
+        size += CGOOpHeapSize<cgo::draw::labels>(pc);
+        size += sp->ntextures * 6 * 17 * sizeof(float);
+      }
+      break;
+    case CGO_DRAW_CUSTOM:
+      {
+        auto sp = it.cast<cgo::draw::custom>();
+        size += CGOOpHeapSize<cgo::draw::custom>(pc);
+        size += sp->nverts * 8 * sizeof(float) + sp->nindices * sizeof(GL_C_INT_TYPE);
+      }
+      break;
+    }
+  }
+
+  return size;
+}
+
 int CGOHasNormals(CGO * I)
 {
   float *pc = I->op;
@@ -8405,7 +8523,8 @@ void CGORoundNub(CGO * I,
 
 static int CGOSimpleCylinder(CGO * I, float *v1, float *v2, float tube_size, float *c1,
                              float *c2, bool interp, int cap1, int cap2,
-                             Pickable *pickcolor2, bool stick_round_nub)
+                             Pickable *pickcolor2, bool stick_round_nub,
+                             int stick_quality)
 {
 #define MAX_EDGE 50
 
@@ -8429,7 +8548,8 @@ static int CGOSimpleCylinder(CGO * I, float *v1, float *v2, float tube_size, flo
     pickcolor[1].bond = pickcolor[0].bond;
   }
   v = v_buf;
-  nEdge = SettingGetGlobal_i(I->G, cSetting_stick_quality);
+  nEdge = (stick_quality < 0) ?
+    SettingGetGlobal_i(I->G, cSetting_stick_quality) : stick_quality;
   overlap = tube_size * SettingGetGlobal_f(I->G, cSetting_stick_overlap);
   nub = tube_size * SettingGetGlobal_f(I->G, cSetting_stick_nub);
 
@@ -8911,6 +9031,33 @@ void CGO::free_append(CGO * &src) {
   CGOFreeWithoutVBOs(src);
 }
 
+/*
+ * Appends a copy of `src` to the end of this CGO. Unlike append(), the
+ * buffer is copied in one go if `src` has no heap data (e.g. only
+ * immediate mode primitives).
+ */
+void CGO::copy_append(const CGO * src) {
+  if (!src->_data_heap.empty()) {
+    append(src, false);
+    return;
+  }
+
+  if (!src->c)
+    return;
+
+  VLACheck(op, float, c + src->c);
+  memcpy(op + c, src->op, src->c * sizeof(float));
+  c += src->c;
+  *(op + c) = 0;
+
+  has_draw_buffers            |= src->has_draw_buffers;
+  has_draw_cylinder_buffers   |= src->has_draw_cylinder_buffers;
+  has_draw_sphere_buffers     |= src->has_draw_sphere_buffers;
+  has_begin_end               |= src->has_begin_end;
+  use_shader                  |= src->use_shader;
+  render_alpha                |= src->render_alpha;
+}
+
 int CGOAppend(CGO *dest, const CGO *source, bool stopAtEnd){
   int ok = dest->append(source, stopAtEnd);
   return ok;
@@ -742,6 +742,7 @@ public:
   int append(const CGO * source, bool stopAtEnd);
   void move_append(CGO * source);
   void free_append(CGO * &source);
+  void copy_append(const CGO * source);
 
   // Allocates in our CGO data pool
   float * allocate_in_data_heap(size_t size) {
@@ -807,13 +808,18 @@ CGO *CGONew(PyMOLGlobals * G, int size=0);
 #define CGONewSized CGONew
 int CGOGetExtent(CGO * I, float *mn, float *mx);
 int CGOHasNormals(CGO * I);
+size_t CGOGetMemSize(const CGO * I);
 
 void CGOFree(CGO * &I, bool withVBOs=true);
 #define CGOFreeWithoutVBOs(I) CGOFree(I, false)
 
 CGO *CGODrawText(CGO * I, int est, float *camera);
 
-CGO *CGOSimplify(const CGO * I, int est, short sphere_quality = -1, bool stick_round_nub = true);
+CGO *CGOSimplify(const CGO * I, int est, short sphere_quality = -1, bool stick_round_nub = true,
+                 int stick_quality = -1);
+CGO *CGOSimplifyCombineOptimize(const CGO * I, bool use_shader, int * size_hint = NULL,
+                                short sphere_quality = -1, bool stick_round_nub = true,
+                                int stick_quality = -1);
 CGO *CGOSimplifyNoCompress(const CGO * I, int est, short sphere_quality = -1, bool stick_round_nub = true);
 
 // -1 - no lines, 0 - some no interpolation, 1 - all interpolation, 2 - all no interpolation
@@ -1478,6 +1478,22 @@ ImageType *MovieGetImage(PyMOLGlobals * G, int index)
 }
 
 
+/*========================================================================*/
+/*
+ * Total size of the cached movie frame images in bytes
+ */
+size_t MovieGetImageBytes(PyMOLGlobals * G)
+{
+  CMovie *I = G->Movie;
+  size_t bytes = 0;
+  for(int a = 0; a < I->NImage; a++) {
+    if(I->Image[a] && I->Image[a]->data)
+      bytes += I->Image[a]->size;
+  }
+  return bytes;
+}
+
+
 /*========================================================================*/
 int MovieDefined(PyMOLGlobals * G)
 {
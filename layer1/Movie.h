@@ -62,6 +62,7 @@ void MovieSetSize(PyMOLGlobals * G, unsigned int width, unsigned int height);
 
 void MovieClearImages(PyMOLGlobals * G);
 ImageType *MovieGetImage(PyMOLGlobals * G, int image);
+size_t MovieGetImageBytes(PyMOLGlobals * G);
 void MovieSetImage(PyMOLGlobals * G, int index, ImageType * image);
 
 int MovieGetLength(PyMOLGlobals * G);
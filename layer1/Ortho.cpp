@@ -53,6 +53,7 @@ Z* -------------------------------------------------------------------
 #include "MacPyMOL.h"
 #include "File.h"
 #include "LangUtil.h"
+#include "Parallel.h"
 
 #define OrthoSaveLines 0xFF
 #define OrthoHistoryLines 0xFF
@@ -412,6 +413,8 @@ void OrthoRemoveAutoOverlay(PyMOLGlobals * G)
 void OrthoRemoveSplash(PyMOLGlobals * G)
 {
   COrtho *I = G->Ortho;
+  if(pymol::is_detached())
+    return;
   I->SplashFlag = false;
 }
 
@@ -523,6 +526,9 @@ void OrthoBusyMessage(PyMOLGlobals * G, const char *message)
 /*========================================================================*/
 void OrthoBusySlow(PyMOLGlobals * G, int progress, int total)
 {
+  if(pymol::is_detached())
+    return;                     /* detached builds may run on worker threads */
+
   COrtho *I = G->Ortho;
   double time_yet = (-I->BusyLastUpdate) + UtilGetSeconds(G);
 
@@ -553,6 +559,9 @@ void OrthoBusySlow(PyMOLGlobals * G, int progress, int total)
 /*========================================================================*/
 void OrthoBusyFast(PyMOLGlobals * G, int progress, int total)
 {
+  if(pymol::is_detached())
+    return;                     /* detached builds may run on worker threads */
+
   COrtho *I = G->Ortho;
   double time_yet = (-I->BusyLastUpdate) + UtilGetSeconds(G);
   short finished = progress == total;
@@ -559,6 +559,11 @@ void ObjectAdjustStateRebuildRange(CObject * I, int *start, int *stop)
   int dummy;
   if (all_states)
     return;
+  if(defer_builds_mode == 0) {
+    /* a representation budget implies building states on demand */
+    if(SettingGetGlobal_i(I->G, cSetting_rep_cache_max) > 0)
+      defer_builds_mode = 1;
+  }
   if(defer_builds_mode >= 3) {
     if(SceneObjectIsActive(I->G, I))
       defer_builds_mode = 2;
@@ -25,13 +25,13 @@ Z* -------------------------------------------------------------------
 #include"Rep.h"
 #include"MemoryDebug.h"
 #include"CoordSet.h"
+#include"ObjectMolecule.h"
 #include"P.h"
 #include"Util.h"
 
 
 /*========================================================================*/
 
-struct Rep *RepUpdate(struct Rep *I, struct CoordSet *cs, int state, int rep);
 struct Rep *RepRebuild(struct Rep *I, struct CoordSet *cs, int state, int rep);
 
 
@@ -136,6 +136,21 @@ int RepGetAutoShowMask(PyMOLGlobals * G)
   return mask;
 }
 
+/*
+ * Level of detail: factor by which the tessellation of `cs` should be
+ * coarsened so that a representation with `n_triangles` triangles at full
+ * quality fits into "lod_triangle_budget". 1.0 if there is no budget or
+ * the representation already fits.
+ */
+float RepGetLodScale(struct CoordSet * cs, double n_triangles)
+{
+  int budget = SettingGet_i(cs->State.G, cs->Setting, cs->Obj->Obj.Setting,
+                            cSetting_lod_triangle_budget);
+  if(budget <= 0 || n_triangles <= budget)
+    return 1.0F;
+  return (float) (budget / n_triangles);
+}
+
 /*========================================================================*/
 static void RepRenderBox(struct Rep *this_, RenderInfo * info)
 {
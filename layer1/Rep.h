@@ -166,6 +166,14 @@ const int cRepsObjectMask = (cRepSurfaceBit | cRepMeshBit | cRepDotBit | \
 struct CoordSet;
 struct Object;
 
+/* CGO sizes (in floats) of the last build of a representation, used to
+ * size the buffers of the next build instead of growing them step by step */
+typedef struct RepSizeHint {
+  int primitive;                /* CGO as generated by the rep */
+  int simplified;               /* after CGOSimplify */
+  int simplified_alpha;         /* after CGOSimplify, transparent pipeline (cartoon) */
+} RepSizeHint;
+
 typedef struct Rep {
   PyMOLGlobals *G;
   void (*fRender) (struct Rep * I, RenderInfo * info);
@@ -183,13 +191,16 @@ typedef struct Rep {
   int (*fSameColor) (struct Rep * I, struct CoordSet * cs);
   struct Rep *(*fRebuild) (struct Rep * I, struct CoordSet * cs, int state, int rep);
   struct Rep *(*fNew) (struct CoordSet * cs, int state);
+  size_t (*fMemSize) (struct Rep * I);  /* optional, approximate bytes held */
 } Rep;
 
 void RepInit(PyMOLGlobals * G, Rep * I);
 void RepPurge(Rep * I);
 void RepInvalidate(struct Rep *I, struct CoordSet *cs, int level);
+struct Rep *RepUpdate(struct Rep *I, struct CoordSet *cs, int state, int rep);
 
 int RepGetAutoShowMask(PyMOLGlobals * G);
+float RepGetLodScale(struct CoordSet * cs, double n_triangles);
 
 class RepIterator {
   int end;
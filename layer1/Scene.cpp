@@ -60,6 +60,8 @@ Z* -------------------------------------------------------------------
 #include "ShaderMgr.h"
 #include "PopUp.h"
 #include "MacPyMOL.h"
+#include "RepCache.h"
+#include "Parallel.h"
 #include <string>
 #include <vector>
 #include <algorithm>
@@ -1959,6 +1961,8 @@ int SceneCountFrames(PyMOLGlobals * G)
   CScene *I = G->Scene;
   int n;
   int mov_len;
+  if(pymol::is_detached())
+    return I->NFrame;
   I->NFrame = 0;
   for ( auto it = I->Obj.begin(); it != I->Obj.end(); ++it) {
     n = (*it)->getNFrame();
@@ -2467,7 +2471,11 @@ void SceneOriginSet(PyMOLGlobals * G, float *origin, int preserve)
 
 
 /*========================================================================*/
-int SceneObjectAdd(PyMOLGlobals * G, CObject * obj)
+/*
+ * count_frames: false if the caller will call SceneCountFrames after
+ * adding many objects
+ */
+int SceneObjectAdd(PyMOLGlobals * G, CObject * obj, bool count_frames)
 {
   CScene *I = G->Scene;
   obj->Enabled = true;
@@ -2477,7 +2485,8 @@ int SceneObjectAdd(PyMOLGlobals * G, CObject * obj)
   } else {
     I->NonGadgetObjs.push_back(obj);
   }
-  SceneCountFrames(G);
+  if(count_frames)
+    SceneCountFrames(G);
   SceneChanged(G);
   SceneInvalidatePicking(G); // PYMOL-2793
   return 1;
@@ -6392,6 +6401,10 @@ void SceneUpdate(PyMOLGlobals * G, int force)
     if(SettingGetGlobal_i(G, cSetting_draw_mode) == -2) {
       defer_builds_mode = 1;
     }
+    /* a representation budget implies building states on demand */
+    if(SettingGetGlobal_i(G, cSetting_rep_cache_max) > 0) {
+      defer_builds_mode = 1;
+    }
   }
 
   if(force || I->ChangedFlag || ((cur_state != I->LastStateBuilt) &&
@@ -6459,6 +6472,9 @@ void SceneUpdate(PyMOLGlobals * G, int force)
           int cnt = I->NonGadgetObjs.size();
 
           if(cnt) {
+            /* workers may update any state, wait for background builds */
+            RepCacheJoin(G);
+
             CObjectUpdateThreadInfo *thread_info = Alloc(CObjectUpdateThreadInfo, cnt);
             if(thread_info) {
               cnt = 0;
@@ -6477,6 +6493,9 @@ void SceneUpdate(PyMOLGlobals * G, int force)
           }
       }
       PyMOL_SetBusy(G->PyMOL, false);   /*  race condition -- may need to be fixed */
+
+      /* free least recently shown states beyond the rep_cache_max budget */
+      RepCacheTrim(G);
     } else { /* defer builds mode == 5 -- for now, only update non-molecular objects */
       /* single-threaded update */
       for ( auto it = I->Obj.begin(); it != I->Obj.end(); ++it) {
@@ -6533,6 +6552,10 @@ void SceneUpdate(PyMOLGlobals * G, int force)
       if(SettingGetGlobal_i(G, cSetting_frame) != (cur_state + 1))
         SettingSetGlobal_i(G, cSetting_frame, (cur_state + 1));
     }
+
+    /* build upcoming movie states while this one is shown */
+    if(MoviePlaying(G) && defer_builds_mode != 5)
+      RepCachePrefetch(G, I->NonGadgetObjs);
   }
 
   PRINTFD(G, FB_Scene)
@@ -117,7 +117,7 @@ void SceneResetNormalToViewVector(PyMOLGlobals * G, short use_shader);
 void SceneResetNormalUseShaderAttribute(PyMOLGlobals * G, int lines, short use_shader, int attr);
 void SceneGetResetNormal(PyMOLGlobals * G, float *normal, int lines);
 
-int SceneObjectAdd(PyMOLGlobals * G, CObject * obj);
+int SceneObjectAdd(PyMOLGlobals * G, CObject * obj, bool count_frames = true);
 int SceneObjectDel(PyMOLGlobals * G, CObject * obj, int allow_purge);
 int SceneObjectIsActive(PyMOLGlobals * G, CObject * obj);
 void SceneOriginSet(PyMOLGlobals * G, float *origin, int preserve);
@@ -43,6 +43,7 @@ Z* -------------------------------------------------------------------
 #include"Sphere.h"
 #include"Selector.h"
 #include"Parse.h"
+#include"RepCache.h"
 
 /*
  * Setting level info table
@@ -139,6 +140,7 @@ void SettingUniqueDetachChain(PyMOLGlobals * G, int unique_id)
 {
   CSettingUnique *I = G->SettingUnique;
   OVreturn_word result;
+  RepCacheJoin(G);              /* background builds read unique settings */
   if(OVreturn_IS_OK(result = OVOneToOne_GetForward(I->id2offset, unique_id))) {
     int offset = result.word;
     int next;
@@ -330,6 +332,7 @@ static void SettingUniqueEntry_Set(SettingUniqueEntry *entry, int value_type, co
 bool SettingUniqueUnset(PyMOLGlobals * G, int unique_id, int setting_id)
 {
   auto I = G->SettingUnique;
+  RepCacheJoin(G);              /* background builds read unique settings */
   auto result = OVOneToOne_GetForward(I->id2offset, unique_id);
 
   if (OVreturn_IS_OK(result)) {
@@ -368,6 +371,8 @@ int SettingUniqueSetTypedValue(PyMOLGlobals * G, int unique_id, int setting_id,
     return SettingUniqueUnset(G, unique_id, setting_id);
   }
 
+  RepCacheJoin(G);              /* background builds read unique settings */
+
   if(OVreturn_IS_OK((result = OVOneToOne_GetForward(I->id2offset, unique_id)))) {       /* setting list exists for atom */
     int offset = result.word;
     int prev = 0;
@@ -486,6 +491,7 @@ ok_except1:
 void SettingUniqueResetAll(PyMOLGlobals * G)
 {
   CSettingUnique *I = G->SettingUnique;
+  RepCacheJoin(G);              /* background builds read unique settings */
 
   OVOneToOne_Reset(I->id2offset);
   {
@@ -713,8 +719,14 @@ int SettingUniqueFromPyList(PyMOLGlobals * G, PyObject * list, int partial_resto
   }
   if(list)
     if(PyList_Check(list)) {
+      CSettingUnique *I = G->SettingUnique;
       ov_size n_id = PyList_Size(list);
       ov_size a;
+      /* presize for one setting list per id */
+      OVOneToOne_Reserve(I->id2offset,
+                         OVOneToOne_GetSize(I->id2offset).size + n_id);
+      if(partial_restore && I->old2new)
+        OVOneToOne_Reserve(I->old2new, OVOneToOne_GetSize(I->old2new).size + n_id);
       for(a = 0; a < n_id; a++) {
         PyObject *id_list = PyList_GetItem(list, a);
         int unique_id;
@@ -1807,6 +1819,7 @@ int SettingSet_s(CSetting * I, int index, const char *value)
       int setting_type = SettingInfo[index].type;
       switch (setting_type) {
       case cSetting_string:
+        RepCacheJoin(G);        /* background builds may read the old string */
         I->info[index].set_s(value);
 	break;
       case cSetting_color:
@@ -1931,9 +1944,18 @@ void SettingGenerateSideEffects(PyMOLGlobals * G, int index, const char *sele, i
   case cSetting_grid_max:
     SceneChanged(G);
     break;
+  case cSetting_ignore_case:
+  case cSetting_ignore_case_chain:
+  case cSetting_wildcard:
+  case cSetting_atom_name_wildcard:
+    SelectorInvalidateEvalCache(G);
+    break;
   case cSetting_defer_builds_mode:
     ExecutiveRebuildAll(G);
     break;
+  case cSetting_rep_cache_max:
+    SceneChanged(G);
+    break;
   case cSetting_seq_view:
   case cSetting_seq_view_label_spacing:
   case cSetting_seq_view_label_mode:
@@ -2482,6 +2504,12 @@ void SettingGenerateSideEffects(PyMOLGlobals * G, int index, const char *sele, i
     ExecutiveInvalidateRep(G, inv_sele, cRepSphere, cRepInvRep);
     SceneChanged(G);
     break;
+  case cSetting_lod_triangle_budget:
+    ExecutiveInvalidateRep(G, inv_sele, cRepCyl, cRepInvRep);
+    ExecutiveInvalidateRep(G, inv_sele, cRepSphere, cRepInvRep);
+    ExecutiveInvalidateRep(G, inv_sele, cRepCartoon, cRepInvRep);
+    SceneChanged(G);
+    break;
   case cSetting_nonbonded_size:
   case cSetting_nonbonded_transparency:
     ExecutiveInvalidateRep(G, inv_sele, cRepNonbonded, cRepInvRep);
@@ -875,6 +875,9 @@ enum {
   REC_b( 765, sdf_write_zero_order_bonds              , global    , 0 ),
   REC_b( 766, cif_metalc_as_zero_order_bonds          , global    , 1 ),
   REC_i( 767, seq_view_gap_mode                       , global    , 0 ),
+  REC_i( 768, rep_cache_max                           , global    , 0 ),        /* MB, 0 = unlimited */
+  REC_i( 769, movie_prefetch                          , global    , 0 ),        /* states built ahead during playback */
+  REC_i( 770, lod_triangle_budget                     , ostate    , 0 ),        /* triangles per representation, 0 = full quality */
 
 
 #ifdef SETTINGINFO_IMPLEMENTATION
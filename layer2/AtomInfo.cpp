@@ -38,6 +38,7 @@ Z* -------------------------------------------------------------------
 #include"Setting.h"
 #include"Executive.h"
 #include "Lex.h"
+#include "Parallel.h"
 
 #include <map>
 
@@ -1326,6 +1327,8 @@ void AtomInfoBracketResidueFast(PyMOLGlobals * G, const AtomInfoType * ai0, int
 int AtomInfoUpdateAutoColor(PyMOLGlobals * G)
 {
   CAtomInfo *I = G->AtomInfo;
+  if(pymol::is_detached())
+    return I->CColor;           /* caller recolors on registration */
   if(SettingGetGlobal_b(G, cSetting_auto_color))
     I->CColor = ColorGetNext(G);
   else
@@ -1334,6 +1337,13 @@ int AtomInfoUpdateAutoColor(PyMOLGlobals * G)
 }
 
 
+/*========================================================================*/
+int AtomInfoGetCarbonColor(PyMOLGlobals * G)
+{
+  return G->AtomInfo->CColor;
+}
+
+
 /*========================================================================*/
 void AtomInfoPrimeColors(PyMOLGlobals * G)
 {
@@ -446,6 +446,7 @@ void AtomInfoGetPDB3LetHydroName(PyMOLGlobals * G, const char *resn, const char
 void AtomInfoCombine(PyMOLGlobals * G, AtomInfoType * dst, AtomInfoType * src, int mask);
 int AtomInfoNameOrder(PyMOLGlobals * G, const AtomInfoType * at1, const AtomInfoType * at2);
 int AtomInfoUpdateAutoColor(PyMOLGlobals * G);
+int AtomInfoGetCarbonColor(PyMOLGlobals * G);
 
 typedef struct {
   int resv1, resv2;
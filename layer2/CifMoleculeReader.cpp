@@ -33,6 +33,7 @@
 #include "Vector.h"
 #include "Lex.h"
 #include "strcasecmp.h"
+#include "Parallel.h"
 
 // canonical amino acid three letter codes
 const char * aa_three_letter[] = {
@@ -685,6 +686,7 @@ CoordSet ** read_pdbx_struct_assembly(PyMOLGlobals * G,
 
   CoordSet ** csets = NULL;
   int csetbeginidx = 0;
+  int n_thread = SettingGetGlobal_i(G, cSetting_max_threads);
 
   // assembly
   for (int i = 0, nrows = arr_oper_expr->get_nrows(); i < nrows; ++i) {
@@ -735,16 +737,16 @@ CoordSet ** read_pdbx_struct_assembly(PyMOLGlobals * G,
         }
       }
 
-      // transform
-      j = 0;
+      // transform (coordinate sets are independent, so in parallel)
+      std::vector<const float *> matrices;
       for (auto s_it = c_it->begin(); s_it != c_it->end(); ++s_it) {
-        const float * matrix = oper_list[*s_it].data();
+        matrices.push_back(oper_list[*s_it].data());
+      }
 
+      pymol::parallel_for(n_thread, int(c_src_len * c_it->size()), [&](int j) {
         // cartesian product
-        for (int k = 0; k < c_src_len; ++k, ++j) {
-          CoordSetTransform44f(c_csets[j], matrix);
-        }
-      }
+        CoordSetTransform44f(c_csets[j], matrices[j / c_src_len]);
+      });
 
       // cartesian product
       // Note: currently, "1m4x" seems to be the only structure in the PDB
@@ -2244,6 +2246,20 @@ ObjectMolecule *ObjectMoleculeReadCifStr(PyMOLGlobals * G, ObjectMolecule * I,
                                       const char *st, int frame,
                                       int discrete, int quiet, int multiplex,
                                       int zoom)
+{
+  const char * filename = NULL;
+  auto cif = std::make_shared<cif_file>(filename, st);
+  return ObjectMoleculeReadCif(G, I, cif, frame, discrete, quiet, multiplex, zoom);
+}
+
+/*
+ * Like ObjectMoleculeReadCifStr, but for an already tokenized CIF file
+ * (which may have been parsed on a worker thread).
+ */
+ObjectMolecule *ObjectMoleculeReadCif(PyMOLGlobals * G, ObjectMolecule * I,
+                                      std::shared_ptr<cif_file> cif, int frame,
+                                      int discrete, int quiet, int multiplex,
+                                      int zoom)
 {
   if (I) {
     PRINTFB(G, FB_ObjectMolecule, FB_Errors)
@@ -2255,13 +2271,10 @@ ObjectMolecule *ObjectMoleculeReadCifStr(PyMOLGlobals * G, ObjectMolecule * I,
   if (multiplex > 0) {
     PRINTFB(G, FB_ObjectMolecule, FB_Errors)
       " Error: loading mmCIF with multiplex=1 not supported, please use 'split_states'.\n"
-      "        after loading the object." ENDFB(G);
+      "        after loading the object.\n" ENDFB(G);
     return NULL;
   }
 
-  const char * filename = NULL;
-  auto cif = std::make_shared<cif_file>(filename, st);
-
   for (auto it = cif->datablocks.begin(); it != cif->datablocks.end(); ++it) {
     ObjectMolecule * obj = ObjectMoleculeReadCifData(G, it->second, discrete, quiet);
 
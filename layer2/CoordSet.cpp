@@ -47,6 +47,7 @@ Z* -------------------------------------------------------------------
 #include"RepNonbonded.h"
 #include"RepNonbondedSphere.h"
 #include"RepEllipsoid.h"
+#include"RepCache.h"
 
 #include"PyMOLGlobals.h"
 #include"PyMOLObject.h"
@@ -71,6 +72,15 @@ int CoordSet::atmToIdx(int atm) const {
   return AtmToIdx[atm];
 }
 
+/*
+ * Account coordinates and index arrays to cMemoryCoords
+ */
+void CoordSet::tagMemory() {
+  VLASetTag(Coord, cMemoryCoords);
+  VLASetTag(IdxToAtm, cMemoryCoords);
+  VLASetTag(AtmToIdx, cMemoryCoords);
+}
+
 /*========================================================================*/
 static char sATOM[] = "ATOM  ";
 static char sHETATM[] = "HETATM";
@@ -391,6 +401,7 @@ int CoordSetMerge(ObjectMolecule *OM, CoordSet * I, CoordSet * cs)
   int nIndex;
   int a, i0;
   int ok = true;
+  RepCacheJoinCoordSet(I->State.G, I);
   /* calculate new size and make room for new data */
   nIndex = I->NIndex + cs->NIndex;
   VLASize(I->IdxToAtm, int, nIndex);
@@ -464,6 +475,8 @@ void CoordSetPurge(CoordSet * I)
   PRINTFD(I->State.G, FB_CoordSet)
     " CoordSetPurge-Debug: entering..." ENDFD;
 
+  RepCacheJoinCoordSet(I->State.G, I);
+
   c0 = c1 = I->Coord;
   r0 = r1 = I->RefPos;
   l0 = l1 = I->LabPos;
@@ -1102,6 +1115,7 @@ void CoordSet::invalidateRep(int type, int level)
 {
   CoordSet * I = this;
   int a;
+  RepCacheJoinCoordSet(I->State.G, I);
   if(level >= cRepInvVisib) {
     if (I->Obj)
       I->Obj->RepVisCacheValid = false;
@@ -1255,6 +1269,82 @@ void CoordSet::update(int state)
 }
 
 
+/*========================================================================*/
+/* representation constructors, in update() order (labels excluded) */
+static const struct {
+  int rep;
+  Rep *(*fn) (CoordSet *, int);
+} CoordSetRepNew[] = {
+  {cRepLine, RepWireBondNew},
+  {cRepCyl, RepCylBondNew},
+  {cRepDot, RepDotNew},
+  {cRepMesh, RepMeshNew},
+  {cRepSphere, RepSphereNew},
+  {cRepRibbon, RepRibbonNew},
+  {cRepCartoon, RepCartoonNew},
+  {cRepSurface, RepSurfaceNew},
+  {cRepNonbonded, RepNonbondedNew},
+  {cRepNonbondedSphere, RepNonbondedSphereNew},
+  {cRepEllipsoid, RepEllipsoidNew},
+};
+
+/*
+ * Representations which prefetch() can build off the main thread. Surfaces
+ * and meshes which need selections or the Python-side surface cache are
+ * excluded. Labels are never prefetched (text layout state).
+ */
+static bool CoordSetRepPrefetchable(const CoordSet * I, int rep)
+{
+  PyMOLGlobals *G = I->State.G;
+  const CSetting *set1 = I->Setting, *set2 = I->Obj->Obj.Setting;
+  switch (rep) {
+  case cRepSurface:
+    return !SettingGet_i(G, set1, set2, cSetting_cache_mode) &&
+      !SettingGet_s(G, set1, set2, cSetting_surface_carve_selection)[0] &&
+      !SettingGet_s(G, set1, set2, cSetting_surface_clear_selection)[0];
+  case cRepMesh:
+    return !SettingGet_s(G, set1, set2, cSetting_mesh_carve_selection)[0] &&
+      !SettingGet_s(G, set1, set2, cSetting_mesh_clear_selection)[0];
+  }
+  return true;
+}
+
+/*
+ * Bitmask of the missing representations which prefetch() can build.
+ * Evaluated on the main thread, since settings may change meanwhile.
+ */
+int CoordSet::prefetchMask() const
+{
+  int mask = 0;
+  for(auto& item : CoordSetRepNew) {
+    int a = item.rep;
+    if(Active[a] && !Rep[a] && CoordSetRepPrefetchable(this, a))
+      mask |= (1 << a);
+  }
+  return mask;
+}
+
+/*
+ * Builds the missing representations in `mask` like update() does, but
+ * without notifying the scene, so that it can run on a worker thread
+ * (inside a pymol::DetachedScope) while another state is displayed. The
+ * caller must make sure that nothing else accesses this coordinate set
+ * and that the object's neighbor table is up to date.
+ */
+void CoordSet::prefetch(int state, int mask)
+{
+  for(auto& item : CoordSetRepNew) {
+    int a = item.rep;
+    if(!(mask & (1 << a)) || !Active[a] || Rep[a])
+      continue;
+    Rep[a] = item.fn(this, state);
+    if(Rep[a])
+      Rep[a]->fNew = item.fn;
+    else
+      Active[a] = false;
+  }
+}
+
 /*========================================================================*/
 void CoordSetUpdateCoord2IdxMap(CoordSet * I, float cutoff)
 {
@@ -1547,6 +1637,9 @@ CoordSet *CoordSetCopy(const CoordSet * cs)
   I->AtmToIdx   = VLACopy2(cs->AtmToIdx);
   I->IdxToAtm   = VLACopy2(cs->IdxToAtm);
 
+  // copies keep the tag, but templates (CSTmpl) may not be tagged yet
+  I->tagMemory();
+
   UtilZeroMem(I->Rep, sizeof(::Rep *) * cRepCnt);
 
 #ifdef _PYMOL_IP_PROPERTIES
@@ -1573,6 +1666,8 @@ int CoordSet::extendIndices(int nAtom)
   int a, b;
   ObjectMolecule *obj = I->Obj;
   int ok = true;
+  RepCacheJoinCoordSet(I->State.G, I);
+  obj->SeleGeneration++;
   if(obj->DiscreteFlag) {
     ok = obj->setNDiscrete(nAtom);
 
@@ -1600,6 +1695,7 @@ int CoordSet::extendIndices(int nAtom)
     } else if(!obj->DiscreteFlag) {
       I->AtmToIdx = VLACalloc(int, nAtom);
       CHECKOK(ok, I->AtmToIdx);
+      VLASetTag(I->AtmToIdx, cMemoryCoords);
       if (ok){
 	for(a = 0; a < nAtom; a++)
 	  I->AtmToIdx[a] = -1;
@@ -1618,7 +1714,9 @@ void CoordSet::appendIndices(int offset)
   int a, b;
   ObjectMolecule *obj = I->Obj;
 
+  obj->SeleGeneration++;
   I->IdxToAtm = VLACalloc(int, I->NIndex);
+  VLASetTag(I->IdxToAtm, cMemoryCoords);
   if(I->NIndex) {
     ErrChkPtr(I->State.G, I->IdxToAtm);
     for(a = 0; a < I->NIndex; a++)
@@ -1634,6 +1732,7 @@ void CoordSet::appendIndices(int offset)
     }
   } else {
     I->AtmToIdx = VLACalloc(int, I->NIndex + offset);
+    VLASetTag(I->AtmToIdx, cMemoryCoords);
     if(I->NIndex + offset) {
       ErrChkPtr(I->State.G, I->AtmToIdx);
       for(a = 0; a < offset; a++)
@@ -1654,6 +1753,8 @@ void CoordSet::enumIndices()
   int a;
   I->AtmToIdx = VLACalloc(int, I->NIndex);
   I->IdxToAtm = VLACalloc(int, I->NIndex);
+  VLASetTag(I->AtmToIdx, cMemoryCoords);
+  VLASetTag(I->IdxToAtm, cMemoryCoords);
   if(I->NIndex) {
     ErrChkPtr(I->State.G, I->AtmToIdx);
     ErrChkPtr(I->State.G, I->IdxToAtm);
@@ -1685,16 +1786,19 @@ void CoordSet::fFree()
       VLAFreeP(I->has_atom_state_settings);
       VLAFreeP(I->atom_state_setting_id);
     }
+    RepCacheForget(I->State.G, I);
     for(a = 0; a < cRepCnt; a++)
       if(I->Rep[a])
         I->Rep[a]->fFree(I->Rep[a]);
     obj = I->Obj;
-    if(obj)
+    if(obj) {
+      obj->SeleGeneration++;
       if(obj->DiscreteFlag)     /* remove references to the atoms in discrete objects */
         for(a = 0; a < I->NIndex; a++) {
           obj->DiscreteAtmToIdx[I->IdxToAtm[a]] = -1;
           obj->DiscreteCSet[I->IdxToAtm[a]] = NULL;
         }
+    }
     VLAFreeP(I->AtmToIdx);
     VLAFreeP(I->IdxToAtm);
     MapFree(I->Coord2Idx);
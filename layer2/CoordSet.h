@@ -38,12 +38,15 @@ typedef struct CoordSet {
 
   // methods
   void update(int state);
+  int prefetchMask() const;
+  void prefetch(int state, int mask);
   void render(RenderInfo * info);
   void enumIndices();
   void appendIndices(int offset);
   int extendIndices(int nAtom);
   void invalidateRep(int type, int level);
   int atmToIdx(int atm) const;
+  void tagMemory();
 
   // read/write pointer to coordinate
   float * coordPtr(int idx) {
@@ -114,6 +117,7 @@ typedef struct CoordSet {
   /* temporary / optimization */
 
   int objMolOpInvalidated;
+  RepSizeHint SizeHint[cRepCnt];        /* CGO sizes of the last rep builds */
 #ifdef _PYMOL_IP_EXTRAS
   mmpymolx_prop_state_t validMMStereo;
   mmpymolx_prop_state_t validTextType;
@@ -9,6 +9,7 @@
 #include "Selector.h"
 #include "HydrogenAdder.h"
 #include "Err.h"
+#include "RepCache.h"
 
 /*
  * Add coordinates for atom `atm`.
@@ -281,6 +282,8 @@ int ObjectMoleculeAddSeleHydrogensRefactored(ObjectMolecule* I, int sele, int st
     return true;
   }
 
+  RepCacheJoinObject(G, I);
+
   if (!ObjectMoleculeVerifyChemistry(I, state)) {
     ErrMessage(G, " AddHydrogens", "missing chemical geometry information.");
     return false;
@@ -53,6 +53,8 @@ Z* -------------------------------------------------------------------
 #include "Lex.h"
 #include "MolV3000.h"
 #include "HydrogenAdder.h"
+#include "Parallel.h"
+#include "RepCache.h"
 
 #ifdef _WEBGL
 #endif
@@ -104,6 +106,8 @@ int BondTypeInOrder(PyMOLGlobals * G, const BondType * bonds, int i1, int i2) {
  */
 static
 void ObjectMoleculeRemoveDuplicateBonds(PyMOLGlobals * G, ObjectMolecule * I) {
+  RepCacheJoinObject(G, I);
+
   // make sure index pairs are in order
   for (int i = 0; i < I->NBond; ++i) {
     auto& bond = I->Bond[i];
@@ -165,6 +169,8 @@ bool ObjectMoleculeSetNotDiscrete(PyMOLGlobals * G, ObjectMolecule * I) {
   if (!I->DiscreteFlag)
     return true;
 
+  RepCacheJoinObject(G, I);
+
   VLAFreeP(I->DiscreteAtmToIdx);
   VLAFreeP(I->DiscreteCSet);
   I->DiscreteFlag = false;
@@ -232,6 +238,8 @@ int ObjectMoleculeSetDiscrete(PyMOLGlobals * G, ObjectMolecule * I, int discrete
   BondType *bond;
   CoordSet *cs;
 
+  RepCacheJoinObject(G, I);
+
   if (!discrete) {
     if (!I->DiscreteFlag)
       return true;
@@ -1301,6 +1309,7 @@ ObjectMolecule *ObjectMoleculeLoadTRJFile(PyMOLGlobals * G, ObjectMolecule * I,
                     zoom_flag = true;
                   }
 
+                  RepCacheJoinObject(G, I);
                   VLACheck(I->CSet, CoordSet *, frame);
                   if(I->NCSet <= frame)
                     I->NCSet = frame + 1;
@@ -1443,6 +1452,7 @@ ObjectMolecule *ObjectMoleculeLoadRSTFile(PyMOLGlobals * G, ObjectMolecule * I,
               zoom_flag = true;
             }
 
+            RepCacheJoinObject(G, I);
             VLACheck(I->CSet, CoordSet *, frame);
 	    CHECKOK(ok, I->CSet);
 	    if (ok){
@@ -4498,6 +4508,8 @@ int ObjectMoleculeAddBond(ObjectMolecule * I, int sele0, int sele1, int order)
   int c = 0;
   BondType *bnd;
 
+  RepCacheJoinObject(I->Obj.G, I);
+
   /* TO DO: optimize for performance -- we shouldn't be doing full
      table scans */
 
@@ -4648,6 +4660,8 @@ int ObjectMoleculeRemoveBonds(ObjectMolecule * I, int sele0, int sele1)
   int s;
   int a;
 
+  RepCacheJoinObject(I->Obj.G, I);
+
   if(I->Bond) {
     offset = 0;
     b0 = I->Bond;
@@ -4711,6 +4725,8 @@ void ObjectMoleculePurge(ObjectMolecule * I)
   BondType *b0, *b1;
   AtomInfoType *ai0, *ai1;
 
+  RepCacheJoinObject(G, I);
+
   PRINTFD(I->Obj.G, FB_ObjectMolecule)
     " ObjMolPurge-Debug: step 1, delete object selection\n" ENDFD;
 
@@ -7610,6 +7626,7 @@ ObjectMolecule *ObjectMoleculeLoadChemPyModel(PyMOLGlobals * G,
     }
     if(isNew)
       I->NAtom = nAtom;
+    RepCacheJoinObject(G, I);
     VLACheck(I->CSet, CoordSet *, frame);
     if(I->NCSet <= frame)
       I->NCSet = frame + 1;
@@ -7687,6 +7704,7 @@ ObjectMolecule *ObjectMoleculeLoadCoords(PyMOLGlobals * G, ObjectMolecule * I,
 
   // include coordinate set
   if (is_new) {
+    RepCacheJoinObject(G, I);
     VLACheck(I->CSet, CoordSet *, frame);
     if(I->NCSet <= frame)
       I->NCSet = frame + 1;
@@ -7788,6 +7806,7 @@ ObjectMolecule *ObjectMoleculeLoadCoords(PyMOLGlobals * G, ObjectMolecule * I,
 
   // include coordinate set
   if (is_new) {
+    RepCacheJoinObject(G, I);
     VLACheck(I->CSet, CoordSet *, frame);
     if(I->NCSet <= frame)
       I->NCSet = frame + 1;
@@ -8899,6 +8918,7 @@ ObjectMolecule *ObjectMoleculeReadStr(PyMOLGlobals * G, ObjectMolecule * I,
         frame = I->NCSet;
       if(I->NCSet <= frame)
         I->NCSet = frame + 1;
+      RepCacheJoinObject(G, I);
       VLACheck(I->CSet, CoordSet *, frame);
 
       nAtom = cset->NIndex;
@@ -8929,6 +8949,7 @@ ObjectMolecule *ObjectMoleculeReadStr(PyMOLGlobals * G, ObjectMolecule * I,
         I->NAtom = nAtom;
       if(frame < 0)
         frame = I->NCSet;
+      RepCacheJoinObject(G, I);
       VLACheck(I->CSet, CoordSet *, frame);
       if(I->NCSet <= frame)
         I->NCSet = frame + 1;
@@ -9000,6 +9021,8 @@ int ObjectMoleculeMerge(ObjectMolecule * I, AtomInfoType *&& ai,
   int oldNAtom, oldNBond;
   int ok = true;
 
+  RepCacheJoinObject(G, I);
+
   oldNAtom = I->NAtom;
   oldNBond = I->NBond;
 
@@ -9296,19 +9319,236 @@ void ObjectMoleculeTransformTTTf(ObjectMolecule * I, float *ttt, int frame)
 
 
 /*========================================================================*/
+/*
+ * OMOP_SFIT: fits (op->i1 != 0) or measures the rms of every state of
+ * this object against the target vertices op->vv2 (atom indices in
+ * op->i1VLA, sorted), and writes per-state rms values to op->f1VLA.
+ *
+ * The selected atoms which have a target vertex are looked up once.
+ * States are then processed in parallel, unless the target is updated
+ * after every state (mix with op->i1 == 2).
+ */
+static void ObjectMoleculeFitStates(ObjectMolecule * I, int sele,
+                                    ObjectMoleculeOpRec * op)
+{
+  PyMOLGlobals *G = I->Obj.G;
+  const int mode = op->i1;
+  const int target = op->i2;
+  const int mix = (mode == 2) ? op->i3 : 0;
+  std::vector<int> atm, tgt;    /* matching atom and target vertex indices */
+
+  for(int a = 0, t_i = 0; a < I->NAtom; a++) {
+    if(!SelectorIsMember(G, I->AtomInfo[a].selEntry, sele))
+      continue;
+    atm.push_back(a);
+    while(t_i < op->nvv2 && op->i1VLA[t_i] < a)
+      t_i++;
+    tgt.push_back((t_i < op->nvv2 && op->i1VLA[t_i] == a) ? t_i : -1);
+  }
+
+  if(atm.empty())               /* only perform action for selected object */
+    return;
+
+  /* atom index in state b, or -1 */
+  auto atm_to_idx = [I](int b, int a) {
+    if(I->DiscreteFlag)
+      return (I->CSet[b] == I->DiscreteCSet[a]) ? I->DiscreteAtmToIdx[a] : -1;
+    return I->CSet[b]->AtmToIdx[a];
+  };
+
+  std::vector<float> rms(I->NCSet, -1.0F);
+  std::vector<int> n_match(I->NCSet, 0);
+  std::vector<std::string> output(I->NCSet);    /* matrix feedback */
+  int n_thread = mix ? 1 : SettingGetGlobal_i(G, cSetting_max_threads);
+
+  pymol::parallel_for(n_thread, I->NCSet, [&](int b) {
+    CoordSet *cs = I->CSet[b];
+    if(!cs || b == target)
+      return;
+
+    /* workers must not print, replayed in state order below */
+    pymol::DetachedScope scope;
+
+    std::vector<float> v1, vt;
+    v1.reserve(3 * atm.size());
+    vt.reserve(3 * atm.size());
+
+    for(size_t i = 0; i < atm.size(); i++) {
+      int a1 = atm_to_idx(b, atm[i]);
+      if(a1 >= 0 && tgt[i] >= 0) {
+        const float *v = cs->Coord + 3 * a1;
+        const float *t = op->vv2 + 3 * tgt[i];
+        v1.insert(v1.end(), v, v + 3);
+        vt.insert(vt.end(), t, t + 3);
+      }
+    }
+
+    int n = n_match[b] = v1.size() / 3;
+    if(!n)
+      return;
+
+    float ttt[16];
+    if(mode != 0)               /* fitting flag */
+      rms[b] = MatrixFitRMSTTTf(G, n, v1.data(), vt.data(), NULL, ttt);
+    else
+      rms[b] = MatrixGetRMS(G, n, v1.data(), vt.data(), NULL);
+
+    if(mode == 2) {
+      MatrixTransformTTTfN3f(cs->NIndex, cs->Coord, ttt, cs->Coord);
+      CoordSetRecordTxfApplied(cs, ttt, false);
+
+      if(mix) {
+        const float divisor = (float) mix;
+        const float premult = (float) mix - 1.0F;
+
+        /* mix flag is set, so average the prior target
+           coordinates with these coordinates */
+
+        for(size_t i = 0; i < atm.size(); i++) {
+          int a1 = atm_to_idx(b, atm[i]);
+          if(a1 >= 0 && tgt[i] >= 0) {
+            const float *v = cs->Coord + 3 * a1;
+            float *t = op->vv2 + 3 * tgt[i];
+            t[0] = ((premult * t[0]) + v[0]) / divisor;
+            t[1] = ((premult * t[1]) + v[1]) / divisor;
+            t[2] = ((premult * t[2]) + v[2]) / divisor;
+          }
+        }
+      }
+    }
+
+    output[b] = std::move(scope.output);
+  });
+
+  for(int b = 0; b < I->NCSet; b++) {
+    if(!I->CSet[b] || b == target)
+      continue;
+    if(n_match[b] != op->nvv2) {
+      PRINTFB(G, FB_Executive, FB_Warnings)
+        "Executive-Warning: Missing atoms in state %d (%d instead of %d).\n",
+        b + 1, n_match[b], op->nvv2 ENDFB(G);
+    }
+    if(!n_match[b]) {
+      PRINTFB(G, FB_Executive, FB_Warnings)
+        "Executive-Warning: No matches found for state %d.\n", b + 1 ENDFB(G);
+      continue;
+    }
+    if(!output[b].empty())
+      FeedbackAdd(G, output[b].c_str());
+    if(mode == 2)
+      I->CSet[b]->invalidateRep(cRepAll, cRepInvCoord);
+  }
+
+  VLACheck(op->f1VLA, float, I->NCSet);
+  for(int b = 0; b < I->NCSet; b++)
+    op->f1VLA[b] = rms[b];
+  VLASize(op->f1VLA, float, I->NCSet);  /* NOTE this action is object-specific! */
+}
+
+
+/*========================================================================*/
+/*
+ * False for operations which only query atoms or coordinates
+ */
+static bool ObjectMoleculeSeleOpModifiesAtoms(const ObjectMoleculeOpRec * op)
+{
+  switch (op->code) {
+  case OMOP_ALTR:
+    return !op->i2;             /* read_only */
+  case OMOP_AlterState:
+    return !op->i3;             /* read_only */
+  case OMOP_PDB1:
+  case OMOP_AVRT:
+  case OMOP_SUMC:
+  case OMOP_VERT:
+  case OMOP_SVRT:
+  case OMOP_MOME:
+  case OMOP_MDST:
+  case OMOP_MNMX:
+  case OMOP_Identify:
+  case OMOP_CountAtoms:
+  case OMOP_Index:
+  case OMOP_PhiPsi:
+  case OMOP_SingleStateVertices:
+  case OMOP_IdentifyObjects:
+  case OMOP_CSetSumVertices:
+  case OMOP_CSetMoment:
+  case OMOP_CSetMinMax:
+  case OMOP_GetObjects:
+  case OMOP_CSetMaxDistToPt:
+  case OMOP_MaxDistToPt:
+  case OMOP_CameraMinMax:
+  case OMOP_CSetCameraMinMax:
+  case OMOP_GetChains:
+  case OMOP_StateVRT:
+  case OMOP_CheckVis:
+  case OMOP_CSetSumSqDistToPt:
+    return false;
+  }
+  return true;
+}
+
+/*
+ * True for operations which may change atom properties used by memoized
+ * selection keywords (see SelectorEvalCacheable), as opposed to
+ * coordinates, colors or representations
+ */
+static bool ObjectMoleculeSeleOpModifiesProperties(const ObjectMoleculeOpRec * op)
+{
+  switch (op->code) {
+  case OMOP_ALTR:
+  case OMOP_AlterState:
+    return ObjectMoleculeSeleOpModifiesAtoms(op);
+  case OMOP_Flag:
+  case OMOP_FlagSet:
+  case OMOP_FlagClear:
+  case OMOP_LABL:
+  case OMOP_SetB:
+  case OMOP_Remove:
+  case OMOP_AddHydrogens:
+  case OMOP_PrepareFromTemplate:
+  case OMOP_Sort:
+  case OMOP_RevalenceFromSource:
+  case OMOP_RevalenceByGuessing:
+  case OMOP_RenameAtoms:
+    return true;
+  }
+  return false;
+}
+
+/*
+ * True for operations which only visit atoms in the selection, so that
+ * objects without selected atoms can be skipped (OMOP_Flag, for example,
+ * also resets the flag on all other atoms)
+ */
+bool ObjectMoleculeSeleOpMembersOnly(const ObjectMoleculeOpRec * op)
+{
+  switch (op->code) {
+  case OMOP_FlagSet:
+  case OMOP_FlagClear:
+  case OMOP_COLR:
+  case OMOP_VISI:
+  case OMOP_TTTF:
+  case OMOP_ALTR:
+  case OMOP_LABL:
+  case OMOP_AlterState:
+    return true;
+  }
+  return !ObjectMoleculeSeleOpModifiesAtoms(op);
+}
+
 void ObjectMoleculeSeleOp(ObjectMolecule * I, int sele, ObjectMoleculeOpRec * op)
 {
   float *coord;
   int a, b, s;
-  int c, d, t_i;
+  int c, d;
   int a1 = 0, ind;
-  float r, rms;
-  float v1[3], v2, *vv1, *vv2, *vt, *vt1, *vt2;
+  float r;
+  float v1[3], v2, *vv1, *vv2;
   int hit_flag = false;
   int ok = true;
   int cnt;
   int skip_flag;
-  int match_flag = false;
   int offset;
   int priority;
   int use_matrices = false;
@@ -9323,6 +9563,11 @@ void ObjectMoleculeSeleOp(ObjectMolecule * I, int sele, ObjectMoleculeOpRec * op
 #endif
   PRINTFD(G, FB_ObjectMolecule)
     " ObjectMoleculeSeleOp-DEBUG: sele %d op->code %d\n", sele, op->code ENDFD;
+  if(sele >= 0 && ObjectMoleculeSeleOpModifiesAtoms(op)) {
+    RepCacheJoinObject(G, I);
+    if(ObjectMoleculeSeleOpModifiesProperties(op))
+      SelectorInvalidateEvalCache(G);
+  }
   if(sele >= 0) {
     const char *errstr = "Alter";
     /* always run on entry */
@@ -9584,131 +9829,7 @@ void ObjectMoleculeSeleOp(ObjectMolecule * I, int sele, ObjectMoleculeOpRec * op
       }
       break;
     case OMOP_SFIT:            /* state fitting within a single object */
-      vt = Alloc(float, 3 * op->nvv2);  /* temporary (matching) target vertex pointers */
-      cnt = 0;
-      for(a = 0; a < I->NAtom; a++) {
-        s = I->AtomInfo[a].selEntry;
-        if(SelectorIsMember(G, s, sele)) {
-          cnt++;
-          break;
-        }
-      }
-      if(cnt) {                 /* only perform action for selected object */
-
-        for(b = 0; b < I->NCSet; b++) {
-          rms = -1.0;
-          vt1 = vt;             /* reset target vertex pointers */
-          vt2 = op->vv2;
-          t_i = 0;              /* original target vertex index */
-          if(I->CSet[b] && (b != op->i2)) {
-            op->nvv1 = 0;
-            for(a = 0; a < I->NAtom; a++) {
-              s = I->AtomInfo[a].selEntry;
-              if(SelectorIsMember(G, s, sele)) {
-                if(I->DiscreteFlag) {
-                  if(I->CSet[b] == I->DiscreteCSet[a])
-                    a1 = I->DiscreteAtmToIdx[a];
-                  else
-                    a1 = -1;
-                } else
-                  a1 = I->CSet[b]->AtmToIdx[a];
-                if(a1 >= 0) {
-
-                  match_flag = false;
-                  while(t_i < op->nvv2) {
-                    if(op->i1VLA[t_i] == a) {   /* same atom? */
-                      match_flag = true;
-                      break;
-                    }
-                    if(op->i1VLA[t_i] < a) {    /* catch up? */
-                      t_i++;
-                      vt2 += 3;
-                    } else
-                      break;
-                  }
-                  if(match_flag) {
-                    VLACheck(op->vv1, float, (op->nvv1 * 3) + 2);
-                    vv2 = I->CSet[b]->Coord + (3 * a1);
-                    vv1 = op->vv1 + (op->nvv1 * 3);
-                    *(vv1++) = *(vv2++);
-                    *(vv1++) = *(vv2++);
-                    *(vv1++) = *(vv2++);
-                    *(vt1++) = *(vt2);
-                    *(vt1++) = *(vt2 + 1);
-                    *(vt1++) = *(vt2 + 2);
-                    op->nvv1++;
-                  }
-                }
-              }
-            }
-            if(op->nvv1 != op->nvv2) {
-              PRINTFB(G, FB_Executive, FB_Warnings)
-                "Executive-Warning: Missing atoms in state %d (%d instead of %d).\n",
-                b + 1, op->nvv1, op->nvv2 ENDFB(G);
-            }
-            if(op->nvv1) {
-              if(op->i1 != 0)   /* fitting flag */
-                rms = MatrixFitRMSTTTf(G, op->nvv1, op->vv1, vt, NULL, op->ttt);
-              else
-                rms = MatrixGetRMS(G, op->nvv1, op->vv1, vt, NULL);
-              if(op->i1 == 2) {
-                ObjectMoleculeTransformTTTf(I, op->ttt, b);
-
-                if(op->i3) {
-                  const float divisor = (float) op->i3;
-                  const float premult = (float) op->i3 - 1.0F;
-
-                  /* mix flag is set, so average the prior target
-                     coordinates with these coordinates */
-
-                  vt2 = op->vv2;
-                  t_i = 0;      /* original target vertex index */
-                  for(a = 0; a < I->NAtom; a++) {
-                    s = I->AtomInfo[a].selEntry;
-                    if(SelectorIsMember(G, s, sele)) {
-                      if(I->DiscreteFlag) {
-                        if(I->CSet[b] == I->DiscreteCSet[a])
-                          a1 = I->DiscreteAtmToIdx[a];
-                        else
-                          a1 = -1;
-                      } else
-                        a1 = I->CSet[b]->AtmToIdx[a];
-                      if(a1 >= 0) {
-
-                        match_flag = false;
-                        while(t_i < op->nvv2) {
-                          if(op->i1VLA[t_i] == a) {     /* same atom? */
-                            match_flag = true;
-                            break;
-                          }
-                          if(op->i1VLA[t_i] < a) {      /* catch up? */
-                            t_i++;
-                            vt2 += 3;
-                          } else
-                            break;
-                        }
-                        if(match_flag) {
-                          vv2 = I->CSet[b]->Coord + (3 * a1);
-                          *(vt2) = ((premult * (*vt2)) + *(vv2++)) / divisor;
-                          *(vt2 + 1) = ((premult * (*(vt2 + 1))) + *(vv2++)) / divisor;
-                          *(vt2 + 2) = ((premult * (*(vt2 + 2))) + *(vv2++)) / divisor;
-                        }
-                      }
-                    }
-                  }
-                }
-              }
-            } else {
-              PRINTFB(G, FB_Executive, FB_Warnings)
-                "Executive-Warning: No matches found for state %d.\n", b + 1 ENDFB(G);
-            }
-          }
-          VLACheck(op->f1VLA, float, b);
-          op->f1VLA[b] = rms;
-        }
-        VLASize(op->f1VLA, float, I->NCSet);    /* NOTE this action is object-specific! */
-      }
-      FreeP(vt);
+      ObjectMoleculeFitStates(I, sele, op);
       break;
     case OMOP_SetGeometry:
       for(a = 0; a < I->NAtom; a++) {
@@ -11046,6 +11167,12 @@ static void ObjectMoleculeUpdate(ObjectMolecule * I)
     if(stop > I->NCSet)
       stop = I->NCSet;
 
+    /* states which are built in the background (movie_prefetch) */
+    for(a = start; a < stop; a++) {
+      if(I->CSet[a])
+        RepCacheJoinCoordSet(G, I->CSet[a]);
+    }
+
     /* single and multithreaded coord set updates */
     {
 #ifndef _PYMOL_NOPY
@@ -11094,6 +11221,11 @@ static void ObjectMoleculeUpdate(ObjectMolecule * I)
         }
       }
     }
+    /* mark these states as in use for the rep_cache_max budget */
+    for(a = start; a < stop; a++) {
+      if((a<I->NCSet) && I->CSet[a])
+        RepCacheTouch(G, I->CSet[a]);
+    }
     /* if the unit cell is shown, redraw it */
     if((I->Obj.visRep & cRepCellBit)) {
       if(I->Symmetry) {
@@ -11120,7 +11252,14 @@ void ObjectMoleculeInvalidate(ObjectMolecule * I, int rep, int level, int state)
     I->RepVisCacheValid = false;
   }
 
+  /* labels, atom properties or the atom table, but not coordinates,
+   * representations or bonds (see SelectorEvalCacheable) */
+  if(level == cRepInvText || level == cRepInvProp || level >= cRepInvAtoms) {
+    SelectorInvalidateEvalCache(I->Obj.G);
+  }
+
   if(level >= cRepInvBonds) {
+    RepCacheJoinObject(I->Obj.G, I);
     VLAFreeP(I->Neighbor);      /* set I->Neighbor to NULL */
     if(I->Sculpt) {
       SculptFree(I->Sculpt);
@@ -11128,6 +11267,7 @@ void ObjectMoleculeInvalidate(ObjectMolecule * I, int rep, int level, int state)
     }
     ObjectMoleculeUpdateNonbonded(I);
     if(level >= cRepInvAtoms) {
+      I->SeleGeneration++;
       SelectorUpdateObjectSele(I->Obj.G, I);
     }
   }
@@ -11548,6 +11688,7 @@ static void ObjectMoleculeRender(ObjectMolecule * I, RenderInfo * info)
   for(StateIterator iter(G, I->Obj.Setting, state, I->NCSet); iter.next();) {
     cs = I->CSet[iter.state];
     if(cs) {
+      RepCacheJoinCoordSet(G, cs);
       if(use_matrices)
         pop_matrix = ObjectStatePushAndApplyMatrix(&cs->State, info);
       cs->render(info);
@@ -11714,6 +11855,7 @@ ObjectMolecule *ObjectMoleculeNew(PyMOLGlobals * G, int discreteFlag)
     ObjectMoleculeFree(I);
     return NULL;
   }
+  VLASetTag(I->AtomInfo, cMemoryAtoms);
   for(a = 0; a <= cUndoMask; a++) {
     I->UndoCoord[a] = NULL;
     I->UndoState[a] = -1;
@@ -11785,6 +11927,8 @@ int ObjectMoleculeSetStateOrder(ObjectMolecule * I, int * order, int len) {
   int a;
   CoordSet ** csets = VLAlloc(CoordSet *, I->NCSet);
 
+  RepCacheJoinObject(I->Obj.G, I);
+
   ok_assert(1, len == I->NCSet);
 
   // invalidate
@@ -11811,7 +11955,12 @@ ok_except1:
 void ObjectMoleculeFree(ObjectMolecule * I)
 {
   int a;
+
+  RepCacheJoinObject(I->Obj.G, I);
+
   SelectorPurgeObjectMembers(I->Obj.G, I);
+  SelectorInvalidateEvalCache(I->Obj.G);
+  SelectorInvalidateTable(I->Obj.G);
   for(a = 0; a < I->NCSet; a++){
     if(I->CSet[a]) {
       I->CSet[a]->fFree();
@@ -11954,6 +12103,7 @@ ObjectMolecule *ObjectMoleculeReadPDBStr(PyMOLGlobals * G, ObjectMolecule * I,
         if(SettingGetGlobal_b(G, cSetting_pdb_honor_model_number))
           state = *model_number - 1;
       }
+      RepCacheJoinObject(G, I);
       VLACheck(I->CSet, CoordSet *, state);
       CHECKOK(ok, I->CSet);
       if(ok){
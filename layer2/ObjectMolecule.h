@@ -73,6 +73,7 @@ typedef struct ObjectMolecule {
      int *UniformAtmToIdx, *UniformIdxToAtm;  */
   int CurCSet;                  /* Current state number */
   int SeleBase;                 /* for internal usage by  selector & only valid during selection process */
+  int SeleGeneration;           /* for internal usage by selector: changes whenever atoms or coordinate sets change */
   CSymmetry *Symmetry;
   int *Neighbor;
   float *UndoCoord[cUndoMask + 1];
@@ -385,6 +386,7 @@ void ObjectMoleculeInvalidateAtomType(ObjectMolecule *I, int state);
 void ObjectMoleculeRenderSele(ObjectMolecule * I, int curState, int sele, int vis_only SELINDICATORARG);
 
 void ObjectMoleculeSeleOp(ObjectMolecule * I, int sele, ObjectMoleculeOpRec * op);
+bool ObjectMoleculeSeleOpMembersOnly(const ObjectMoleculeOpRec * op);
 
 struct CoordSet *ObjectMoleculeGetCoordSet(ObjectMolecule * I, int setIndex);
 void ObjectMoleculeBlindSymMovie(ObjectMolecule * I);
@@ -528,6 +530,8 @@ ObjectMolecule *ObjectMoleculeReadMmtfStr(PyMOLGlobals * G, ObjectMolecule * I,
     const char *st, int st_len, int frame, int discrete, int quiet, int multiplex, int zoom);
 ObjectMolecule *ObjectMoleculeReadCifStr(PyMOLGlobals * G, ObjectMolecule * I,
     const char *st, int frame, int discrete, int quiet, int multiplex, int zoom);
+ObjectMolecule *ObjectMoleculeReadCif(PyMOLGlobals * G, ObjectMolecule * I,
+    std::shared_ptr<cif_file> cif, int frame, int discrete, int quiet, int multiplex, int zoom);
 
 // object and object-state level setting
 template <typename V> void SettingSet(int index, V value, ObjectMolecule * I, int state=-1) {
@@ -41,6 +41,8 @@
 #include"ObjectCGO.h"
 #include"Scene.h"
 #include "Lex.h"
+#include "Parallel.h"
+#include "RepCache.h"
 
 #include"AtomInfoHistory.h"
 #include"BondTypeHistory.h"
@@ -83,9 +85,9 @@ static void AddOrthoOutputIfMatchesTags(PyMOLGlobals * G, int n_tags,
     for(; tc < n_tags; tc++) {
       if(!strstartswithword(p, tag_start[tc]))
 	continue;
-      ParseNTrimRight(cc, p, MAXLINELEN - 1);
-      OrthoAddOutput(G, cc);
-      OrthoNewLine(G, NULL, true);
+      ParseNTrimRight(cc, p, MAXLINELEN - 2);
+      strcat(cc, "\n");
+      FeedbackAdd(G, cc);
       break;
     }
   }
@@ -380,6 +382,7 @@ int ObjectMoleculeAddPseudoatom(ObjectMolecule * I, int sele_index, const char *
           ai_merged = true;
         }
         if(state >= I->NCSet) {
+          RepCacheJoinObject(G, I);
           VLACheck(I->CSet, CoordSet *, state);
           I->NCSet = state + 1;
         }
@@ -3995,8 +3998,35 @@ float connect_cutoff_adjustment(
   return 0.f;
 }
 
+enum {
+  cConnectWater = 0x1,
+  cConnectPolymer = 0x2,
+  cConnectCation = 0x4,
+};
+
+/*
+ * Residue and element classification used by is_distance_bonded. Only
+ * depends on the atom, so it's computed once per atom instead of once
+ * per candidate pair.
+ */
+static
+int connect_atom_flags(PyMOLGlobals * G, const AtomInfoType * ai)
+{
+  const char *resn = LexStr(G, ai->resn);
+  int flags = 0;
+  if (AtomInfoKnownWaterResName(G, resn))
+    flags |= cConnectWater;
+  if (AtomInfoKnownPolymerResName(resn))
+    flags |= cConnectPolymer;
+  if (AtomInfoIsFreeCation(G, ai))
+    flags |= cConnectCation;
+  return flags;
+}
+
 /*
  * True if two atoms should be bonded
+ *
+ * Thread-safe, doesn't modify any state.
  */
 static
 bool is_distance_bonded(
@@ -4004,6 +4034,8 @@ bool is_distance_bonded(
     const CoordSet * cs,
     const AtomInfoType * ai1,
     const AtomInfoType * ai2,
+    int flags1,
+    int flags2,
     const float * v1,
     const float * v2,
     float cutoff,
@@ -4029,17 +4061,14 @@ bool is_distance_bonded(
   if (!connect_bonded && ai1->bonded && ai2->bonded)
     return false;
 
-  bool water_flag = (
-      AtomInfoKnownWaterResName(G, LexStr(G, ai1->resn)) ||
-      AtomInfoKnownWaterResName(G, LexStr(G, ai2->resn)));
+  bool water_flag = ((flags1 | flags2) & cConnectWater);
 
   if (connect_mode != 3 &&
       cs->TmpBond && /* connectivity information present in file */
       ai1->hetatm &&
       ai2->hetatm &&
       !water_flag &&
-      !(AtomInfoKnownPolymerResName(LexStr(G, ai1->resn)) &&
-        AtomInfoKnownPolymerResName(LexStr(G, ai2->resn))))
+      !(flags1 & flags2 & cConnectPolymer))
     return false;
 
   // don't connect water atoms in different residues
@@ -4052,8 +4081,7 @@ bool is_distance_bonded(
 
   // if either is a cation, unbond is user wants
   if (unbond_cations &&
-      (AtomInfoIsFreeCation(G, ai1) ||
-       AtomInfoIsFreeCation(G, ai2)))
+      ((flags1 | flags2) & cConnectCation))
     return false;
 
   return true;
@@ -4067,14 +4095,12 @@ int ObjectMoleculeConnect(ObjectMolecule * I, int *nbond, BondType ** bond, Atom
 {
 #define cMULT 1
   PyMOLGlobals *G = I->Obj.G;
-  int a, b, c, d, e, f, i, j;
+  int a, i, j;
   int a1, a2;
-  float *v1, *v2;
   int maxBond;
   MapType *map;
   int nBond;
   BondType *ii1, *ii2;
-  int flag;
   int order;
   AtomInfoType *ai1, *ai2;
   /* Sulfur cutoff */
@@ -4155,90 +4181,119 @@ int ObjectMoleculeConnect(ObjectMolecule * I, int *nbond, BondType ** bond, Atom
 	    map = MapNew(G, max_cutoff + MAX_VDW, cs->Coord, cs->NIndex, NULL);
 	  CHECKOK(ok, map);
           if(ok) {
-            int dim12 = map->D1D2;
-            int dim2 = map->Dim[2];
-
-            for(i = 0; ok && i < cs->NIndex; i++) {
-              if(nBond > maxBond)
-                break;
-	      /* atom i's position in space */
-              v1 = cs->Coord + (3 * i);
-
-              a1 = cs->IdxToAtm[i];
-              ai1 = ai + a1;
-
-              MapLocus(map, v1, &a, &b, &c);
-	      /* d = [a-1, a, a+1] */
-              for(d = a - 1; ok && d <= a + 1; d++) {
-                int *j_ptr1 = map->Head + d * dim12 + (b - 1) * dim2;
-		/* e = [b-1, b, b+1] */
-                for(e = b - 1; ok && e <= b + 1; e++) {
-                  int *j_ptr2 = j_ptr1 + c - 1;
-                  j_ptr1 += dim2;
-		  /* f = [c-1, c, c+1] */
-                  for(f = c - 1; ok && f <= c + 1; f++) {
-                    j = *(j_ptr2++);    /*  *MapFirst(map,d,e,f)); */
-                    while(ok && j >= 0) {
-                      if(i < j) {
-			/* position in space for atom 2 */
-                        v2 = cs->Coord + (3 * j);
-                        a2 = cs->IdxToAtm[j];
-                        ai2 = ai + a2;
-
-                        flag = is_distance_bonded(G, cs, ai1, ai2, v1, v2,
-                            cutoff_v, connect_mode, discrete_chains,
-                            connect_bonded, unbond_cations);
-
-                        {
-
-			  /* we have a bond, now process it */
-                          if(flag) {
-                            VLACheck((*bond), BondType, nBond);
-			    CHECKOK(ok, (*bond));
-			    if (ok){
-			      (*bond)[nBond].index[0] = a1;
-			      (*bond)[nBond].index[1] = a2;
-			      (*bond)[nBond].stereo = 0;
-			      order = 1;
-			    }
-			    /* if we allow bonds between chains and it screws up the
-			     * bonding, disallow inter-chain bonds */
-                            if(ok && discrete_chains < 0) {   /* if we're allowing bonds between chains,
-								 then make sure things don't get out of hand */
-                              if(cnt[i] == -1)
-                                violations++;
-                              if(cnt[j] == -1)
-                                violations++;
-			      /* decrement free valences, since we have a bond */
-                              cnt[i]--;
-                              cnt[j]--;
-                              if(violations > (cs->NIndex >> 3)) {
-                                /* if more than 12% of the structure has excessive #'s of bonds... */
-                                PRINTFB(G, FB_ObjectMolecule, FB_Blather)
-                                  " ObjectMoleculeConnect: Assuming chains are discrete...\n"
-                                  ENDFB(G);
-                                discrete_chains = 1;
-                                repeat = true;
-                                goto do_it_again;
-                              }
-                            }
-
-                            if(!ai1->hetatm || ai1->resn == G->lex_const.MSE) {
-                              if(AtomInfoSameResidue(I->Obj.G, ai1, ai2)) {
-                                /* hookup standard disconnected PDB residue */
-                                assign_pdb_known_residue(G, ai1, ai2, &order);
-                              }
-                            }
-                            (*bond)[nBond].order = -order;      /* store tentative valence as negative */
-                            nBond++;
-                          }
+            int n_chunk = pymol::parallel_chunk_count(
+                SettingGetGlobal_i(G, cSetting_max_threads), cs->NIndex);
+            std::vector<int> flags(cs->NIndex);
+            std::vector<std::vector<std::pair<int, int>>> found(n_chunk);
+            int last_i = -1;
+
+            for(i = 0; i < cs->NIndex; i++)
+              flags[i] = connect_atom_flags(G, ai + cs->IdxToAtm[i]);
+
+            /* find all bonded pairs (i < j) in the local neighborhood of
+             * each atom. Chunks are contiguous ranges of i, so that
+             * concatenating their results gives the serial order. Like the
+             * serial loop below, a chunk gives up once it has more than
+             * maxBond pairs, those would never be processed. */
+            pymol::parallel_for_chunks(n_chunk, cs->NIndex,
+                [&](int chunk, size_t begin, size_t end) {
+              int dim12 = map->D1D2;
+              int dim2 = map->Dim[2];
+              auto& pairs = found[chunk];
+
+              for(int i = (int) begin; i < (int) end; i++) {
+                if(pairs.size() > (size_t) maxBond)
+                  break;
+
+                /* atom i's position in space */
+                const float *v1 = cs->Coord + (3 * i);
+                const AtomInfoType *ai1 = ai + cs->IdxToAtm[i];
+                int a, b, c;
+
+                MapLocus(map, v1, &a, &b, &c);
+                /* d = [a-1, a, a+1] */
+                for(int d = a - 1; d <= a + 1; d++) {
+                  const int *j_ptr1 = map->Head + d * dim12 + (b - 1) * dim2;
+                  /* e = [b-1, b, b+1] */
+                  for(int e = b - 1; e <= b + 1; e++) {
+                    const int *j_ptr2 = j_ptr1 + c - 1;
+                    j_ptr1 += dim2;
+                    /* f = [c-1, c, c+1] */
+                    for(int f = c - 1; f <= c + 1; f++) {
+                      for(int j = *(j_ptr2++); j >= 0; j = MapNext(map, j)) {
+                        if(i < j &&
+                            is_distance_bonded(G, cs, ai1,
+                              ai + cs->IdxToAtm[j], flags[i], flags[j],
+                              v1, cs->Coord + (3 * j), cutoff_v,
+                              connect_mode, discrete_chains,
+                              connect_bonded, unbond_cations)) {
+                          pairs.emplace_back(i, j);
                         }
                       }
-                      j = MapNext(map, j);
                     }
                   }
                 }
               }
+            });
+
+            /* we have the bonds, now process them in order */
+            for(auto& pairs : found) {
+              for(auto& pair : pairs) {
+                i = pair.first;
+                j = pair.second;
+
+                if(i != last_i) {
+                  if(nBond > maxBond)
+                    goto do_it_again;
+                  last_i = i;
+                }
+
+                a1 = cs->IdxToAtm[i];
+                a2 = cs->IdxToAtm[j];
+                ai1 = ai + a1;
+                ai2 = ai + a2;
+
+                VLACheck((*bond), BondType, nBond);
+                CHECKOK(ok, (*bond));
+                if(!ok)
+                  goto do_it_again;
+
+                (*bond)[nBond].index[0] = a1;
+                (*bond)[nBond].index[1] = a2;
+                (*bond)[nBond].stereo = 0;
+                order = 1;
+
+                /* if we allow bonds between chains and it screws up the
+                 * bonding, disallow inter-chain bonds */
+                if(discrete_chains < 0) {   /* if we're allowing bonds between chains,
+                                               then make sure things don't get out of hand */
+                  if(cnt[i] == -1)
+                    violations++;
+                  if(cnt[j] == -1)
+                    violations++;
+                  /* decrement free valences, since we have a bond */
+                  cnt[i]--;
+                  cnt[j]--;
+                  if(violations > (cs->NIndex >> 3)) {
+                    /* if more than 12% of the structure has excessive #'s of bonds... */
+                    PRINTFB(G, FB_ObjectMolecule, FB_Blather)
+                      " ObjectMoleculeConnect: Assuming chains are discrete...\n"
+                      ENDFB(G);
+                    discrete_chains = 1;
+                    repeat = true;
+                    goto do_it_again;
+                  }
+                }
+
+                if(!ai1->hetatm || ai1->resn == G->lex_const.MSE) {
+                  if(AtomInfoSameResidue(I->Obj.G, ai1, ai2)) {
+                    /* hookup standard disconnected PDB residue */
+                    assign_pdb_known_residue(G, ai1, ai2, &order);
+                  }
+                }
+                (*bond)[nBond].order = -order;      /* store tentative valence as negative */
+                nBond++;
+              }
             }
           do_it_again:
             MapFree(map);
@@ -4420,6 +4475,7 @@ int ObjectMoleculeSort(ObjectMolecule * I)
   int *dAtmToIdx = NULL;
   int ok = true;
   if(!I->DiscreteFlag) {        /* currently, discrete objects are never sorted */
+    RepCacheJoinObject(I->Obj.G, I);
     int n_bytes = sizeof(int) * I->NAtom;
     int already_in_order = true;
     int i_NAtom = I->NAtom;
@@ -4508,5 +4564,13 @@ int ObjectMoleculeSort(ObjectMolecule * I)
       ObjectMoleculeInvalidate(I, cRepAll, cRepInvAtoms, -1);     /* important */
     }
   }
+
+  /* memory accounting, loaders hand over untagged buffers */
+  VLASetTag(I->AtomInfo, cMemoryAtoms);
+  VLASetTag(I->Bond, cMemoryAtoms);
+  for(a = 0; a < I->NCSet; a++)
+    if(I->CSet[a])
+      I->CSet[a]->tagMemory();
+
   return ok;
 }
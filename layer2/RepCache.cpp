@@ -0,0 +1,379 @@
+/*
+ * This file contains source code for the PyMOL computer program
+ * Copyright (c) Schrodinger, LLC.
+ *
+ * LRU budget for per-state representations, see RepCache.h
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <list>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "os_std.h"
+#include "Feedback.h"
+#include "Ortho.h"
+#include "Setting.h"
+#include "Rep.h"
+#include "CoordSet.h"
+#include "ObjectMolecule.h"
+#include "Movie.h"
+#include "Scene.h"
+#include "Parallel.h"
+#include "RepCache.h"
+
+namespace {
+struct RepCacheEntry {
+  CoordSet *cs;
+  Rep *rep[cRepCnt];    // representations seen at the last touch
+  size_t bytes;
+  unsigned int frame;   // scene update in which this entry was last touched
+};
+}
+
+struct CRepCache {
+  std::list<RepCacheEntry> lru; // most recently touched first
+  std::unordered_map<const CoordSet *, std::list<RepCacheEntry>::iterator> index;
+  std::mutex mutex;             // touches may come from async_builds threads
+  unsigned int frame = 0;
+  RepCacheStats stats {};
+
+  std::thread prefetch;                 // builds upcoming states
+  std::atomic<bool> prefetch_done {false};
+  std::vector<CoordSet *> prefetched;   // coordinate sets handed to it
+  std::vector<std::string> prefetch_output;     // captured feedback, per job
+  int last_movie_frame = -1;
+  int movie_step = 1;                   // playback direction
+};
+
+static size_t RepCacheGetBudget(PyMOLGlobals * G)
+{
+  int max_mb = SettingGetGlobal_i(G, cSetting_rep_cache_max);
+  return (max_mb > 0) ? (size_t(max_mb) << 20) : 0;
+}
+
+/*
+ * True if a background build may still access `cs`
+ */
+static bool RepCacheIsPrefetching(const CRepCache * I, const CoordSet * cs)
+{
+  return I->prefetch.joinable() &&
+    std::find(I->prefetched.begin(), I->prefetched.end(), cs) != I->prefetched.end();
+}
+
+/*
+ * Estimated size of the representations of `cs` in bytes
+ */
+size_t RepCacheCoordSetSize(const CoordSet * cs)
+{
+  size_t size = 0;
+  for(int a = 0; a < cRepCnt; a++) {
+    Rep *rep = cs->Rep[a];
+    if(rep)
+      size += rep->fMemSize ? rep->fMemSize(rep) : sizeof(Rep);
+  }
+  return size;
+}
+
+int RepCacheInit(PyMOLGlobals * G)
+{
+  G->RepCache = new CRepCache();
+  return 1;
+}
+
+void RepCacheFree(PyMOLGlobals * G)
+{
+  RepCacheJoin(G);
+  delete G->RepCache;
+  G->RepCache = NULL;
+}
+
+/*
+ * Marks the representations of `cs` as used in the current scene update
+ * and refreshes their size estimate. Call after CoordSet::update.
+ */
+void RepCacheTouch(PyMOLGlobals * G, CoordSet * cs)
+{
+  CRepCache *I = G->RepCache;
+  if(!I || !cs)
+    return;
+
+  std::lock_guard<std::mutex> lock(I->mutex);
+  RepCacheEntry *entry;
+  auto found = I->index.find(cs);
+
+  if(found == I->index.end()) {
+    I->lru.push_front(RepCacheEntry());
+    entry = &I->lru.front();
+    entry->cs = cs;
+    I->index[cs] = I->lru.begin();
+  } else {
+    I->lru.splice(I->lru.begin(), I->lru, found->second);
+    entry = &I->lru.front();
+  }
+
+  entry->frame = I->frame;
+
+  for(int a = 0; a < cRepCnt; a++) {
+    Rep *rep = cs->Rep[a];
+    if(rep != entry->rep[a]) {
+      entry->rep[a] = rep;
+      if(rep)
+        I->stats.builds++;
+    } else if(rep) {
+      I->stats.hits++;
+    }
+  }
+
+  size_t bytes = RepCacheCoordSetSize(cs);
+  I->stats.bytes += bytes - entry->bytes;
+  entry->bytes = bytes;
+  if(I->stats.peak < I->stats.bytes)
+    I->stats.peak = I->stats.bytes;
+}
+
+/*
+ * Stops tracking `cs`, e.g. because it is being freed.
+ */
+void RepCacheForget(PyMOLGlobals * G, CoordSet * cs)
+{
+  CRepCache *I = G->RepCache;
+  if(!I)
+    return;
+
+  RepCacheJoinCoordSet(G, cs);
+
+  std::lock_guard<std::mutex> lock(I->mutex);
+  auto found = I->index.find(cs);
+  if(found == I->index.end())
+    return;
+
+  I->stats.bytes -= found->second->bytes;
+  I->lru.erase(found->second);
+  I->index.erase(found);
+}
+
+/*
+ * Frees the representations of least recently used coordinate sets until
+ * the total fits into "rep_cache_max". Coordinate sets touched since the
+ * last trim are in use by the current scene and are never evicted. Call
+ * once per scene update, after all objects have been updated.
+ */
+void RepCacheTrim(PyMOLGlobals * G)
+{
+  CRepCache *I = G->RepCache;
+  if(!I)
+    return;
+
+  std::lock_guard<std::mutex> lock(I->mutex);
+  size_t budget = RepCacheGetBudget(G);
+  int n_evicted = 0;
+
+  if(budget) {
+    auto it = I->lru.end();
+    while(I->stats.bytes > budget && it != I->lru.begin()) {
+      RepCacheEntry& entry = *(--it);
+      if(entry.frame == I->frame)
+        break;                  /* everything left is in use */
+
+      CoordSet *cs = entry.cs;
+      if(RepCacheIsPrefetching(I, cs))
+        continue;               /* about to be shown */
+
+      for(int a = 0; a < cRepCnt; a++) {
+        if(cs->Rep[a]) {
+          cs->Rep[a]->fFree(cs->Rep[a]);
+          cs->Rep[a] = NULL;    /* Active[a] is kept, so it gets rebuilt on demand */
+        }
+      }
+
+      I->stats.bytes -= entry.bytes;
+      I->index.erase(cs);
+      it = I->lru.erase(it);
+      n_evicted++;
+    }
+  }
+
+  if(n_evicted) {
+    I->stats.evictions += n_evicted;
+    PRINTFB(G, FB_CoordSet, FB_Blather)
+      " RepCache: purged representations of %d states, %.1f MB in use.\n",
+      n_evicted, I->stats.bytes / 1048576.0 ENDFB(G);
+  }
+
+  I->frame++;
+}
+
+/*
+ * Starts building the representations of the next "movie_prefetch" movie
+ * frames (in playback direction, wrapping around with "movie_loop") on
+ * background threads. Call at the end of a scene update while the movie
+ * is playing. If the previous builds are still running, they are left
+ * alone and no new ones are started.
+ */
+void RepCachePrefetch(PyMOLGlobals * G, const std::list<CObject *>& objs)
+{
+  CRepCache *I = G->RepCache;
+  int n_ahead = SettingGetGlobal_i(G, cSetting_movie_prefetch);
+  if(!I || n_ahead < 1)
+    return;
+
+  int n_frame = SceneGetNFrame(G, NULL);
+  int frame = SettingGetGlobal_i(G, cSetting_frame) - 1;
+  int loop = SettingGetGlobal_b(G, cSetting_movie_loop);
+  int last = I->last_movie_frame;
+
+  if(frame != last && last >= 0) {
+    if(loop && frame == 0 && last == n_frame - 1)
+      I->movie_step = 1;
+    else if(loop && frame == n_frame - 1 && last == 0)
+      I->movie_step = -1;
+    else
+      I->movie_step = (frame > last) ? 1 : -1;
+  }
+  I->last_movie_frame = frame;
+
+  if(I->prefetch.joinable()) {
+    if(!I->prefetch_done)
+      return;
+    RepCacheJoin(G);
+  }
+
+  struct Job {
+    CoordSet *cs;
+    int state;
+    int mask;                   /* representations to build */
+  };
+  std::vector<Job> jobs;
+
+  for(int k = 1; k <= n_ahead && k < n_frame; k++) {
+    int next = frame + k * I->movie_step;
+    if(next < 0 || next >= n_frame) {
+      if(!loop)
+        break;
+      next = (next % n_frame + n_frame) % n_frame;
+    }
+
+    int state = MovieFrameToIndex(G, next);
+
+    for(auto obj : objs) {
+      int dummy;
+      if(obj->type != cObjectMolecule ||
+         SettingGetIfDefined_i(G, obj->Setting, cSetting_state, &dummy))
+        continue;               /* decoupled from the global state */
+
+      auto objmol = (ObjectMolecule *) obj;
+      if(state < 0 || state >= objmol->NCSet)
+        continue;
+
+      CoordSet *cs = objmol->CSet[state];
+      int mask = cs ? cs->prefetchMask() : 0;
+      if(!mask ||
+         std::find(I->prefetched.begin(), I->prefetched.end(), cs) != I->prefetched.end())
+        continue;
+
+      /* lazily computed, shared by all states */
+      ObjectMoleculeUpdateNeighbors(objmol);
+
+      jobs.push_back({cs, state, mask});
+      I->prefetched.push_back(cs);
+    }
+  }
+
+  if(jobs.empty())
+    return;
+
+  int n_thread = std::max(1, SettingGetGlobal_i(G, cSetting_max_threads));
+
+  I->stats.prefetched += jobs.size();
+  I->prefetch_output.assign(jobs.size(), std::string());
+
+  auto output = &I->prefetch_output;
+  auto done = &I->prefetch_done;
+  *done = false;
+  I->prefetch = std::thread([jobs, n_thread, output, done]() {
+    pymol::parallel_for(n_thread, jobs.size(), [&jobs, output](int i) {
+      /* no progress reports, feedback is replayed by RepCacheJoin */
+      pymol::DetachedScope scope;
+      jobs[i].cs->prefetch(jobs[i].state, jobs[i].mask);
+      (*output)[i] = std::move(scope.output);
+    });
+    *done = true;
+  });
+}
+
+/*
+ * Waits for background builds started by RepCachePrefetch, replays their
+ * feedback and starts tracking the coordinate sets they built.
+ */
+void RepCacheJoin(PyMOLGlobals * G)
+{
+  CRepCache *I = G->RepCache;
+  if(!I || !I->prefetch.joinable())
+    return;
+
+  I->prefetch.join();
+
+  std::vector<std::string> output;
+  std::swap(output, I->prefetch_output);
+  for(auto& str : output) {
+    if(!str.empty())
+      FeedbackAdd(G, str.c_str());
+  }
+
+  std::vector<CoordSet *> prefetched;
+  std::swap(prefetched, I->prefetched);
+  for(auto cs : prefetched)
+    RepCacheTouch(G, cs);
+}
+
+void RepCacheGetStats(PyMOLGlobals * G, RepCacheStats * stats)
+{
+  CRepCache *I = G->RepCache;
+  std::lock_guard<std::mutex> lock(I->mutex);
+  *stats = I->stats;
+  stats->budget = RepCacheGetBudget(G);
+  stats->entries = (int) I->lru.size();
+}
+
+void RepCacheResetStats(PyMOLGlobals * G)
+{
+  CRepCache *I = G->RepCache;
+  std::lock_guard<std::mutex> lock(I->mutex);
+  I->stats.peak = I->stats.bytes;
+  I->stats.hits = 0;
+  I->stats.builds = 0;
+  I->stats.evictions = 0;
+  I->stats.prefetched = 0;
+}
+
+/*
+ * Like RepCacheJoin, but only waits if `cs` is being built
+ */
+void RepCacheJoinCoordSet(PyMOLGlobals * G, const CoordSet * cs)
+{
+  CRepCache *I = G->RepCache;
+  if(I && RepCacheIsPrefetching(I, cs))
+    RepCacheJoin(G);
+}
+
+/*
+ * Like RepCacheJoin, but only waits if states of `obj` are being built
+ */
+void RepCacheJoinObject(PyMOLGlobals * G, const ObjectMolecule * obj)
+{
+  CRepCache *I = G->RepCache;
+  if(!I || !I->prefetch.joinable())
+    return;
+  for(auto cs : I->prefetched) {
+    if(cs->Obj == obj) {
+      RepCacheJoin(G);
+      return;
+    }
+  }
+}
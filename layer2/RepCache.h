@@ -0,0 +1,61 @@
+/*
+ * This file contains source code for the PyMOL computer program
+ * Copyright (c) Schrodinger, LLC.
+ *
+ * Least-recently-used bookkeeping for the representations of coordinate
+ * sets (states). Every coordinate set which gets updated for display is
+ * "touched"; once per scene update, representations of the least
+ * recently displayed states are freed until the total estimated size
+ * fits into the "rep_cache_max" budget (in MB, 0 = unlimited). Freed
+ * representations are simply rebuilt when their state is shown again.
+ *
+ * During movie playback, the representations of the next "movie_prefetch"
+ * states are built on background threads while the current one is shown.
+ * Code which reallocates, frees or renders a coordinate set or its object
+ * must first call RepCacheJoinCoordSet or RepCacheJoinObject, which only
+ * wait if that data is being built. In-place edits are followed by an
+ * invalidation, which joins before the stale representations are freed.
+ * Feedback of the background builds is captured and replayed by
+ * RepCacheJoin.
+ */
+
+#ifndef _H_RepCache
+#define _H_RepCache
+
+#include <cstddef>
+#include <list>
+
+#include "PyMOLGlobals.h"
+
+struct CoordSet;
+struct ObjectMolecule;
+
+struct RepCacheStats {
+  size_t bytes;         // estimated size of all tracked representations
+  size_t peak;          // high water mark of bytes
+  size_t budget;        // current budget in bytes, 0 = unlimited
+  int entries;          // number of tracked coordinate sets
+  int hits;             // representations reused as-is
+  int builds;           // representations (re)built
+  int evictions;        // coordinate sets purged by the budget
+  int prefetched;       // coordinate sets built ahead of display
+};
+
+int RepCacheInit(PyMOLGlobals * G);
+void RepCacheFree(PyMOLGlobals * G);
+
+void RepCacheTouch(PyMOLGlobals * G, CoordSet * cs);
+void RepCacheForget(PyMOLGlobals * G, CoordSet * cs);
+void RepCacheTrim(PyMOLGlobals * G);
+
+void RepCachePrefetch(PyMOLGlobals * G, const std::list<CObject *>& objs);
+void RepCacheJoin(PyMOLGlobals * G);
+void RepCacheJoinCoordSet(PyMOLGlobals * G, const CoordSet * cs);
+void RepCacheJoinObject(PyMOLGlobals * G, const ObjectMolecule * obj);
+
+size_t RepCacheCoordSetSize(const CoordSet * cs);
+
+void RepCacheGetStats(PyMOLGlobals * G, RepCacheStats * stats);
+void RepCacheResetStats(PyMOLGlobals * G);
+
+#endif
@@ -16,7 +16,11 @@ I* Additional authors of this source file include:
 Z* -------------------------------------------------------------------
 */
 
+#include <algorithm>
 #include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
 
 #include"os_predef.h"
 #include"os_std.h"
@@ -35,6 +39,7 @@ Z* -------------------------------------------------------------------
 #include "Lex.h"
 
 #include "AtomIterators.h"
+#include "Parallel.h"
 
 class CCInOut {
   // skip c++11 initialization, this is Calloc'd
@@ -53,10 +58,47 @@ public:
   bool operator== (const CCInOut &other) const { return cc_in == other.cc_in; }
 };
 
+/*
+ * Extruded runs (contiguous stretches of one cartoon type) of a previous
+ * build, keyed by their sampled points, normals, colors, alpha and atom
+ * indices. While coordinates are being edited (sculpting, dragging), all
+ * runs outside of the moved atoms and their smoothing neighbors have
+ * identical input and are spliced into the new CGO without re-extrusion.
+ * Freed by the first update which is not such a rebuild (RepCartoonUpdate).
+ */
+class CartoonExtrusionCache {
+public:
+  std::vector<float> params; // effective settings the runs were made with
+  std::unordered_multimap<std::string, CGO *> runs;
+
+  ~CartoonExtrusionCache() {
+    for (auto& item : runs)
+      CGOFree(item.second);
+  }
+
+  // removes and returns the run with this key, or NULL
+  CGO *take(const std::string& key) {
+    auto it = runs.find(key);
+    if (it == runs.end())
+      return NULL;
+    CGO *cgo = it->second;
+    runs.erase(it);
+    return cgo;
+  }
+
+  size_t mem_size() const {
+    size_t size = sizeof(*this) + params.size() * sizeof(float);
+    for (auto& item : runs)
+      size += item.first.size() + CGOGetMemSize(item.second);
+    return size;
+  }
+};
+
 typedef struct RepCartoon {
   Rep R;                        /* must be first! */
   CGO *ray, *std, *preshader;
   char *LastVisib;
+  CartoonExtrusionCache *extrusions;
   unsigned char renderWithShaders, hasTransparency;
 } RepCartoon;
 
@@ -73,10 +115,35 @@ void RepCartoonFree(RepCartoon * I)
   CGOFree(I->ray);
   CGOFree(I->std);
   FreeP(I->LastVisib);
+  delete I->extrusions;
   RepPurge(&I->R);
   OOFreeP(I);
 }
 
+static size_t RepCartoonMemSize(RepCartoon * I)
+{
+  size_t size = sizeof(RepCartoon) + CGOGetMemSize(I->ray) +
+    CGOGetMemSize(I->std);
+  if (I->ray != I->preshader)
+    size += CGOGetMemSize(I->preshader);
+  if (I->extrusions)
+    size += I->extrusions->mem_size();
+  return size;
+}
+
+/*
+ * Any update other than a rebuild after a coordinate change ends the
+ * edit, so the extruded runs of this build are no longer needed.
+ */
+static Rep *RepCartoonUpdate(RepCartoon * I, CoordSet * cs, int state, int rep)
+{
+  if (I->extrusions && I->R.MaxInvalid != cRepInvCoord) {
+    delete I->extrusions;
+    I->extrusions = NULL;
+  }
+  return RepUpdate(&I->R, cs, state, rep);
+}
+
 /*
  * CGOAddTwoSidedBackfaceSpecialOps: this function takes in a CGO,
  * and outputs a CGO with that CGO wrapped with the two operations:
@@ -133,10 +200,8 @@ static int RepCartoonCGOGenerate(RepCartoon * I, RenderInfo * info)
       // some transparency
       const float *color;
       float colorWithA[4];
-      CGO *convertcgo2;
-      convertcgo2 = CGOSimplify(I->preshader, 0) ;
-      convertcgo = CGOCombineBeginEnd(convertcgo2, 0);
-      CGOFree(convertcgo2);
+      convertcgo = CGOSimplifyCombineOptimize(I->preshader, false,
+          &I->R.cs->SizeHint[cRepCartoon].simplified_alpha);
       CHECKOK(ok, convertcgo);
       color = ColorGet(G, I->R.obj->Color);
       copy3f(color, colorWithA);
@@ -196,19 +261,14 @@ static int RepCartoonCGOGenerate(RepCartoon * I, RenderInfo * info)
 
       /* For the rest of the primitives that exist, simplify them into Geometry
        * (should probably be no more, but do this anyway) */
-      CGO *leftOverCGOSimplified = NULL, *leftOverCGOCombined;
-      leftOverCGOSimplified = CGOSimplify(leftOverCGO, 0);
-      CHECKOK(ok, leftOverCGOSimplified);
-      leftOverCGOCombined = CGOCombineBeginEnd(leftOverCGOSimplified, 0);
-      CGOFree(leftOverCGOSimplified);
+      // and convert all DrawArrays and Geometry to VBOs
+      if (ok)
+        tmpCGO = CGOSimplifyCombineOptimize(leftOverCGO, true,
+            &I->R.cs->SizeHint[cRepCartoon].simplified);
+      CHECKOK(ok, tmpCGO);
       if (leftOverCGO!=I->ray && leftOverCGO!=I->preshader){
         CGOFree(leftOverCGO);
       }
-      // Convert all DrawArrays and Geometry to VBOs 
-      if (ok)
-        tmpCGO = CGOOptimizeToVBONotIndexed(leftOverCGOCombined, 0);
-      CHECKOK(ok, tmpCGO);
-      CGOFree(leftOverCGOCombined);
       if (ok)
         ok &= CGOAppend(convertcgo, tmpCGO);
       CGOFreeWithoutVBOs(tmpCGO);
@@ -2449,13 +2509,59 @@ static int GetCartoonQuality(CoordSet * cs, int setting, int v1, int v2, int v3,
   return quality;
 }
 
+/*
+ * Cache key of an extrusion run: everything the extrusion reads from
+ * `ex` (the sampled path before tangents are computed). Of the 3x3
+ * normals, only the orientation vector (second row) is set at this point.
+ */
+static std::string CartoonExtrusionKey(const CExtrude *ex, int car)
+{
+  std::string key;
+  auto add = [&key](const void *data, size_t size) {
+    key.append((const char *) data, size);
+  };
+  key.reserve(sizeof(int) * 2 + ex->N * (sizeof(float) * 10 + sizeof(int)));
+  add(&car, sizeof(int));
+  add(&ex->N, sizeof(int));
+  add(ex->p, sizeof(float) * 3 * ex->N);
+  for(int a = 0; a < ex->N; a++)
+    add(ex->n + a * 9 + 3, sizeof(float) * 3);
+  add(ex->c, sizeof(float) * 3 * ex->N);
+  add(ex->alpha, sizeof(float) * ex->N);
+  add(ex->i, sizeof(unsigned int) * ex->N);
+  return key;
+}
+
+/*
+ * One extruded run of GenerateRepCartoonCGO
+ */
+struct CartoonExtrusionJob {
+  CExtrude *ex;         // sampled path, NULL if done (e.g. cgo from cache)
+  int car;              // cartoon type
+  std::string key;      // cache key, empty if not cached
+  CGO *cgo;             // separate CGO for this run, NULL for the main CGO
+  int ok;
+};
+
+/*
+ * If `cache` is given, the CGO of every extruded run is stored there, and
+ * runs which are found in `prev` (made with the same settings) are reused
+ * instead of being extruded again. Putty runs are never cached since
+ * their radii depend on B-factors.
+ *
+ * With max_threads > 1, runs are extruded concurrently into separate
+ * CGOs, which are concatenated in order afterwards, so the result is
+ * identical to the serial mode.
+ */
 static
 CGO *GenerateRepCartoonCGO(CoordSet *cs, ObjectMolecule *obj, nuc_acid_data *ndata, short use_cylinders_for_strands,
                            float *pv, int nAt, float *tv, float *pvo,
                            float *dl,
                            const CCInOut *car,
                            int *seg, int *at, int *nuc_flag,
-                           float *putty_vals, float alpha){
+                           float *putty_vals, float alpha,
+                           CartoonExtrusionCache *cache,
+                           CartoonExtrusionCache *prev){
   PyMOLGlobals *G = cs->State.G;
   int ok = true;
   CGO *cgo;
@@ -2541,6 +2647,22 @@ CGO *GenerateRepCartoonCGO(CoordSet *cs, ObjectMolecule *obj, nuc_acid_data *nda
   loop_quality  = GetCartoonQuality(cs, cSetting_cartoon_loop_quality,   6, 6, 5, 4);
   sampling      = GetCartoonQuality(cs, cSetting_cartoon_sampling,       7, 5, 3, 2, 1);
 
+  /* level of detail: coarsen sampling and cross sections alike, about two
+     triangles per cross section vertex and sample */
+  {
+    int n_edge = std::max(std::max(tube_quality, oval_quality),
+                          std::max(putty_quality, loop_quality));
+    float scale = RepGetLodScale(cs, 2.0 * nAt * sampling * n_edge);
+    if(scale < 1.0F) {
+      scale = sqrtf(scale);
+      tube_quality  = std::max(3, (int) (tube_quality * scale));
+      oval_quality  = std::max(3, (int) (oval_quality * scale));
+      putty_quality = std::max(3, (int) (putty_quality * scale));
+      loop_quality  = std::max(3, (int) (loop_quality * scale));
+      sampling      = std::max(1, (int) (sampling * scale));
+    }
+  }
+
   PRINTFB(G, FB_RepCartoon, FB_Blather)
     " RepCartoon: Use settings tube_quality=%d oval_quality=%d putty_quality=%d loop_quality=%d sampling=%d\n",
     tube_quality, oval_quality, putty_quality, loop_quality, sampling
@@ -2573,7 +2695,96 @@ CGO *GenerateRepCartoonCGO(CoordSet *cs, ObjectMolecule *obj, nuc_acid_data *nda
   sampling_tmp = Alloc(float, sampling * 3);
   cartoon_debug = SettingGet_i(G, cs->Setting, obj->Obj.Setting, cSetting_cartoon_debug);
 
-  cgo = CGONew(G);
+  if(cache) {
+    cache->params = {
+      (float) use_cylinders_for_strands, (float) sampling, (float) cartoon_debug,
+      (float) tube_quality, (float) oval_quality, (float) loop_quality,
+      (float) tube_cap, (float) loop_cap, tube_radius, loop_radius,
+      length, width, oval_length, oval_width,
+      dumbbell_length, dumbbell_width, dumbbell_radius,
+      (float) highlight_color };
+    if(highlight_color >= 0) {
+      const float *rgb = ColorGet(G, highlight_color);
+      cache->params.insert(cache->params.end(), rgb, rgb + 3);
+    }
+    if(prev && prev->params != cache->params)
+      prev = NULL;
+  }
+
+  int n_thread = SettingGetGlobal_i(G, cSetting_max_threads);
+  if(cartoon_debug > 0.5 && cartoon_debug < 2.5)
+    n_thread = 1;               /* debug normals are drawn in between */
+
+  /* extrudes `ex` with the shape for cartoon type `car` */
+  auto extrude_run = [&](CExtrude *ex, int car, CGO *target) {
+    int ok = ExtrudeComputeTangents(ex);
+    if (ok){
+      /* set up shape */
+      switch (car) {
+      case cCartoon_tube:
+        ok = CartoonExtrudeTube(use_cylinders_for_strands, ex, target, tube_radius, tube_quality, tube_cap);
+        break;
+      case cCartoon_putty:
+        ok = CartoonExtrudePutty(G, obj, cs, target, ex, putty_quality, putty_radius, putty_vals, sampling);
+        break;
+      case cCartoon_loop:
+        ok = CartoonExtrudeCircle(ex, target, use_cylinders_for_strands, loop_quality, loop_radius, loop_cap);
+        break;
+      case cCartoon_dash:
+        ok = CartoonExtrudeCircle(ex, target, use_cylinders_for_strands, loop_quality, loop_radius, loop_cap, 2);
+        break;
+      case cCartoon_rect:
+        ok = CartoonExtrudeRect(G, ex, target, width, length, highlight_color);
+        break;
+      case cCartoon_oval:
+        ok = CartoonExtrudeOval(G, ex, target, use_cylinders_for_strands, oval_quality, oval_width, oval_length, highlight_color);
+        break;
+      case cCartoon_arrow:
+        ok = CartoonExtrudeArrow(G, ex, target, sampling, width, length, highlight_color);
+        break;
+      case cCartoon_dumbbell:
+        ok = CartoonExtrudeDumbbell(G, ex, target, sampling, dumbbell_width, dumbbell_length, highlight_color, loop_quality, dumbbell_radius, use_cylinders_for_strands);
+        break;
+      }
+    }
+    return ok;
+  };
+
+  /* pending runs, in order */
+  std::vector<CartoonExtrusionJob> jobs;
+
+  /* extrudes the pending runs and appends them to `cgo` */
+  auto extrude_jobs = [&]() {
+    if (ok && n_thread > 1) {
+      /* putty runs print feedback, leave them for the serial pass */
+      pymol::parallel_for(n_thread, jobs.size(), [&](int j) {
+        auto& job = jobs[j];
+        if (job.ok && job.ex && job.car != cCartoon_putty) {
+          job.ok = extrude_run(job.ex, job.car, job.cgo);
+          ExtrudeFree(job.ex);
+          job.ex = NULL;
+        }
+      });
+    }
+    for (auto& job : jobs) {
+      if (ok && job.ok && job.ex)
+        job.ok = extrude_run(job.ex, job.car, job.cgo ? job.cgo : cgo);
+      ok = ok && job.ok;
+      if (job.ex && job.ex != ex)
+        ExtrudeFree(job.ex);
+      if (job.cgo) {
+        if (ok)
+          cgo->copy_append(job.cgo);
+        if (ok && !job.key.empty())
+          cache->runs.emplace(std::move(job.key), job.cgo);
+        else
+          CGOFree(job.cgo);
+      }
+    }
+    jobs.clear();
+  };
+
+  cgo = CGONewSized(G, cs->SizeHint[cRepCartoon].primitive);
   if(alpha != 1.0F)
     CGOAlpha(cgo, alpha);
   /* debugging output */
@@ -2663,42 +2874,28 @@ CGO *GenerateRepCartoonCGO(CoordSet *cs, ObjectMolecule *obj, nuc_acid_data *nda
           }
 
           if (ok){
+            CartoonExtrusionJob job = { ex, cur_car, std::string(), NULL, true };
             ExtrudeTruncate(ex, n_p);
-            ok &= ExtrudeComputeTangents(ex);
-          }
-          if (ok){
-          /* set up shape */
-          switch (cur_car) {
-          case cCartoon_tube:
-            ok = CartoonExtrudeTube(use_cylinders_for_strands, ex, cgo, tube_radius, tube_quality, tube_cap);
-            break;
-          case cCartoon_putty:
-            ok = CartoonExtrudePutty(G, obj, cs, cgo, ex, putty_quality, putty_radius, putty_vals, sampling);
-            if (!ok)
-              contFlag = false;
-            break;
-          case cCartoon_loop:
-            ok = CartoonExtrudeCircle(ex, cgo, use_cylinders_for_strands, loop_quality, loop_radius, loop_cap);
-            break;
-          case cCartoon_dash:
-            ok = CartoonExtrudeCircle(ex, cgo, use_cylinders_for_strands, loop_quality, loop_radius, loop_cap, 2);
-            break;
-          case cCartoon_rect:
-            ok = CartoonExtrudeRect(G, ex, cgo, width, length, highlight_color);
-            break;
-          case cCartoon_oval:
-            ok = CartoonExtrudeOval(G, ex, cgo, use_cylinders_for_strands, oval_quality, oval_width, oval_length, highlight_color);
-            break;
-          case cCartoon_arrow:
-            ok = CartoonExtrudeArrow(G, ex, cgo, sampling, width, length, highlight_color);
-            break;
-          case cCartoon_dumbbell:
-            ok = CartoonExtrudeDumbbell(G, ex, cgo, sampling, dumbbell_width, dumbbell_length, highlight_color, loop_quality, dumbbell_radius, use_cylinders_for_strands);
-            break;
+            if (cache && cur_car != cCartoon_putty) {
+              job.key = CartoonExtrusionKey(ex, cur_car);
+              if (prev && (job.cgo = prev->take(job.key)))
+                job.ex = NULL;  /* unchanged, reuse */
+            }
+            if (job.ex && (n_thread > 1 || !job.key.empty())) {
+              job.cgo = CGONew(G);
+              CHECKOK(job.ok, job.cgo);
+            }
+            if (job.ex && n_thread > 1) {
+              /* extrude later, concurrently with the other runs */
+              job.ex = ExtrudeCopyPointsNormalsColors(ex);
+              CHECKOK(job.ok, job.ex);
+            }
+            jobs.push_back(std::move(job));
+            if (n_thread < 2)
+              extrude_jobs();
           }
           if (!ok)
             contFlag = false;
-          }
         }
         a--;                    /* undo above... */
         extrudeFlag = false;
@@ -2715,6 +2912,8 @@ CGO *GenerateRepCartoonCGO(CoordSet *cs, ObjectMolecule *obj, nuc_acid_data *nda
     }
   }
 
+  extrude_jobs();
+
   if(ok && nAt > 1) {
     if((cartoon_debug > 0.5) && (cartoon_debug < 2.5)) {
       ok = GenerateRepCartoonDrawDebugOrient(cgo, nAt, pv, pvo, tv);
@@ -2727,8 +2926,10 @@ CGO *GenerateRepCartoonCGO(CoordSet *cs, ObjectMolecule *obj, nuc_acid_data *nda
   if(ok && ndata->ring_anchor && ndata->n_ring) {
     ok = GenerateRepCartoonDrawRings(G, ndata, obj, cs, cgo, ring_width, cartoon_color, alpha);
   }
-  if (ok)
+  if (ok) {
     CGOStop(cgo);
+    cs->SizeHint[cRepCartoon].primitive = cgo->c;
+  }
 
   FreeP(sampling_tmp);
 
@@ -3698,6 +3899,7 @@ Rep *RepCartoonNew(CoordSet * cs, int state)
   float alpha;
   int ok = true;
   nuc_acid_data ndata;
+  CartoonExtrusionCache *prev_extrusions = NULL;
   short use_shaders = SettingGetGlobal_b(G, cSetting_use_shaders);
   short na_strands_as_cylinders = use_shaders && 
     (SettingGetGlobal_i(G, cSetting_cartoon_nucleic_acid_as_cylinders) & 2) && 
@@ -3731,6 +3933,8 @@ Rep *RepCartoonNew(CoordSet * cs, int state)
   I->R.fRender = (void (*)(struct Rep *, RenderInfo *)) RepCartoonRender;
   I->R.fSameVis = (int (*)(struct Rep *, struct CoordSet *)) RepCartoonSameVis;
   I->R.fFree = (void (*)(struct Rep *)) RepCartoonFree;
+  I->R.fMemSize = (size_t (*)(struct Rep *)) RepCartoonMemSize;
+  I->R.fUpdate = (Rep *(*)(Rep *, CoordSet *, int, int)) RepCartoonUpdate;
   I->R.fInvalidate = RepCartoonInvalidate;
   I->R.fRecolor = NULL;
   I->R.obj = &obj->Obj;
@@ -3741,6 +3945,19 @@ Rep *RepCartoonNew(CoordSet * cs, int state)
   I->R.context.object = (void *) obj;
   I->R.context.state = state;
 
+  /* rebuilding after a coordinate change (sculpting, dragging): keep the
+     extruded runs for incremental regeneration, and reuse the ones of the
+     previous build (which is still in place while we are called) */
+  {
+    auto prev = (RepCartoon *) cs->Rep[cRepCartoon];
+    if(prev && prev->R.fFree == I->R.fFree &&
+       prev->R.MaxInvalid == cRepInvCoord) {
+      I->extrusions = new CartoonExtrusionCache();
+      prev_extrusions = prev->extrusions;
+      prev->extrusions = NULL;
+    }
+  }
+
   /* find all of the CA points */
 
   at = Alloc(int, cs->NAtIndex);        /* cs index pointers */
@@ -3852,7 +4069,7 @@ Rep *RepCartoonNew(CoordSet * cs, int state)
   }
 
   I->ray = GenerateRepCartoonCGO(cs, obj, &ndata, na_strands_as_cylinders, pv, nAt, tv, pvo, dl, car, seg, at, nuc_flag,
-                                 putty_vals, alpha);
+                                 putty_vals, alpha, I->extrusions, prev_extrusions);
 
   if (I->ray && I->ray->has_begin_end){
     CGOCombineBeginEnd(&I->ray);
@@ -3891,5 +4108,6 @@ Rep *RepCartoonNew(CoordSet * cs, int state)
   FreeP(flag_tmp);
   FreeP(nuc_flag);
   VLAFreeP(ndata.ring_anchor);
+  delete prev_extrusions;
   return (Rep *) I;
 }
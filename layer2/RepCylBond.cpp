@@ -34,6 +34,7 @@
 #include"CGO.h"
 #include "Lex.h"
 
+#include <algorithm>
 #include <iostream>
 
 #ifdef _PYMOL_IOS
@@ -112,6 +113,28 @@ void RepCylBondFree(RepCylBond * I)
   OOFreeP(I);
 }
 
+static size_t RepCylBondMemSize(RepCylBond * I)
+{
+  return sizeof(RepCylBond) + CGOGetMemSize(I->primitiveCGO) +
+    CGOGetMemSize(I->renderCGO);
+}
+
+/*
+ * Stick quality (cylinder edges) for `n_cyl` cylinders: "stick_quality",
+ * lowered as far as needed to fit into "lod_triangle_budget"
+ */
+static int RepCylBondGetLodQuality(CoordSet * cs, int n_cyl)
+{
+  PyMOLGlobals *G = cs->State.G;
+  int nEdge = SettingGet_i(G, cs->Setting, cs->Obj->Obj.Setting, cSetting_stick_quality);
+
+  /* side walls plus two flat caps */
+  float scale = RepGetLodScale(cs, 4.0 * n_cyl * nEdge);
+  if(scale < 1.0F)
+    nEdge = std::max(std::min(nEdge, 4), (int) (nEdge * scale));
+  return nEdge;
+}
+
 static int RepCylBondCGOGenerate(RepCylBond * I, RenderInfo * info)
 {
   PyMOLGlobals *G = I->R.G;
@@ -149,21 +172,15 @@ static int RepCylBondCGOGenerate(RepCylBond * I, RenderInfo * info)
       CGOFreeWithoutVBOs(convertcgo);
       convertcgo = newCGO;
     } else {
-      CGO *convertcgo2 = CGOSimplify(I->renderCGO, 0, SettingGet_i(G, NULL, NULL, cSetting_cgo_sphere_quality), SettingGetGlobal_i(G, cSetting_stick_round_nub));
-      CHECKOK(ok, convertcgo2);
-      if (ok){
-        convertcgo = CGOCombineBeginEnd(convertcgo2, 0);
-        CHECKOK(ok, convertcgo);
-      }
-      CGOFree(convertcgo2);
-      if (ok && use_shader){
-        convertcgo2 = convertcgo;
-        if (ok){
-          convertcgo = CGOOptimizeToVBONotIndexed(convertcgo2, 0);
-          CHECKOK(ok, convertcgo);
-        }
-        CGOFree(convertcgo2);
-      }
+      int n_cyl = CGOCountNumberOfOperationsOfTypeN(I->renderCGO,
+          { CGO_SHADER_CYLINDER, CGO_SHADER_CYLINDER_WITH_2ND_COLOR,
+            CGO_CYLINDER, CGO_SAUSAGE, CGO_CUSTOM_CYLINDER });
+      int stick_quality = RepCylBondGetLodQuality(I->R.cs, n_cyl);
+      convertcgo = CGOSimplifyCombineOptimize(I->renderCGO, use_shader,
+          &I->R.cs->SizeHint[cRepCyl].simplified,
+          SettingGet_i(G, NULL, NULL, cSetting_cgo_sphere_quality),
+          SettingGetGlobal_i(G, cSetting_stick_round_nub), stick_quality);
+      CHECKOK(ok, convertcgo);
     }
     if (convertcgo!=NULL){
       CGOFree(I->renderCGO);
@@ -212,7 +229,7 @@ static void RepCylBondRender(RepCylBond * I, RenderInfo * info)
       }
     } else { /* else not pick, i.e., when rendering */
       if (!I->renderCGO){
-        I->renderCGO = CGONew(G);
+        I->renderCGO = CGONewSized(G, I->primitiveCGO ? I->primitiveCGO->c : 0);
         CHECKOK(ok, I->renderCGO);
         if (ok){
           CGOSetUseShader(I->renderCGO, use_shader);
@@ -668,6 +685,7 @@ Rep *RepCylBondNew(CoordSet * cs, int state)
   RepInit(G, &I->R);
   I->R.fRender = (void (*)(struct Rep *, RenderInfo *)) RepCylBondRender;
   I->R.fFree = (void (*)(struct Rep *)) RepCylBondFree;
+  I->R.fMemSize = (size_t (*)(struct Rep *)) RepCylBondMemSize;
   I->R.obj = (CObject *) obj;
   I->R.cs = cs;
   I->R.context.object = (void *) obj;
@@ -675,7 +693,7 @@ Rep *RepCylBondNew(CoordSet * cs, int state)
 
   I->renderCGO = 0;
 
-  I->primitiveCGO = CGONew(G);
+  I->primitiveCGO = CGONewSized(G, cs->SizeHint[cRepCyl].primitive);
   if (!variable_alpha){
     CGOAlpha(I->primitiveCGO, alpha);
   }
@@ -928,6 +946,7 @@ Rep *RepCylBondNew(CoordSet * cs, int state)
   FreeP(capdrawn);
 
   CGOStop(I->primitiveCGO);
+  cs->SizeHint[cRepCyl].primitive = I->primitiveCGO->c;
   if (!ok){
     RepCylBondFree(I);
     I = NULL;
@@ -1115,7 +1134,7 @@ void RepCylBondRenderImmediate(CoordSet * cs, RenderInfo * info)
   else {
     int active = false;
     ObjectMolecule *obj = cs->Obj;
-    int nEdge = SettingGet_i(G, cs->Setting, obj->Obj.Setting, cSetting_stick_quality);
+    int nEdge = RepCylBondGetLodQuality(cs, obj->NBond);
     float radius =
       fabs(SettingGet_f(G, cs->Setting, obj->Obj.Setting, cSetting_stick_radius));
     float overlap =
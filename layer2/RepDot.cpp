@@ -32,6 +32,7 @@ Z* -------------------------------------------------------------------
 #include"Scene.h"
 #include"ShaderMgr.h"
 #include"CGO.h"
+#include "Parallel.h"
 
 void RepDotFree(RepDot * I);
 static void RepDotRender(RepDot * I, RenderInfo * info);
@@ -56,6 +57,13 @@ void RepDotFree(RepDot * I)
   OOFreeP(I);
 }
 
+static size_t RepDotMemSize(RepDot * I)
+{
+  /* V, VN, A, T, F and Atom per dot */
+  return sizeof(RepDot) + I->N * 10 * sizeof(float) +
+    CGOGetMemSize(I->shaderCGO);
+}
+
 static int RepDotCGOGenerate(RepDot * I, RenderInfo * info)
 {
   PyMOLGlobals *G = I->R.G;
@@ -350,6 +358,7 @@ Rep *RepDotDoNew(CoordSet * cs, int mode, int state)
 
   I->R.fRender = (void (*)(struct Rep *, RenderInfo * info)) RepDotRender;
   I->R.fFree = (void (*)(struct Rep *)) RepDotFree;
+  I->R.fMemSize = (size_t (*)(struct Rep *)) RepDotMemSize;
   I->R.obj = (CObject *) obj;
   I->R.cs = cs;
 
@@ -512,3 +521,129 @@ Rep *RepDotDoNew(CoordSet * cs, int mode, int state)
   }
   return (Rep *) I;
 }
+
+
+/*========================================================================*/
+/*
+ * Parameters and neighbor map for the area computation of one
+ * coordinate set, see RepDotGetAtomAreas
+ */
+struct RepDotAreaJob {
+  CoordSet *cs;
+  float *area;
+  MapType *map;
+  SphereRec *sp;
+  float solv_rad;
+};
+
+static void RepDotAreaJobRun(RepDotAreaJob * job, int a_begin, int a_end)
+{
+  CoordSet *cs = job->cs;
+  ObjectMolecule *obj = cs->Obj;
+  MapType *map = job->map;
+  SphereRec *sp = job->sp;
+  float solv_rad = job->solv_rad;
+  float v1[3];
+  int h, k, l;
+
+  for(int a = a_begin; a < a_end; a++) {
+    int atm = cs->IdxToAtm[a];
+    const AtomInfoType *ai1 = obj->AtomInfo + atm;
+    const float *v0 = cs->Coord + 3 * a;
+    float vdw = ai1->vdw + solv_rad;
+    float area = 0.0F;
+
+    if(!(ai1->flags & cAtomFlag_exfoliate)) {
+      for(int b = 0; b < sp->nDot; b++) {
+        v1[0] = v0[0] + vdw * sp->dot[b][0];
+        v1[1] = v0[1] + vdw * sp->dot[b][1];
+        v1[2] = v0[2] + vdw * sp->dot[b][2];
+
+        MapLocus(map, v1, &h, &k, &l);
+
+        bool flag = true;
+        int i = *(MapEStart(map, h, k, l));
+        if(i) {
+          int j = map->EList[i++];
+          while(j >= 0) {
+            const AtomInfoType *ai2 = obj->AtomInfo + cs->IdxToAtm[j];
+            if(!(ai2->flags & cAtomFlag_ignore) && j != a &&
+               within3f(cs->Coord + 3 * j, v1, ai2->vdw + solv_rad)) {
+              flag = false;
+              break;
+            }
+            j = map->EList[i++];
+          }
+        }
+        if(flag)
+          area += vdw * vdw * sp->area[b];
+      }
+    }
+
+    job->area[atm] = area;
+  }
+}
+
+/*
+ * Surface area of every atom, as computed by RepDotDoNew with
+ * cRepDotAreaType (same dot_density, dot_solvent, solvent_radius and
+ * flag 24/25 handling), without creating a representation.
+ *
+ * For each of the `n` coordinate sets cs[c], area[c][atm] is set for every
+ * atom with coordinates in cs[c] (indexed by atom index). Neighbor maps
+ * are built on the calling thread, the dots are tested on up to
+ * `n_thread` threads.
+ */
+int RepDotGetAtomAreas(PyMOLGlobals * G, int n, CoordSet ** cs, float ** area,
+                       int n_thread)
+{
+  int ok = true;
+  int batch = (n_thread > 1) ? n_thread : 1;
+  std::vector<RepDotAreaJob> jobs;
+
+  for(int c0 = 0; ok && c0 < n; c0 += batch) {
+    int c1 = std::min(c0 + batch, n);
+    jobs.clear();
+
+    for(int c = c0; ok && c < c1; c++) {
+      CoordSet *csc = cs[c];
+      ObjectMolecule *obj = csc->Obj;
+      RepDotAreaJob job;
+      int ds = SettingGet_i(G, csc->Setting, obj->Obj.Setting, cSetting_dot_density);
+
+      job.cs = csc;
+      job.area = area[c];
+      job.solv_rad = 0.0F;
+      if(SettingGet_b(G, csc->Setting, obj->Obj.Setting, cSetting_dot_solvent))
+        job.solv_rad = SettingGet_f(G, csc->Setting, obj->Obj.Setting, cSetting_solvent_radius);
+      job.sp = G->Sphere->Sphere[std::max(0, std::min(ds, 4))];
+      job.map = MapNew(G, MAX_VDW + job.solv_rad, csc->Coord, csc->NIndex, NULL);
+      ok = job.map && MapSetupExpress(job.map);
+      if(job.map)
+        jobs.push_back(job);
+    }
+
+    if(ok) {
+      if(jobs.size() == 1) {
+        RepDotAreaJob *job = &jobs[0];
+        int n_index = job->cs->NIndex;
+        pymol::parallel_for_chunks(
+            pymol::parallel_chunk_count(n_thread, n_index, 256), n_index,
+            [job](int, size_t begin, size_t end) {
+          RepDotAreaJobRun(job, begin, end);
+        });
+      } else {
+        pymol::parallel_for(n_thread, jobs.size(), [&](int c) {
+          RepDotAreaJobRun(&jobs[c], 0, jobs[c].cs->NIndex);
+        });
+      }
+    }
+
+    for(auto & job : jobs)
+      MapFree(job.map);
+
+    ok &= !G->Interrupt;
+  }
+
+  return ok;
+}
@@ -43,4 +43,7 @@ Rep *RepDotNew(CoordSet * cset, int state);
 Rep *RepDotDoNew(CoordSet * cs, int mode, int state);
 void RepDotInit(void);
 
+int RepDotGetAtomAreas(PyMOLGlobals * G, int n, CoordSet ** cs, float ** area,
+                       int n_thread);
+
 #endif
@@ -47,6 +47,12 @@ void RepEllipsoidFree(RepEllipsoid * I)
   OOFreeP(I);
 }
 
+static size_t RepEllipsoidMemSize(RepEllipsoid * I)
+{
+  return sizeof(RepEllipsoid) + CGOGetMemSize(I->ray) +
+    CGOGetMemSize(I->std) + CGOGetMemSize(I->shaderCGO);
+}
+
 static void RepEllipsoidRender(RepEllipsoid * I, RenderInfo * info)
 {
   CRay *ray = info->ray;
@@ -164,6 +170,7 @@ Rep *RepEllipsoidNew(CoordSet * cs, int state)
 
   I->R.fRender = (void (*)(struct Rep *, RenderInfo *)) RepEllipsoidRender;
   I->R.fFree = (void (*)(struct Rep *)) RepEllipsoidFree;
+  I->R.fMemSize = (size_t (*)(struct Rep *)) RepEllipsoidMemSize;
   I->R.cs = cs;
   I->R.obj = (CObject *) obj;
   I->R.context.object = (void *) obj;
@@ -103,6 +103,12 @@ void RepLabelFree(RepLabel * I)
   OOFreeP(I);
 }
 
+static size_t RepLabelMemSize(RepLabel * I)
+{
+  return sizeof(RepLabel) + I->N * (28 * sizeof(float) + sizeof(lexidx_t)) +
+    CGOGetMemSize(I->shaderCGO);
+}
+
 #define MAX_LABEL_TEXTURE_SIZE 256
 #define MAX_LABEL_FOR_ALWAYS_REFRESH 32
 #define PERCENTAGE_CHANGE_FOR_REFRESH .2f
@@ -1527,6 +1533,7 @@ Rep *RepLabelNew(CoordSet * cs, int state)
 
   I->R.fRender = (void (*)(struct Rep *, RenderInfo *)) RepLabelRender;
   I->R.fFree = (void (*)(struct Rep *)) RepLabelFree;
+  I->R.fMemSize = (size_t (*)(struct Rep *)) RepLabelMemSize;
   I->R.fRecolor = NULL;
   I->R.obj = (CObject *) obj;
   I->R.cs = cs;
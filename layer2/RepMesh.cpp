@@ -76,6 +76,12 @@ void RepMeshFree(RepMesh * I)
   OOFreeP(I);
 }
 
+static size_t RepMeshMemSize(RepMesh * I)
+{
+  return sizeof(RepMesh) + I->NTot * 6 * sizeof(float) +
+    I->NDot * 3 * sizeof(float) + CGOGetMemSize(I->shaderCGO);
+}
+
 int RepMeshGetSolventDots(RepMesh * I, CoordSet * cs, float *min, float *max,
                           float probe_radius);
 
@@ -787,6 +793,7 @@ Rep *RepMeshNew(CoordSet * cs, int state)
   I->Dot = NULL;
   I->R.fRender = (void (*)(struct Rep *, RenderInfo *)) RepMeshRender;
   I->R.fFree = (void (*)(struct Rep *)) RepMeshFree;
+  I->R.fMemSize = (size_t (*)(struct Rep *)) RepMeshMemSize;
   I->R.obj = (CObject *) cs->Obj;
   I->R.cs = cs;
   I->R.fRecolor = (void (*)(struct Rep *, struct CoordSet *)) RepMeshColor;
@@ -48,6 +48,12 @@ void RepNonbondedFree(RepNonbonded * I)
   OOFreeP(I);
 }
 
+static size_t RepNonbondedMemSize(RepNonbonded * I)
+{
+  return sizeof(RepNonbonded) + CGOGetMemSize(I->primitiveCGO) +
+    CGOGetMemSize(I->shaderCGO);
+}
+
 void RepNonbondedRenderImmediate(CoordSet * cs, RenderInfo * info)
 {
   PyMOLGlobals *G = cs->State.G;
@@ -264,6 +270,7 @@ Rep *RepNonbondedNew(CoordSet * cs, int state)
 
   I->R.fRender = (void (*)(struct Rep *, RenderInfo *)) RepNonbondedRender;
   I->R.fFree = (void (*)(struct Rep *)) RepNonbondedFree;
+  I->R.fMemSize = (size_t (*)(struct Rep *)) RepNonbondedMemSize;
   I->R.fRecolor = NULL;
   I->shaderCGO = NULL;
 
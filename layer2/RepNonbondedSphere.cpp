@@ -58,6 +58,12 @@ void RepNonbondedSphereFree(RepNonbondedSphere * I)
   OOFreeP(I);
 }
 
+static size_t RepNonbondedSphereMemSize(RepNonbondedSphere * I)
+{
+  return sizeof(RepNonbondedSphere) + CGOGetMemSize(I->shaderCGO) +
+    CGOGetMemSize(I->primitiveCGO);
+}
+
 static void RepNonbondedSphereRender(RepNonbondedSphere * I, RenderInfo * info)
 {
   CRay *ray = info->ray;
@@ -149,6 +155,7 @@ Rep *RepNonbondedSphereNew(CoordSet * cs, int state)
   RepInit(G, &I->R);
   I->R.fRender = (void (*)(struct Rep *, RenderInfo *)) RepNonbondedSphereRender;
   I->R.fFree = (void (*)(struct Rep *)) RepNonbondedSphereFree;
+  I->R.fMemSize = (size_t (*)(struct Rep *)) RepNonbondedSphereMemSize;
   I->R.fRecolor = NULL;
   I->R.obj = (CObject *) (cs->Obj);
   I->R.cs = cs;
@@ -64,6 +64,12 @@ void RepRibbonFree(RepRibbon * I)
   OOFreeP(I);
 }
 
+static size_t RepRibbonMemSize(RepRibbon * I)
+{
+  return sizeof(RepRibbon) + CGOGetMemSize(I->shaderCGO) +
+    CGOGetMemSize(I->primitiveCGO);
+}
+
 static void RepRibbonRender(RepRibbon * I, RenderInfo * info)
 {
   CRay *ray = info->ray;
@@ -196,6 +202,7 @@ Rep *RepRibbonNew(CoordSet * cs, int state)
   I->radius = SettingGet_f(G, cs->Setting, obj->Obj.Setting, cSetting_ribbon_radius);
   I->R.fRender = (void (*)(struct Rep *, RenderInfo *)) RepRibbonRender;
   I->R.fFree = (void (*)(struct Rep *)) RepRibbonFree;
+  I->R.fMemSize = (size_t (*)(struct Rep *)) RepRibbonMemSize;
   I->R.fRecolor = NULL;
   I->R.obj = (CObject *) obj;
   I->R.cs = cs;
@@ -14,6 +14,8 @@
    -*
    Z* -------------------------------------------------------------------
 */
+#include <algorithm>
+
 #include"os_python.h"
 #include"os_predef.h"
 #include"os_std.h"
@@ -73,6 +75,15 @@ void RepSphereFree(RepSphere * I)
   OOFreeP(I);
 }
 
+static size_t RepSphereMemSize(RepSphere * I)
+{
+  size_t size = sizeof(RepSphere) + CGOGetMemSize(I->renderCGO) +
+    CGOGetMemSize(I->spheroidCGO);
+  if (I->primitiveCGO != I->renderCGO)
+    size += CGOGetMemSize(I->primitiveCGO);
+  return size;
+}
+
 /* MULTI-INSTSANCE TODO:  isn't this a conflict? */
 CShaderPrg *sphereARBShaderPrg = NULL;
 
@@ -122,16 +133,9 @@ static void RepSphereRenderPick(RepSphere * I, RenderInfo * info, int sphere_mod
     // only for sphere_mode 5, where we don't use a renderCGO (yet) ARB: immediate mode GL_QUADS
     short use_shader = SettingGetGlobal_b(G, cSetting_sphere_use_shader) &&
       SettingGetGlobal_b(G, cSetting_use_shaders);
-    CGO *convertcgo = CGOSimplify(I->primitiveCGO, 0, 0);
-    CGO *convertcgo2 = CGOCombineBeginEnd(convertcgo, 0);
-    if (use_shader){
-      I->renderCGO = CGOOptimizeToVBONotIndexed(convertcgo2, 0);
-      CGOFree(convertcgo2);
-    } else {
-      I->renderCGO = convertcgo2;
-    }
+    I->renderCGO = CGOSimplifyCombineOptimize(I->primitiveCGO, use_shader,
+        &I->R.cs->SizeHint[cRepSphere].simplified, 0);
     I->renderCGO->use_shader = use_shader;
-    CGOFree(convertcgo);
   }
   CGORenderGLPicking(I->renderCGO, info, &I->R.context, I->R.cs->Setting, I->R.obj->Setting);
 }
@@ -484,6 +488,29 @@ static void RepSphereSetNormalForSphere(RepSphere *I, MapType *map, float *v_tmp
 	    }
 }
 
+/*
+ * Triangle sphere quality for `n_sphere` spheres: "sphere_quality",
+ * lowered as far as needed to fit into "lod_triangle_budget"
+ */
+int RepSphereGetLodQuality(CoordSet * cs, int n_sphere, int sphere_quality)
+{
+  PyMOLGlobals *G = cs->State.G;
+  auto n_triangles = [G, n_sphere](int ds) {
+    SphereRec *sp = G->Sphere->Sphere[ds];
+    return (double) n_sphere * (sp->NVertTot - 2 * sp->NStrip);
+  };
+
+  int ds = std::max(0, std::min(sphere_quality, NUMBER_OF_SPHERE_LEVELS - 1));
+  float scale = RepGetLodScale(cs, n_triangles(ds));
+  if(scale < 1.0F) {
+    double budget = n_triangles(ds) * scale;
+    while(ds > 0 && n_triangles(ds) > budget)
+      ds--;
+    sphere_quality = ds;
+  }
+  return sphere_quality;
+}
+
 Rep *RepSphereNew(CoordSet * cs, int state)
 {
   PyMOLGlobals *G = cs->State.G;
@@ -542,6 +569,7 @@ Rep *RepSphereNew(CoordSet * cs, int state)
   if (ok){
     I->R.fRender = (void (*)(struct Rep *, RenderInfo *)) RepSphereRender;
     I->R.fFree = (void (*)(struct Rep *)) RepSphereFree;
+    I->R.fMemSize = (size_t (*)(struct Rep *)) RepSphereMemSize;
     I->R.fSameVis = (int (*)(struct Rep *, struct CoordSet *)) RepSphereSameVis;
     I->R.obj = (CObject *) obj;
     I->R.cs = cs;
@@ -560,7 +588,7 @@ Rep *RepSphereNew(CoordSet * cs, int state)
       CHECKOK(ok, I->R.P);
     }
   }
-  I->primitiveCGO = CGONew(G);
+  I->primitiveCGO = CGONewSized(G, cs->SizeHint[cRepSphere].primitive);
 
   bool needNormals = (sphere_mode >= 6) && (sphere_mode < 9);
   int nspheres = 0;
@@ -616,6 +644,7 @@ Rep *RepSphereNew(CoordSet * cs, int state)
     }
   }
   CGOStop(I->primitiveCGO);
+  cs->SizeHint[cRepSphere].primitive = I->primitiveCGO->c;
 
   if(ok) {
     if(!I->LastVisib)
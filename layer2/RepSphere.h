@@ -30,6 +30,7 @@ typedef struct RepSphere {
 } RepSphere;
 
 Rep *RepSphereNew(CoordSet * cset, int state);
+int RepSphereGetLodQuality(CoordSet * cs, int n_sphere, int sphere_quality);
 void RepSphereInit(void);
 void RenderSphereComputeFog(PyMOLGlobals *G, RenderInfo *info, float *fog_info);
 
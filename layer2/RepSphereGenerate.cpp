@@ -28,6 +28,9 @@ void RepSphere_Generate_Triangles(PyMOLGlobals *G, RepSphere *I,
   int ok = true;
   int sphere_quality = SettingGet_i(G, I->R.cs->Setting, I->R.obj->Setting,
                                     cSetting_sphere_quality);
+  sphere_quality = RepSphereGetLodQuality(I->R.cs,
+      CGOCountNumberOfOperationsOfType(I->primitiveCGO, CGO_SPHERE),
+      sphere_quality);
 
   use_shader = SettingGetGlobal_b(G, cSetting_sphere_use_shader) &&
                SettingGetGlobal_b(G, cSetting_use_shaders);
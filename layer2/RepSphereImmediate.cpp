@@ -107,6 +107,7 @@ static void RenderSphereMode_Immediate_Triangles(PyMOLGlobals *G, CoordSet *cs,
   /* triangle-based spheres */
   int ds =
       SettingGet_i(G, cs->Setting, obj->Obj.Setting, cSetting_sphere_quality);
+  ds = RepSphereGetLodQuality(cs, cs->NIndex, ds);
   if (ds < 0) ds = 0;
   if (ds > 4) ds = 4;
   SphereRec *sp = G->Sphere->Sphere[ds];
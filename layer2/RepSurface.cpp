@@ -115,6 +115,14 @@ void RepSurfaceFree(RepSurface * I)
   OOFreeP(I);
 }
 
+static size_t RepSurfaceMemSize(RepSurface * I)
+{
+  /* V, VN, VC, VA, VAO, RC, Vis and AT per vertex; T per triangle */
+  return sizeof(RepSurface) + I->N * 14 * sizeof(float) +
+    I->NT * 3 * sizeof(int) + CGOGetMemSize(I->shaderCGO) +
+    CGOGetMemSize(I->pickingCGO);
+}
+
 typedef struct {
   int nDot;
   float *dot;
@@ -282,7 +290,7 @@ static int RepSurfaceCGOGenerate(RepSurface * I, RenderInfo * info)
   if(fabs(alpha - 1.0) < R_SMALL4)
     alpha = 1.0F;
 
-  setShaderCGO(I, CGONew(G));
+  setShaderCGO(I, CGONewSized(G, I->R.cs->SizeHint[cRepSurface].primitive));
 
   if (!I->shaderCGO)
     return false;
@@ -1300,6 +1308,8 @@ static int RepSurfaceCGOGenerate(RepSurface * I, RenderInfo * info)
 
   
   if (ok) ok &= CGOStop(I->shaderCGO);
+  if (ok)
+    I->R.cs->SizeHint[cRepSurface].primitive = I->shaderCGO->c;
   if (I->Type != 2){
     CGOCombineBeginEnd(&I->shaderCGO);
     if (I->Type == 1){
@@ -4155,6 +4165,7 @@ Rep *RepSurfaceNew(CoordSet * cs, int state)
       I->R.context.state = state;
       I->R.fRender = (void (*)(struct Rep *, RenderInfo * info)) RepSurfaceRender;
       I->R.fFree = (void (*)(struct Rep *)) RepSurfaceFree;
+      I->R.fMemSize = (size_t (*)(struct Rep *)) RepSurfaceMemSize;
       I->R.fRecolor = (void (*)(struct Rep *, struct CoordSet *)) RepSurfaceColor;
       I->R.fSameVis = (int (*)(struct Rep *, struct CoordSet *)) RepSurfaceSameVis;
       I->R.fSameColor = (int (*)(struct Rep *, struct CoordSet *)) RepSurfaceSameColor;
@@ -235,6 +235,12 @@ void RepWireBondFree(RepWireBond * I)
   OOFreeP(I);
 }
 
+static size_t RepWireBondMemSize(RepWireBond * I)
+{
+  return sizeof(RepWireBond) + CGOGetMemSize(I->shaderCGO) +
+    CGOGetMemSize(I->primitiveCGO);
+}
+
 
 /* lower memory use and higher performance for
    display of large trajectories, etc. */
@@ -694,6 +700,7 @@ Rep *RepWireBondNew(CoordSet * cs, int state)
 
   I->R.fRender = (void (*)(struct Rep *, RenderInfo * info)) RepWireBondRender;
   I->R.fFree = (void (*)(struct Rep *)) RepWireBondFree;
+  I->R.fMemSize = (size_t (*)(struct Rep *)) RepWireBondMemSize;
 
   I->shaderCGO = 0;
   I->shaderCGO_has_cylinders = 0;
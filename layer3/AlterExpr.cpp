@@ -0,0 +1,745 @@
+/*
+ * This file contains source code for the PyMOL computer program
+ * Copyright (c) Schrodinger, LLC.
+ *
+ * Native evaluation of simple alter/alter_state expressions, see
+ * AlterExpr.h
+ */
+
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+
+#include "os_std.h"
+#include "Util.h"
+#include "Setting.h"
+#include "P.h"
+#include "PyMOL.h"
+#include "AtomInfo.h"
+#include "CoordSet.h"
+#include "ObjectMolecule.h"
+#include "Selector.h"
+#include "Scene.h"
+#include "Parallel.h"
+#include "RepCache.h"
+#include "AlterExpr.h"
+
+enum {
+  tokEnd, tokName, tokInt, tokFloat, tokStr, tokOp
+};
+
+enum {
+  opConstI, opConstF, opConstS, opLoad, opI2F,
+  opAddI, opSubI, opMulI, opNegI,
+  opAddF, opSubF, opMulF, opDivF, opNegF
+};
+
+#define ALTER_EXPR_MAX_STACK 32
+
+namespace {
+struct Number {
+  long long i;
+  double f;
+};
+
+struct StrValue {
+  lexidx_t lex;
+  bool is_lex;
+  std::string str;
+};
+
+struct AtomContext {
+  PyMOLGlobals *G;
+  AtomInfoType *ai;
+  int atm;
+  CoordSet *cs;
+  int idx;
+  int state;
+};
+}
+
+static bool IsStringType(const AtomPropertyInfo * ap)
+{
+  return ap->Ptype == cPType_int_as_string || ap->Ptype == cPType_string;
+}
+
+/*
+ * Evaluate a numeric program
+ */
+static void AlterExprRun(const std::vector<AlterExpr::Instr> &code,
+    const AtomContext &ctx, Number &result)
+{
+  Number stack[ALTER_EXPR_MAX_STACK];
+  int top = -1;
+
+  for(auto it = code.begin(); it != code.end(); ++it) {
+    switch (it->op) {
+    case opConstI:
+      stack[++top].i = it->i;
+      break;
+    case opConstF:
+      stack[++top].f = it->f;
+      break;
+    case opLoad:
+      {
+        const char *ptr = (const char *) ctx.ai + it->ap->offset;
+        Number &v = stack[++top];
+        switch (it->ap->Ptype) {
+        case cPType_float:    v.f = *(const float *) ptr; break;
+        case cPType_int:      v.i = *(const int *) ptr; break;
+        case cPType_schar:    v.i = *(const signed char *) ptr; break;
+        case cPType_index:    v.i = ctx.atm + 1; break;
+        case cPType_state:    v.i = ctx.state + 1; break;
+        case cPType_xyz_float:
+          v.f = ctx.cs->coordPtr(ctx.idx)[it->ap->offset];
+          break;
+        }
+      }
+      break;
+    case opI2F:
+      stack[top - it->i].f = (double) stack[top - it->i].i;
+      break;
+    case opAddI: top--; stack[top].i += stack[top + 1].i; break;
+    case opSubI: top--; stack[top].i -= stack[top + 1].i; break;
+    case opMulI: top--; stack[top].i *= stack[top + 1].i; break;
+    case opNegI: stack[top].i = -stack[top].i; break;
+    case opAddF: top--; stack[top].f += stack[top + 1].f; break;
+    case opSubF: top--; stack[top].f -= stack[top + 1].f; break;
+    case opMulF: top--; stack[top].f *= stack[top + 1].f; break;
+    case opDivF: top--; stack[top].f /= stack[top + 1].f; break;
+    case opNegF: stack[top].f = -stack[top].f; break;
+    }
+  }
+
+  result = stack[0];
+}
+
+/*
+ * Evaluate a string program (single literal or field load). Lexicon
+ * references are incremented, the caller must release them.
+ */
+static void AlterExprRunStr(const std::vector<AlterExpr::Instr> &code,
+    const AtomContext &ctx, StrValue &result)
+{
+  const AlterExpr::Instr &instr = code.front();
+
+  if(instr.op == opConstS) {
+    result.is_lex = true;
+    result.lex = (lexidx_t) instr.i;
+  } else if(instr.ap->Ptype == cPType_int_as_string) {
+    result.is_lex = true;
+    result.lex = *(const lexidx_t *) ((const char *) ctx.ai + instr.ap->offset);
+  } else {
+    result.is_lex = false;
+    result.str = (const char *) ctx.ai + instr.ap->offset;
+    return;
+  }
+
+  LexInc(ctx.G, result.lex);
+}
+
+AlterExpr::AlterExpr(PyMOLGlobals * G, const char *expr, bool coords) :
+  m_G(G), m_coords(coords), m_valid(false), m_serial(false), m_pos(0)
+{
+  if(!tokenize(expr))
+    return;
+
+  do {
+    if(!parseStatement())
+      return;
+  } while(accept(";") && m_tokens[m_pos].kind != tokEnd);
+
+  m_valid = (m_tokens[m_pos].kind == tokEnd) && !m_assignments.empty();
+}
+
+AlterExpr::~AlterExpr()
+{
+  for(auto lex : m_literals)
+    LexDec(m_G, lex);
+}
+
+/*
+ * Split into tokens. Returns false for anything outside of the supported
+ * subset (comments, escapes, leading indentation, power operator, ...).
+ */
+bool AlterExpr::tokenize(const char *p)
+{
+  if(isspace(*p))
+    return false;               // IndentationError in Python
+
+  for(;;) {
+    Token tok;
+    tok.kind = tokOp;
+    tok.i = 0;
+    tok.f = 0.;
+
+    while(*p == ' ' || *p == '\t')
+      p++;
+
+    if(*p == '\n' || *p == '\r') {
+      // only trailing line breaks
+      while(isspace(*p))
+        p++;
+      if(*p)
+        return false;
+    }
+
+    if(!*p) {
+      tok.kind = tokEnd;
+      m_tokens.push_back(tok);
+      return true;
+    }
+
+    if(isalpha(*p) || *p == '_') {
+      const char *start = p;
+      while(isalnum(*p) || *p == '_')
+        p++;
+      tok.kind = tokName;
+      tok.text.assign(start, p);
+    } else if(isdigit(*p) || (*p == '.' && isdigit(p[1]))) {
+      const char *start = p;
+      bool is_float = false;
+      while(isdigit(*p))
+        p++;
+      if(*p == '.') {
+        is_float = true;
+        p++;
+        while(isdigit(*p))
+          p++;
+      }
+      if(*p == 'e' || *p == 'E') {
+        is_float = true;
+        p++;
+        if(*p == '+' || *p == '-')
+          p++;
+        if(!isdigit(*p))
+          return false;
+        while(isdigit(*p))
+          p++;
+      }
+      if(isalnum(*p) || *p == '_' || *p == '.')
+        return false;           // complex, hex, 1_000, ...
+      tok.text.assign(start, p);
+      if(is_float) {
+        tok.kind = tokFloat;
+        tok.f = strtod(tok.text.c_str(), NULL);
+      } else {
+        if(tok.text.size() > 1 && tok.text[0] == '0')
+          return false;         // invalid or octal literal
+        if(tok.text.size() > 15)
+          return false;
+        tok.kind = tokInt;
+        tok.i = strtoll(tok.text.c_str(), NULL, 10);
+      }
+    } else if(*p == '\'' || *p == '"') {
+      char quote = *(p++);
+      const char *start = p;
+      while(*p && *p != quote) {
+        if(*p == '\\' || *p == '\n')
+          return false;
+        p++;
+      }
+      if(*p != quote)
+        return false;
+      tok.kind = tokStr;
+      tok.text.assign(start, p);
+      p++;
+    } else if(strchr("+-*", *p) && p[1] == '=') {
+      tok.text.assign(p, 2);
+      p += 2;
+    } else if(strchr("(),;=+-*/", *p)) {
+      if((p[0] == '*' && p[1] == '*') || (p[0] == '/' && (p[1] == '/' || p[1] == '=')))
+        return false;
+      tok.text.assign(p, 1);
+      p++;
+    } else {
+      return false;
+    }
+
+    m_tokens.push_back(tok);
+  }
+}
+
+bool AlterExpr::accept(const char *op)
+{
+  const Token &tok = m_tokens[m_pos];
+  if(tok.kind == tokOp && tok.text == op) {
+    m_pos++;
+    return true;
+  }
+  return false;
+}
+
+/*
+ * Atom property for a name token, or NULL if the name is not supported
+ * in the current mode.
+ */
+static const AtomPropertyInfo * AlterExprGetProperty(PyMOLGlobals * G,
+    const std::string &name, bool coords)
+{
+  const AtomPropertyInfo *ap = PyMOL_GetAtomPropertyInfo(G->PyMOL, name.c_str());
+  if(!ap)
+    return NULL;
+
+  switch (ap->Ptype) {
+  case cPType_float:
+  case cPType_int:
+  case cPType_schar:
+  case cPType_index:
+  case cPType_int_as_string:
+  case cPType_string:
+    return ap;
+  case cPType_xyz_float:
+  case cPType_state:
+    return coords ? ap : NULL;
+  }
+
+  return NULL;
+}
+
+bool AlterExpr::parseTarget(std::vector<const AtomPropertyInfo *> &targets)
+{
+  const Token &tok = m_tokens[m_pos];
+  if(tok.kind != tokName)
+    return false;
+
+  const AtomPropertyInfo *ap = AlterExprGetProperty(m_G, tok.text, m_coords);
+  if(!ap || ap->Ptype == cPType_index || ap->Ptype == cPType_state)
+    return false;               // read-only
+
+  m_pos++;
+  targets.push_back(ap);
+  return true;
+}
+
+/*
+ * target = expr
+ * target op= expr
+ * (target, ...) = (expr, ...)
+ * target, ... = expr, ...
+ */
+bool AlterExpr::parseStatement()
+{
+  Assignment assignment;
+  auto &targets = assignment.targets;
+
+  if(accept("(")) {
+    do {
+      if(!parseTarget(targets))
+        return false;
+    } while(accept(",") && !(m_tokens[m_pos].kind == tokOp && m_tokens[m_pos].text == ")"));
+    if(!accept(")"))
+      return false;
+  } else {
+    do {
+      if(!parseTarget(targets))
+        return false;
+    } while(accept(","));
+  }
+
+  // augmented assignment: target = target op (expr)
+  int aug_op = -1;
+  if(targets.size() == 1) {
+    if(accept("+="))
+      aug_op = 0;
+    else if(accept("-="))
+      aug_op = 1;
+    else if(accept("*="))
+      aug_op = 2;
+  }
+
+  if(aug_op < 0 && !accept("="))
+    return false;
+
+  bool paren = (targets.size() > 1) && accept("(");
+
+  for(size_t k = 0; k < targets.size(); k++) {
+    std::vector<Instr> code;
+    ValueType type;
+
+    if(k && !accept(","))
+      return false;
+
+    if(aug_op >= 0) {
+      ValueType lhs = emitLoad(targets[0], code);
+      ValueType rhs = parseExpr(code);
+      if(lhs == tStr || rhs == tStr || lhs == tInvalid || rhs == tInvalid)
+        return false;
+      type = (lhs == tFloat || rhs == tFloat) ? tFloat : tInt;
+      if(type == tFloat) {
+        if(lhs == tInt)
+          code.push_back({opI2F, NULL, 1, 0.});
+        if(rhs == tInt)
+          code.push_back({opI2F, NULL, 0, 0.});
+      }
+      static const int ops[2][3] = {
+        {opAddI, opSubI, opMulI}, {opAddF, opSubF, opMulF}};
+      code.push_back({ops[type == tFloat][aug_op], NULL, 0, 0.});
+    } else {
+      type = parseExpr(code);
+    }
+
+    // type check against the target
+    const AtomPropertyInfo *ap = targets[k];
+    switch (type) {
+    case tInvalid:
+      return false;
+    case tStr:
+      if(!IsStringType(ap) || code.size() != 1)
+        return false;
+      m_serial = true;
+      break;
+    case tInt:
+      if(IsStringType(ap))
+        return false;
+      break;
+    case tFloat:
+      // int() conversion of a float raises in Python
+      if(ap->Ptype != cPType_float && ap->Ptype != cPType_xyz_float)
+        return false;
+      break;
+    }
+
+    if(ap->id == ATOM_PROP_ELEM)
+      m_serial = true;          // AtomInfoAssignParameters
+
+    // stack depth
+    int depth = 0;
+    for(auto it = code.begin(); it != code.end(); ++it) {
+      switch (it->op) {
+        case opConstI: case opConstF: case opConstS: case opLoad:
+          if(++depth > ALTER_EXPR_MAX_STACK)
+            return false;
+          break;
+        case opAddI: case opSubI: case opMulI:
+        case opAddF: case opSubF: case opMulF: case opDivF:
+          depth--;
+          break;
+      }
+    }
+
+    assignment.code.push_back(code);
+    assignment.types.push_back(type);
+  }
+
+  if(paren && !accept(")"))
+    return false;
+
+  m_assignments.push_back(assignment);
+  return true;
+}
+
+/*
+ * Numeric or string load of an atom property
+ */
+AlterExpr::ValueType AlterExpr::emitLoad(const AtomPropertyInfo * ap,
+    std::vector<Instr> &code)
+{
+  code.push_back({opLoad, ap, 0, 0.});
+
+  switch (ap->Ptype) {
+  case cPType_float:
+  case cPType_xyz_float:
+    return tFloat;
+  case cPType_int_as_string:
+  case cPType_string:
+    return tStr;
+  }
+
+  return tInt;
+}
+
+AlterExpr::ValueType AlterExpr::parseExpr(std::vector<Instr> &code)
+{
+  ValueType lhs = parseTerm(code);
+
+  for(;;) {
+    bool add = accept("+");
+    if(!add && !accept("-"))
+      return lhs;
+
+    ValueType rhs = parseTerm(code);
+    if(lhs == tStr || rhs == tStr || lhs == tInvalid || rhs == tInvalid)
+      return tInvalid;
+
+    if(lhs == tFloat || rhs == tFloat) {
+      if(lhs == tInt)
+        code.push_back({opI2F, NULL, 1, 0.});
+      if(rhs == tInt)
+        code.push_back({opI2F, NULL, 0, 0.});
+      code.push_back({add ? opAddF : opSubF, NULL, 0, 0.});
+      lhs = tFloat;
+    } else {
+      code.push_back({add ? opAddI : opSubI, NULL, 0, 0.});
+    }
+  }
+}
+
+AlterExpr::ValueType AlterExpr::parseTerm(std::vector<Instr> &code)
+{
+  ValueType lhs = parseFactor(code);
+
+  for(;;) {
+    bool mul = accept("*");
+    if(!mul && !accept("/"))
+      return lhs;
+
+    size_t rhs_start = code.size();
+    ValueType rhs = parseFactor(code);
+    if(lhs == tStr || rhs == tStr || lhs == tInvalid || rhs == tInvalid)
+      return tInvalid;
+
+    if(!mul) {
+      // true division: needs a float operand (Python 2 would truncate
+      // integers), and a non-zero literal divisor (no ZeroDivisionError)
+      if(lhs == tInt && rhs == tInt)
+        return tInvalid;
+      if(code.size() != rhs_start + 1)
+        return tInvalid;
+      const Instr &divisor = code.back();
+      if(!((divisor.op == opConstF && divisor.f != 0.) ||
+           (divisor.op == opConstI && divisor.i != 0)))
+        return tInvalid;
+    }
+
+    if(lhs == tFloat || rhs == tFloat) {
+      if(lhs == tInt)
+        code.push_back({opI2F, NULL, 1, 0.});
+      if(rhs == tInt)
+        code.push_back({opI2F, NULL, 0, 0.});
+      code.push_back({mul ? opMulF : opDivF, NULL, 0, 0.});
+      lhs = tFloat;
+    } else {
+      code.push_back({opMulI, NULL, 0, 0.});
+    }
+  }
+}
+
+AlterExpr::ValueType AlterExpr::parseFactor(std::vector<Instr> &code)
+{
+  if(accept("+"))
+    return parseFactor(code);
+
+  if(accept("-")) {
+    ValueType type = parseFactor(code);
+    switch (type) {
+    case tInt:
+      code.push_back({opNegI, NULL, 0, 0.});
+      break;
+    case tFloat:
+      code.push_back({opNegF, NULL, 0, 0.});
+      break;
+    default:
+      return tInvalid;
+    }
+    return type;
+  }
+
+  return parseAtom(code);
+}
+
+AlterExpr::ValueType AlterExpr::parseAtom(std::vector<Instr> &code)
+{
+  const Token &tok = m_tokens[m_pos];
+
+  switch (tok.kind) {
+  case tokInt:
+    m_pos++;
+    code.push_back({opConstI, NULL, tok.i, 0.});
+    return tInt;
+  case tokFloat:
+    m_pos++;
+    code.push_back({opConstF, NULL, 0, tok.f});
+    return tFloat;
+  case tokStr:
+    {
+      m_pos++;
+      lexidx_t lex = LexIdx(m_G, tok.text.c_str());
+      if(lex)
+        m_literals.push_back(lex);
+      code.push_back({opConstS, NULL, (long long) lex, 0.});
+      return tStr;
+    }
+  case tokName:
+    {
+      const AtomPropertyInfo *ap = AlterExprGetProperty(m_G, tok.text, m_coords);
+      if(!ap)
+        return tInvalid;        // namespace variable, function, keyword
+      m_pos++;
+      return emitLoad(ap, code);
+    }
+  }
+
+  if(accept("(")) {
+    ValueType type = parseExpr(code);
+    if(!accept(")"))
+      return tInvalid;
+    return type;
+  }
+
+  return tInvalid;
+}
+
+/*
+ * Store a numeric value like WrapperObjectAssignSubScript does
+ */
+static void AlterExprStore(const AtomPropertyInfo * ap, AlterExpr::ValueType type,
+    const Number &value, const AtomContext &ctx)
+{
+  char *ptr = (char *) ctx.ai + ap->offset;
+  double f = (type == AlterExpr::tInt) ? (double) value.i : value.f;
+
+  switch (ap->Ptype) {
+  case cPType_float:
+    *(float *) ptr = (float) f;
+    break;
+  case cPType_int:
+    *(int *) ptr = (int) value.i;
+    break;
+  case cPType_schar:
+    *(signed char *) ptr = (signed char) value.i;
+    break;
+  case cPType_xyz_float:
+    ctx.cs->coordPtr(ctx.idx)[ap->offset] = (float) f;
+    break;
+  }
+}
+
+static void AlterExprStoreStr(const AtomPropertyInfo * ap,
+    const StrValue &value, const AtomContext &ctx)
+{
+  char *ptr = (char *) ctx.ai + ap->offset;
+
+  if(ap->Ptype == cPType_int_as_string) {
+    if(value.is_lex)
+      LexAssign(ctx.G, *(lexidx_t *) ptr, value.lex);
+    else
+      LexAssign(ctx.G, *(lexidx_t *) ptr, value.str.c_str());
+  } else {
+    UtilNCopy(ptr, value.is_lex ? LexStr(ctx.G, value.lex) : value.str.c_str(),
+        ap->maxlen + 1);
+  }
+}
+
+/*
+ * Dependent fields, as with alter
+ */
+static void AlterExprSideEffects(const AtomPropertyInfo * ap, const AtomContext &ctx)
+{
+  AtomInfoType *ai = ctx.ai;
+
+  switch (ap->id) {
+  case ATOM_PROP_ELEM:
+    ai->protons = 0;
+    ai->vdw = 0;
+    AtomInfoAssignParameters(ctx.G, ai);
+    break;
+  case ATOM_PROP_RESV:
+    ai->inscode = '\0';
+    break;
+  case ATOM_PROP_SS:
+    ai->ssType[0] = toupper(ai->ssType[0]);
+    break;
+  case ATOM_PROP_FORMAL_CHARGE:
+    ai->chemFlag = false;
+    break;
+  }
+}
+
+int AlterExpr::apply(int sele, int state)
+{
+  PyMOLGlobals *G = m_G;
+
+  struct Item {
+    ObjectMolecule *obj;
+    int atm;
+    CoordSet *cs;
+    int idx;
+  };
+
+  std::vector<Item> items;
+
+  for(SeleAtomIterator iter(G, sele); iter.next();) {
+    ObjectMolecule *obj = iter.obj;
+    int atm = iter.getAtm();
+    CoordSet *cs = NULL;
+    int idx = -1;
+
+    if(m_coords) {
+      if(state >= obj->NCSet || !(cs = obj->CSet[state]) ||
+          (idx = cs->atmToIdx(atm)) < 0)
+        continue;
+    }
+
+    items.push_back({obj, atm, cs, idx});
+  }
+
+  if(items.empty())
+    return 0;
+
+  // objects whose states are being built in the background
+  ObjectMolecule *joined = NULL;
+  for(auto &item : items) {
+    if(item.obj != joined) {
+      joined = item.obj;
+      RepCacheJoinObject(G, joined);
+    }
+  }
+
+  SelectorInvalidateEvalCache(G);
+
+  int n_thread = SettingGetGlobal_i(G, cSetting_max_threads);
+  int n_chunk = m_serial ? 1 : pymol::parallel_chunk_count(n_thread, items.size());
+
+  pymol::parallel_for_chunks(n_chunk, items.size(),
+      [&](int, size_t begin, size_t end) {
+    std::vector<Number> numbers;
+    std::vector<StrValue> strings;
+
+    for(size_t a = begin; a < end; a++) {
+      const Item &item = items[a];
+      AtomContext ctx = {G, item.obj->AtomInfo + item.atm, item.atm,
+        item.cs, item.idx, state};
+
+      for(auto &assignment : m_assignments) {
+        size_t n = assignment.targets.size();
+        numbers.resize(n);
+        strings.resize(n);
+
+        // evaluate all right hand sides before assigning
+        for(size_t k = 0; k < n; k++) {
+          if(assignment.types[k] == tStr)
+            AlterExprRunStr(assignment.code[k], ctx, strings[k]);
+          else
+            AlterExprRun(assignment.code[k], ctx, numbers[k]);
+        }
+
+        for(size_t k = 0; k < n; k++) {
+          const AtomPropertyInfo *ap = assignment.targets[k];
+          if(assignment.types[k] == tStr) {
+            AlterExprStoreStr(ap, strings[k], ctx);
+            if(strings[k].is_lex)
+              LexDec(G, strings[k].lex);
+          } else {
+            AlterExprStore(ap, assignment.types[k], numbers[k], ctx);
+          }
+          AlterExprSideEffects(ap, ctx);
+        }
+      }
+    }
+  });
+
+  if(m_coords) {
+    // like OMOP_AlterState
+    ObjectMolecule *last = NULL;
+    for(auto &item : items) {
+      if(item.obj != last) {
+        last = item.obj;
+        ObjectMoleculeInvalidate(last, -1, cRepInvRep, -1);
+      }
+    }
+    SceneChanged(G);
+  }
+
+  return (int) items.size();
+}
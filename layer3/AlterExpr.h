@@ -0,0 +1,96 @@
+/*
+ * This file contains source code for the PyMOL computer program
+ * Copyright (c) Schrodinger, LLC.
+ *
+ * Native evaluation of simple "alter" and "alter_state" expressions.
+ *
+ * Expressions which only consist of assignments of arithmetic over atom
+ * properties and literals, e.g.
+ *
+ *   b = 0
+ *   b = q * 10; vdw = 1.5
+ *   chain = 'B'; segi = chain
+ *   (x, y, z) = (x + 1, y, z)
+ *   resv += 100
+ *
+ * are compiled into a small stack program and run over the selection
+ * without evaluating Python code per atom. Anything else (function calls,
+ * variables from the namespace, integer division, ...) is rejected by the
+ * compiler, and the caller falls back to the Python implementation.
+ */
+
+#ifndef _H_AlterExpr
+#define _H_AlterExpr
+
+#include <string>
+#include <vector>
+
+#include "PyMOLGlobals.h"
+#include "Lex.h"
+
+struct _P_AtomProperty;
+
+class AlterExpr {
+public:
+  enum ValueType { tInvalid, tInt, tFloat, tStr };
+
+  struct Instr {
+    int op;
+    const struct _P_AtomProperty *ap;
+    long long i;
+    double f;
+  };
+
+  struct Assignment {
+    std::vector<const struct _P_AtomProperty *> targets;
+    std::vector<std::vector<Instr> > code;      // one per target
+    std::vector<ValueType> types;               // result types
+  };
+
+  /*
+   * @param expr Python expression as passed to alter/alter_state
+   * @param coords true for alter_state (x, y, z and state available)
+   */
+  AlterExpr(PyMOLGlobals * G, const char *expr, bool coords);
+  ~AlterExpr();
+
+  bool isValid() const { return m_valid; }
+
+  /*
+   * Run the program for all atoms in `sele`. For alter_state, only atoms
+   * with coordinates in `state` are modified.
+   *
+   * @return number of modified atoms (alter) or atom states (alter_state)
+   */
+  int apply(int sele, int state = -1);
+
+private:
+  PyMOLGlobals *m_G;
+  bool m_coords;
+  bool m_valid;
+  bool m_serial;                // string or element assignments
+  std::vector<Assignment> m_assignments;
+  std::vector<lexidx_t> m_literals;
+
+  // parser state
+  struct Token {
+    int kind;
+    std::string text;
+    long long i;
+    double f;
+  };
+  std::vector<Token> m_tokens;
+  size_t m_pos;
+
+  bool tokenize(const char *expr);
+  bool accept(const char *op);
+  bool parseStatement();
+  bool parseTarget(std::vector<const struct _P_AtomProperty *> &targets);
+  ValueType parseExpr(std::vector<Instr> &code);
+  ValueType parseTerm(std::vector<Instr> &code);
+  ValueType parseFactor(std::vector<Instr> &code);
+  ValueType parseAtom(std::vector<Instr> &code);
+  ValueType emitLoad(const struct _P_AtomProperty *ap, std::vector<Instr> &code);
+};
+
+#endif
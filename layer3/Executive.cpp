@@ -21,6 +21,8 @@
 #include <set>
 #include <algorithm>
 #include <map>
+#include <memory>
+#include <unordered_map>
 #include <clocale>
 
 #include"Version.h"
@@ -87,6 +89,10 @@
 
 #include "MovieScene.h"
 #include "Texture.h"
+#include "Parallel.h"
+#include "AlterExpr.h"
+#include "RepCache.h"
+#include "os_numpy.h"
 
 #ifndef _PYMOL_NOPY
 #include "ce_types.h"
@@ -137,6 +143,12 @@ struct CExecutive : public Block {
   int all_names_list_id {}, all_obj_list_id {}, all_sel_list_id {};
   OVLexicon *Lex {};
   OVOneToOne *Key {};
+  // object -> record, and number of names per lowercase spelling, so that
+  // lookups don't need to walk Spec (maintained by ExecutiveAddKey/DelKey)
+  std::unordered_map<const CObject *, SpecRec *> ObjRec;
+  std::unordered_map<std::string, int> FoldedNames;
+  const CObject *LastManaged { nullptr }; // see ExecutiveManageObject
+  int ManageBatch { 0 }; // see ExecutiveManageObjectsBegin
   bool ValidGroups { false };
   bool ValidSceneMembers { false };
   int ValidGridSlots {};
@@ -147,6 +159,7 @@ struct CExecutive : public Block {
   int CaptureFlag {};
   int LastMotionCount {};
   CGO *selIndicatorsCGO { nullptr };
+  bool HasGridSlotSelIndicators { false }; // any rec->gridSlotSelIndicatorsCGO
   int selectorTexturePosX { 0 }, selectorTexturePosY { 0 }, selectorTextureAllocatedSize { 0 }, selectorTextureSize { 0 };
   short selectorIsRound { 0 };
 
@@ -1793,12 +1806,32 @@ static int get_op_cnt(PyMOLGlobals * G)
   return result;
 }
 
+static std::string ExecutiveFoldName(const char *name)
+{
+  WordType folded;
+  UtilNCopyToLower(folded, name, sizeof(WordType));
+  return folded;
+}
+
+/*
+ * Number of names which are equal to `name` when ignoring case. Zero means
+ * that case-insensitive lookups can't succeed without walking Spec.
+ */
+static int ExecutiveFoldedNameCount(CExecutive * I, const char *name)
+{
+  auto it = I->FoldedNames.find(ExecutiveFoldName(name));
+  return (it == I->FoldedNames.end()) ? 0 : it->second;
+}
+
 static int ExecutiveAddKey(CExecutive * I, SpecRec * rec)
 {
   int ok = false;
   OVreturn_word result;
+  if(rec->type == cExecObject)
+    I->ObjRec[rec->obj] = rec;
   if(OVreturn_IS_OK((result = OVLexicon_GetFromCString(I->Lex, rec->name)))) {
     if(OVreturn_IS_OK(OVOneToOne_Set(I->Key, result.word, rec->cand_id))) {
+      I->FoldedNames[ExecutiveFoldName(rec->name)]++;
       ok = true;
     }
   }
@@ -1809,15 +1842,37 @@ static int ExecutiveDelKey(CExecutive * I, SpecRec * rec)
 {
   int ok = false;
   OVreturn_word result;
+  if(rec->type == cExecObject)
+    I->ObjRec.erase(rec->obj);
   if(OVreturn_IS_OK((result = OVLexicon_BorrowFromCString(I->Lex, rec->name)))) {
     if(OVreturn_IS_OK(OVLexicon_DecRef(I->Lex, result.word)) &&
        OVreturn_IS_OK(OVOneToOne_DelForward(I->Key, result.word))) {
+      auto it = I->FoldedNames.find(ExecutiveFoldName(rec->name));
+      if(it != I->FoldedNames.end() && !--it->second)
+        I->FoldedNames.erase(it);
       ok = true;
     }
   }
   return ok;
 }
 
+/*
+ * Record with exactly this name (case-sensitive), or NULL
+ */
+static SpecRec *ExecutiveFindSpecExact(CExecutive * I, const char *name)
+{
+  SpecRec *rec = NULL;
+  OVreturn_word result;
+  if(OVreturn_IS_OK((result = OVLexicon_BorrowFromCString(I->Lex, name)))) {
+    if(OVreturn_IS_OK((result = OVOneToOne_GetForward(I->Key, result.word)))) {
+      if(!TrackerGetCandRef(I->Tracker, result.word, (TrackerRef **) (void *) &rec)) {
+        rec = NULL;
+      }
+    }
+  }
+  return rec;
+}
+
 static SpecRec *ExecutiveUnambiguousNameMatch(PyMOLGlobals * G, const char *name)
 {
   CExecutive *I = G->Executive;
@@ -2330,8 +2385,18 @@ static int ExecutiveGetUniqueIDAtomVLADict(PyMOLGlobals * G,
 {
   CExecutive *I = G->Executive;
   OVOneToOne *o2o = OVOneToOne_New(G->Context->heap);
-  ExecutiveObjectOffset *vla = VLAlloc(ExecutiveObjectOffset, 1000);
-  int n_oi = 0;
+  ExecutiveObjectOffset *vla;
+  int n_oi = 0, n_atom_total = 0;
+  {
+    SpecRec *rec = NULL;
+    while(ListIterate(I->Spec, rec, next)) {
+      if(rec->type == cExecObject && rec->obj->type == cObjectMolecule)
+        n_atom_total += ((ObjectMolecule *) rec->obj)->NAtom;
+    }
+  }
+  /* presize for one entry per atom, instead of growing on every insert */
+  OVOneToOne_Reserve(o2o, n_atom_total);
+  vla = VLAlloc(ExecutiveObjectOffset, n_atom_total + 1);
   {
     SpecRec *rec = NULL;
     while(ListIterate(I->Spec, rec, next)) {
@@ -3640,6 +3705,32 @@ int ExecutiveSetName(PyMOLGlobals * G, const char *old_name, const char *new_nam
 }
 
 
+/*
+ * File type dependent multiplex and discrete default
+ */
+static int ExecutiveLoadDefaultDiscrete(cLoadType_t content_format,
+    int discrete, int multiplex)
+{
+  if(discrete < 0) {
+    if(multiplex == 1) {
+      discrete = 0;
+    } else {
+      switch (content_format) {
+        case cLoadTypeMOL2:
+        case cLoadTypeMOL2Str:
+          discrete = -1;        /* content-dependent behavior... */
+        case cLoadTypeSDF2:     /* SDF files currently default to discrete */
+        case cLoadTypeSDF2Str:
+          break;
+        default:
+          discrete = 0;
+          break;
+      }
+    }
+  }
+  return discrete;
+}
+
 /*
  * Load any file type which is implemented in C.
  *
@@ -3788,24 +3879,7 @@ int ExecutiveLoad(PyMOLGlobals * G,
 #ifndef _PYMOL_NO_UNDO
 #endif
 
-  // file type dependent multiplex and discrete default
-  if(discrete < 0) {
-    if(multiplex == 1) {
-      discrete = 0;
-    } else {
-      switch (content_format) {
-        case cLoadTypeMOL2:
-        case cLoadTypeMOL2Str:
-          discrete = -1;        /* content-dependent behavior... */
-        case cLoadTypeSDF2:     /* SDF files currently default to discrete */
-        case cLoadTypeSDF2Str:
-          break;
-        default:
-          discrete = 0;
-          break;
-      }
-    }
-  }
+  discrete = ExecutiveLoadDefaultDiscrete(content_format, discrete, multiplex);
 
   // downstream file type reading functions
   switch (content_format) {
@@ -4004,6 +4078,302 @@ int ExecutiveLoad(PyMOLGlobals * G,
 
 }
 
+namespace {
+/*
+ * Per-file state of ExecutiveLoadBatch
+ */
+struct LoadBatchItem {
+  const ExecutiveLoadBatchEntry *entry;
+  int discrete;
+  bool serial;                  // load with ExecutiveLoad on the main thread
+  std::vector<std::pair<ObjectMolecule *, std::string>> objs;   // (multiplex name)
+  std::shared_ptr<cif_file> cif;
+  std::string output;           // captured feedback
+};
+}
+
+/*
+ * String type which the "load" command reads this file type as (see
+ * _load2str in constants.py), or -1 if it passes the file name.
+ * load_batch does the same, so the feedback matches a "load" loop.
+ */
+static int ExecutiveLoadBatchStrFormat(cLoadType_t format)
+{
+  switch (format) {
+  case cLoadTypePDB:
+    return cLoadTypePDBStr;
+  case cLoadTypeCIF:
+    return cLoadTypeCIFStr;
+  case cLoadTypeMOL:
+    return cLoadTypeMOLStr;
+  case cLoadTypeMOL2:
+    return cLoadTypeMOL2Str;
+  case cLoadTypeSDF2:
+    return cLoadTypeSDF2Str;
+  case cLoadTypeXYZ:
+    return cLoadTypeXYZStr;
+  case cLoadTypeMMD:
+    return cLoadTypeMMDStr;
+  default:
+    return -1;
+  }
+}
+
+/*
+ * Parse one file into detached objects. Runs on a worker thread.
+ */
+static void ExecutiveLoadBatchParse(PyMOLGlobals * G, LoadBatchItem & item,
+    int state, int multiplex, int quiet)
+{
+  pymol::DetachedScope scope;
+  const char *fname = item.entry->filename.c_str();
+  char *buffer = FileGetContents(fname, NULL);
+
+  if(!buffer) {
+    item.serial = true;         /* ExecutiveLoad reports the error */
+    return;
+  }
+
+  switch (item.entry->format) {
+  case cLoadTypePDB:
+  case cLoadTypePQR:
+  case cLoadTypePDBQT:
+    {
+      PDBInfoRec pdb_info;
+      M4XAnnoType m4x;
+      char pdb_name[WordLength] = "";
+      const char *next_pdb = NULL;
+      int model_number = 0;
+
+      UtilZeroMem(&pdb_info, sizeof(PDBInfoRec));
+      pdb_info.multiplex = multiplex;
+      pdb_info.variant =
+        item.entry->format == cLoadTypePQR ? PDB_VARIANT_PQR :
+        item.entry->format == cLoadTypePDBQT ? PDB_VARIANT_PDBQT :
+        PDB_VARIANT_DEFAULT;
+
+      M4XAnnoInit(&m4x);
+      ObjectMolecule *obj = ObjectMoleculeReadPDBStr(G, NULL, buffer, state,
+          item.discrete, &m4x, pdb_name, &next_pdb, &pdb_info, quiet, &model_number);
+
+      if(obj && (next_pdb || m4x.annotated_flag || m4x.xname_flag)) {
+        /* multiple entries or Metaphorics annotations */
+        ObjectMoleculeFree(obj);
+        item.serial = true;
+      } else if(obj) {
+        item.objs.emplace_back(obj, "");
+      }
+      M4XAnnoPurge(&m4x);
+    }
+    break;
+  case cLoadTypeCIF:
+    item.cif = std::make_shared<cif_file>(nullptr, buffer);
+    break;
+  default:
+    {
+      const char *next_entry = buffer;
+      char new_name[WordLength] = "";
+      do {
+        ObjectMolecule *obj = ObjectMoleculeReadStr(G, NULL, &next_entry,
+            item.entry->format, state, item.discrete, quiet, multiplex,
+            new_name, false, NULL);
+        if(!obj)
+          break;
+        item.objs.emplace_back(obj, new_name);
+        new_name[0] = 0;
+      } while(next_entry);
+    }
+  }
+
+  mfree(buffer);
+
+  if(!item.serial)
+    item.output = std::move(scope.output);
+}
+
+/*
+ * Load many molecular files at once. Files are read and parsed into
+ * detached objects on up to "max_threads" threads, then registered with
+ * the Executive in input order on the calling thread.
+ *
+ * Supported formats: PDB, PQR, PDBQT, CIF, MOL, MOL2, SDF, XYZ, MMD. Other
+ * formats, and files which append to an existing object, are loaded with
+ * ExecutiveLoad (also in input order).
+ *
+ * state, zoom, discrete, multiplex, quiet: see ExecutiveLoad
+ */
+int ExecutiveLoadBatch(PyMOLGlobals * G,
+                       const std::vector<ExecutiveLoadBatchEntry> & entries,
+                       int state, int zoom, int discrete, int multiplex,
+                       int quiet)
+{
+  int ok = true;
+  CObject *last_obj = NULL;
+  std::set<std::string> names;
+  std::vector<LoadBatchItem> items(entries.size());
+
+  // see ExecutiveLoad
+  std::setlocale(LC_NUMERIC, "C");
+
+  if(multiplex == -2) {
+    multiplex = SettingGetGlobal_i(G, cSetting_multiplex);
+  }
+
+  for(size_t i = 0; i < entries.size(); ++i) {
+    auto & item = items[i];
+    const char *name = entries[i].object_name.c_str();
+    item.entry = &entries[i];
+    item.discrete = ExecutiveLoadDefaultDiscrete(item.entry->format, discrete, multiplex);
+
+    switch (item.entry->format) {
+    case cLoadTypePDB:
+    case cLoadTypePQR:
+    case cLoadTypePDBQT:
+    case cLoadTypeMOL:
+    case cLoadTypeMOL2:
+    case cLoadTypeSDF2:
+    case cLoadTypeXYZ:
+    case cLoadTypeMMD:
+      item.serial = false;
+      break;
+    case cLoadTypeCIF:
+      item.serial = (multiplex > 0);    /* error from ExecutiveLoad */
+      break;
+    default:
+      item.serial = true;
+    }
+
+    // appending to an existing object (multiplex=1 always creates new ones)
+    if(multiplex != 1) {
+      if(!names.insert(name).second || ExecutiveFindObjectByName(G, name))
+        item.serial = true;
+    }
+  }
+
+  pymol::parallel_for(SettingGetGlobal_i(G, cSetting_max_threads),
+      (int) items.size(), [&](int i) {
+        if(!items[i].serial)
+          ExecutiveLoadBatchParse(G, items[i], state, multiplex, quiet);
+      });
+
+  // register in input order
+  int base_color = AtomInfoGetCarbonColor(G);
+
+  SelectorInvalidateEvalCache(G);
+  ExecutiveManageObjectsBegin(G);
+
+  for(auto & item : items) {
+    const char *fname = item.entry->filename.c_str();
+    ObjectNameType object_name = "";
+
+    if(!item.serial) {
+      ExecutiveProcessObjectName(G, item.entry->object_name.c_str(), object_name);
+
+      // an earlier entry may have taken the name
+      if(multiplex != 1 && ExecutiveFindObjectByName(G, object_name)) {
+        for(auto & p : item.objs)
+          ObjectMoleculeFree(p.first);
+        item.objs.clear();
+        item.cif.reset();
+        item.serial = true;
+      }
+    }
+
+    if(item.serial) {
+      // zoom is deferred to the last new object, unless something else
+      // gets loaded in between
+      if(last_obj) {
+        ExecutiveDoZoom(G, last_obj, true, zoom, true);
+        last_obj = NULL;
+      }
+      int str_format = ExecutiveLoadBatchStrFormat(item.entry->format);
+      long size = 0;
+      char *buffer = (str_format < 0) ? NULL : FileGetContents(fname, &size);
+      if(buffer) {
+        ok &= ExecutiveLoad(G, buffer, size, (cLoadType_t) str_format,
+            item.entry->object_name.c_str(), state, zoom, discrete, true,
+            multiplex, quiet, NULL);
+        mfree(buffer);
+      } else {
+        ok &= ExecutiveLoad(G, fname, 0, item.entry->format,
+            item.entry->object_name.c_str(), state, zoom, discrete, true,
+            multiplex, quiet, NULL);
+      }
+      continue;
+    }
+
+    if(!item.output.empty())
+      FeedbackAdd(G, item.output.c_str());
+
+    if(item.cif) {
+      // may register (multiplexed) objects by itself
+      if(last_obj) {
+        ExecutiveDoZoom(G, last_obj, true, zoom, true);
+        last_obj = NULL;
+      }
+      CObject *obj = (CObject *) ObjectMoleculeReadCif(G, NULL, item.cif,
+          state, item.discrete, quiet, multiplex, 0);
+      item.cif.reset();
+      if(obj)
+        item.objs.emplace_back((ObjectMolecule *) obj, "");
+    } else {
+      /* auto colors were deferred during parsing */
+      for(auto & p : item.objs) {
+        ObjectMolecule *obj = p.first;
+        int color = AtomInfoUpdateAutoColor(G);
+        if(color != base_color) {
+          for(int a = 0; a < obj->NAtom; ++a) {
+            AtomInfoType *ai = obj->AtomInfo + a;
+            if(ai->protons == cAN_C && ai->color == base_color)
+              ai->color = color;
+          }
+        }
+        obj->Obj.Color = color;
+      }
+    }
+
+    for(auto & p : item.objs) {
+      CObject *obj = (CObject *) p.first;
+      if(!p.second.empty()) {
+        // multiplexing
+        ObjectSetName(obj, p.second.c_str());
+        ExecutiveDelete(G, obj->Name);
+      } else {
+        ObjectSetName(obj, object_name);
+      }
+      ExecutiveManageObject(G, obj, 0, true);
+      last_obj = obj;
+    }
+
+    if(!quiet && item.objs.size() == 1 && item.objs[0].second.empty()) {
+      ObjectMolecule *obj = item.objs[0].first;
+      switch (ExecutiveLoadBatchStrFormat(item.entry->format)) {
+      case -1:
+        PRINTFB(G, FB_Executive, FB_Actions)
+          " CmdLoad: \"%s\" loaded as \"%s\".\n", fname, object_name ENDFB(G);
+        break;
+      case cLoadTypePDBStr:
+        PRINTFB(G, FB_Executive, FB_Actions)
+          " CmdLoad: PDB-string loaded into object \"%s\", state %d.\n",
+          object_name, (state < 0) ? obj->NCSet : state + 1 ENDFB(G);
+        break;
+      default:
+        PRINTFB(G, FB_Executive, FB_Actions)
+          " CmdLoad: loaded as \"%s\".\n", object_name ENDFB(G);
+      }
+    }
+  }
+
+  ExecutiveUniqueIDAtomDictInvalidate(G);
+  ExecutiveManageObjectsEnd(G);
+
+  if(last_obj) {
+    ExecutiveDoZoom(G, last_obj, true, zoom, true);
+  }
+
+  return ok;
+}
+
 /* ExecutiveGetExistingCompatible
  *
  * PARAMS
@@ -4495,6 +4865,113 @@ int ExecutiveAssignSS(PyMOLGlobals * G, const char *target, int state, const cha
 
 static int * getRepArrayFromBitmask(int visRep);
 
+static size_t VLABytes(const void *vla)
+{
+  return vla ? VLAGetByteSize(vla) : 0;
+}
+
+static size_t CGOBytes(const CGO * cgo)
+{
+  return cgo ? VLABytes(cgo->op) : 0;
+}
+
+static size_t FieldBytes(const CField * field)
+{
+  return field ? field->size : 0;
+}
+
+/*
+ * Memory usage report: process wide totals per memory tag (see
+ * MemoryGetUsage), a per-object breakdown and the movie image cache.
+ * Object sizes are computed by walking the objects, which is cheap
+ * compared to the allocations themselves.
+ *
+ * {"tags": {tag: (bytes, count)},
+ *  "objects": {name: {"atoms": bytes, "coords": bytes, "reps": bytes,
+ *                     "cgo": bytes, "fields": bytes}},
+ *  "movie": bytes, "rep_cache": bytes}
+ */
+PyObject *ExecutiveGetMemoryReport(PyMOLGlobals * G)
+{
+  CExecutive *I = G->Executive;
+  SpecRec *rec = NULL;
+  long long bytes[cMemoryTagCount], counts[cMemoryTagCount];
+  RepCacheStats stats;
+
+  /* sizes of representations which are being built in the background */
+  RepCacheJoin(G);
+
+  PyObject *tags = PyDict_New();
+  MemoryGetUsage(bytes, counts);
+  for(int a = 0; a < cMemoryTagCount; a++) {
+    PyObject *item = Py_BuildValue("(LL)", bytes[a], counts[a]);
+    PyDict_SetItemString(tags, MemoryTagName(a), item);
+    Py_DECREF(item);
+  }
+
+  PyObject *objects = PyDict_New();
+  while(ListIterate(I->Spec, rec, next)) {
+    if(rec->type != cExecObject)
+      continue;
+
+    size_t atoms = 0, coords = 0, reps = 0, cgo = 0, fields = 0;
+
+    switch (rec->obj->type) {
+    case cObjectMolecule:
+      {
+        auto obj = (ObjectMolecule *) rec->obj;
+        atoms = VLABytes(obj->AtomInfo) + VLABytes(obj->Bond);
+        for(int a = -1; a < obj->NCSet; a++) {
+          CoordSet *cs = (a < 0) ? obj->CSTmpl : obj->CSet[a];
+          if(!cs)
+            continue;
+          coords += sizeof(CoordSet) + VLABytes(cs->Coord) +
+            VLABytes(cs->IdxToAtm) + VLABytes(cs->AtmToIdx);
+          reps += RepCacheCoordSetSize(cs);
+        }
+      }
+      break;
+    case cObjectMap:
+      {
+        auto obj = (ObjectMap *) rec->obj;
+        for(int a = 0; a < obj->NState; a++) {
+          Isofield *field = obj->State[a].Field;
+          if(field)
+            fields += FieldBytes(field->data) + FieldBytes(field->points) +
+              FieldBytes(field->gradients);
+          cgo += CGOBytes(obj->State[a].shaderCGO);
+        }
+      }
+      break;
+    case cObjectCGO:
+      {
+        auto obj = (ObjectCGO *) rec->obj;
+        for(int a = 0; a < obj->NState; a++) {
+          cgo += CGOBytes(obj->State[a].origCGO) + CGOBytes(obj->State[a].renderCGO);
+        }
+      }
+      break;
+    }
+
+    PyObject *item = Py_BuildValue("{s:K,s:K,s:K,s:K,s:K}",
+        "atoms", (unsigned long long) atoms,
+        "coords", (unsigned long long) coords,
+        "reps", (unsigned long long) reps,
+        "cgo", (unsigned long long) cgo,
+        "fields", (unsigned long long) fields);
+    PyDict_SetItemString(objects, rec->name, item);
+    Py_DECREF(item);
+  }
+
+  RepCacheGetStats(G, &stats);
+
+  return Py_BuildValue("{s:N,s:N,s:K,s:K}",
+      "tags", tags,
+      "objects", objects,
+      "movie", (unsigned long long) MovieGetImageBytes(G),
+      "rep_cache", (unsigned long long) stats.bytes);
+}
+
 PyObject *ExecutiveGetVisAsPyDict(PyMOLGlobals * G)
 {
   PyObject *result = NULL, *list;
@@ -5014,19 +5491,15 @@ const char **ExecutiveGetChains(PyMOLGlobals * G, const char *sele, int state)
 
 int ExecutiveValidateObjectPtr(PyMOLGlobals * G, CObject * ptr, int object_type)
 {
-  /* this routine needs to be sped up significantly... */
-
   CExecutive *I = G->Executive;
   int ok = false;
-  SpecRec *rec = NULL;
+  auto it = I->ObjRec.find(ptr);
 
-  while(ListIterate(I->Spec, rec, next)) {
-    if(rec->obj == ptr) {
-      if(rec->type == cExecObject) {
-        if((!object_type) || (rec->obj->type == object_type)) {
-          ok = true;
-          break;
-        }
+  if(it != I->ObjRec.end()) {
+    SpecRec *rec = it->second;
+    if(rec->type == cExecObject) {
+      if((!object_type) || (rec->obj->type == object_type)) {
+        ok = true;
       }
     }
   }
@@ -8166,11 +8639,188 @@ int ExecutiveAlign(PyMOLGlobals * G, const char *s1, const char *s2, const char
           " ExecutiveAlign: invalid selections for alignment.\n" ENDFB(G);
       }
     }
-    ExecutiveUpdateCoordDepends(G, mobile_obj); //Updates dynamic_measures - see PYMOL-3090
+    ExecutiveUpdateCoordDepends(G, mobile_obj); //Updates dynamic_measures - see PYMOL-3090
+  }
+
+  VLAFreeP(vla1);
+  VLAFreeP(vla2);
+  return ok;
+}
+
+/*
+ * All-against-all "align" without superposition (transform=0) and without
+ * alignment objects. For each ordered pair (mobile i, target j), i != j,
+ * fills the row-major n x n result matrices with the RMSD after outlier
+ * rejection, the number of atoms in the final fit and the raw alignment
+ * score. Pairs which fail to align get an RMSD of -1.
+ *
+ * The residue alignments (scoring and dynamic program) of all pairs run
+ * on up to "max_threads" threads, the atom matching and refinement are
+ * serial. Results are identical to calling ExecutiveAlign for each pair.
+ *
+ * seles: names of existing selections, each from a single object
+ */
+int ExecutiveAlignMatrix(PyMOLGlobals * G, const std::vector<std::string> & seles,
+                         const char *mat_file, float gap, float extend,
+                         int max_gap, int max_skip, float cutoff, int cycles,
+                         int quiet, int state, float seq_wt, float radius,
+                         float scale, float base, float coord_wt, float expect,
+                         int window, float ante, std::vector<float> & rms,
+                         std::vector<int> & n_atom, std::vector<float> & score)
+{
+  int n = seles.size();
+  int use_sequence = (mat_file && mat_file[0] && (seq_wt != 0.0F));
+  int use_structure = (seq_wt >= 0.0F); /* negative seq_wt means sequence only! */
+  int ok = true;
+  std::vector<int> sele(n);
+  std::vector<ObjectMolecule *> obj(n);
+  std::vector<int *> vla(n);
+  CMatch *smat_match = NULL;
+
+  struct PairRec {
+    int i, j;
+    int *vla2;                  /* target residues, if obj[i] == obj[j] */
+    int *pair;
+    int n_pair;
+    float score;
+  };
+  std::vector<PairRec> pairs;
+
+  if(!use_structure)
+    window = 0;
+
+  if((scale == 0.0F) && (seq_wt == 0.0F) && (ante < 0.0F) && window)
+    ante = window;
+
+  if(ante < 0.0F)
+    ante = 0.0F;
+
+  rms.assign(n * n, 0.0F);
+  n_atom.assign(n * n, 0);
+  score.assign(n * n, 0.0F);
+
+  for(int i = 0; ok && i < n; i++) {
+    sele[i] = SelectorIndexByName(G, seles[i].c_str());
+    if(sele[i] >= 0)
+      obj[i] = SelectorGetSingleObjectMolecule(G, sele[i]);
+    if(!obj[i]) {
+      PRINTFB(G, FB_Executive, FB_Errors)
+        " ExecutiveAlignMatrix: each selection must derive from one object only.\n"
+        ENDFB(G);
+      ok = false;
+    }
+  }
+
+  /* substitution matrix, read once */
+  if(ok && use_sequence) {
+    smat_match = MatchNew(G, 1, 1, false);
+    ok = smat_match && MatchMatrixFromFile(smat_match, mat_file, quiet);
+  }
+
+  /* residues of each selection, computed once */
+  for(int i = 0; ok && i < n; i++) {
+    vla[i] = SelectorGetResidueVLA(G, sele[i], use_structure, NULL);
+    ok = (vla[i] != NULL);
+    if(ok && use_sequence)
+      ok = MatchResidueToCode(smat_match, vla[i], VLAGetSize(vla[i]) / 3);
+    if(ok && use_structure)
+      ObjectMoleculeUpdateNeighbors(obj[i]);
+  }
+
+  for(int i = 0; ok && i < n; i++) {
+    for(int j = 0; j < n; j++) {
+      if(i == j)
+        continue;
+
+      PairRec rec = { i, j, NULL, NULL, 0, 0.0F };
+
+      /* like ExecutiveAlign, exclude the mobile object from the target */
+      if(obj[j] == obj[i]) {
+        rec.vla2 = SelectorGetResidueVLA(G, sele[j], use_structure, obj[i]);
+        if(rec.vla2 && use_sequence)
+          MatchResidueToCode(smat_match, rec.vla2, VLAGetSize(rec.vla2) / 3);
+      }
+
+      pairs.push_back(rec);
+    }
   }
 
-  VLAFreeP(vla1);
-  VLAFreeP(vla2);
+  if(ok) {
+    pymol::parallel_for(SettingGetGlobal_i(G, cSetting_max_threads), pairs.size(),
+        [&](int p) {
+      PairRec & rec = pairs[p];
+      int *vla1 = vla[rec.i];
+      int *vla2 = (obj[rec.i] == obj[rec.j]) ? rec.vla2 : vla[rec.j];
+      int na = VLAGetSize(vla1) / 3;
+      int nb = vla2 ? VLAGetSize(vla2) / 3 : 0;
+      int pair_ok = true;
+
+      if(!(na && nb))
+        return;
+
+      CMatch *match = MatchNew(G, na, nb, window);
+      if(!match)
+        return;
+
+      if(use_sequence) {
+        for(int a = 0; a < 128; a++)
+          memcpy(match->smat[a], smat_match->smat[a], 128 * sizeof(float));
+        MatchPreScore(match, vla1, na, vla2, nb, true);
+      }
+      if(use_structure) {
+        /* avoid degenerate alignments */
+        pair_ok = (na > 1) && (nb > 1) &&
+          SelectorResidueVLAsTo3DMatchScores(G, match,
+                                             vla1, na, state,
+                                             vla2, nb, state, seq_wt,
+                                             radius, scale, base,
+                                             coord_wt, expect);
+      }
+      if(pair_ok && MatchAlign(match, gap, extend, max_gap, max_skip, true, window, ante)) {
+        rec.score = match->score;
+        rec.n_pair = match->n_pair;
+        rec.pair = match->pair;
+        match->pair = NULL;
+      }
+      MatchFree(match);
+    });
+  }
+
+  /* atom matching and refinement */
+  for(auto & rec : pairs) {
+    int *vla2 = (obj[rec.i] == obj[rec.j]) ? rec.vla2 : vla[rec.j];
+    int k = rec.i * n + rec.j;
+
+    rms[k] = -1.0F;
+    score[k] = rec.score;
+
+    if(rec.pair &&
+       SelectorCreateAlignments(G, rec.pair, sele[rec.i], vla[rec.i],
+                                sele[rec.j], vla2, "_align1", "_align2",
+                                false, false)) {
+      ExecutiveRMSInfo rms_info;
+      if(ExecutiveRMS(G, "_align1", "_align2", 1, cutoff, cycles,
+                      true, "", state, state, false, 0, &rms_info)) {
+        rms[k] = rms_info.final_rms;
+        n_atom[k] = rms_info.final_n_atom;
+      }
+    }
+
+    if(!quiet) {
+      PRINTFB(G, FB_Executive, FB_Results)
+        " ExecutiveAlignMatrix: %s vs %s: RMSD = %8.3f (%d atoms)\n",
+        obj[rec.i]->Obj.Name, obj[rec.j]->Obj.Name, rms[k], n_atom[k] ENDFB(G);
+    }
+
+    VLAFreeP(rec.pair);
+    VLAFreeP(rec.vla2);
+  }
+
+  if(smat_match)
+    MatchFree(smat_match);
+  for(int i = 0; i < n; i++)
+    VLAFreeP(vla[i]);
+
   return ok;
 }
 
@@ -8498,10 +9148,12 @@ const char *ExecutiveGetTitle(PyMOLGlobals * G, const char *name, int state)
 void ExecutiveHideSelections(PyMOLGlobals * G)
 {
   CExecutive *I = G->Executive;
+  CTracker *I_Tracker = I->Tracker;
   SpecRec *rec = NULL;
+  int iter_id = TrackerNewIter(I_Tracker, 0, I->all_sel_list_id);
 
-  while(ListIterate(I->Spec, rec, next)) {
-    if(rec->type == cExecSelection) {
+  while(TrackerIterNextCandInList(I_Tracker, iter_id, (TrackerRef **) (void *) &rec)) {
+    if(rec && rec->type == cExecSelection) {
       if(rec->visible) {
         rec->visible = false;
         SceneInvalidate(G);
@@ -8510,6 +9162,7 @@ void ExecutiveHideSelections(PyMOLGlobals * G)
       }
     }
   }
+  TrackerDelIter(I_Tracker, iter_id);
 }
 
 void ExecutiveInvalidateSelectionIndicators(PyMOLGlobals *G){
@@ -8526,9 +9179,12 @@ void ExecutiveInvalidateSelectionIndicatorsCGO(PyMOLGlobals *G){
       CGOFree(I->selIndicatorsCGO);
       I->selIndicatorsCGO = 0;
     }
-    while(ListIterate(I->Spec, rec, next)) {
-      if(rec->type == cExecObject) {
+    if (I->HasGridSlotSelIndicators){
+      I->HasGridSlotSelIndicators = false;
+      while(ListIterate(I->Spec, rec, next)) {
+        if(rec->type == cExecObject) {
 	  CGOFree(rec->gridSlotSelIndicatorsCGO);	  
+        }
       }
     }
   }
@@ -8877,6 +9533,7 @@ void ExecutiveRenderSelections(PyMOLGlobals * G, int curState, int slot, GridInf
 						     vis_only, NULL);
 			  } else {
 			    CGO *drawArrayCGO = NULL;
+			    I->HasGridSlotSelIndicators = true;
 			    rec1->gridSlotSelIndicatorsCGO = CGONew(G);
 			    CGODotwidth(rec1->gridSlotSelIndicatorsCGO, gl_width);
 			    CGOBegin(rec1->gridSlotSelIndicatorsCGO, GL_POINTS);
@@ -9044,6 +9701,239 @@ int ExecutiveGetDihe(PyMOLGlobals * G, const char *s0, const char *s1, const cha
 }
 
 
+/*========================================================================*/
+/*
+ * Trajectory analysis: per-state measurements over the states
+ * [first, last] (0-based, last < 0 means the last state of the longest
+ * object). Selections are resolved once, states are processed on up to
+ * "max_threads" threads. Single-state objects are treated as static.
+ * Values which can't be computed (atom missing in a state) are NaN.
+ */
+struct TrajAtom {
+  ObjectMolecule *obj;
+  int atm;
+};
+
+/* coordinate set of `obj` for `state`, or NULL */
+static const CoordSet *TrajGetCoordSet(const ObjectMolecule * obj, int state)
+{
+  if(obj->NCSet == 1)
+    return obj->CSet[0];
+  if(state < obj->NCSet)
+    return obj->CSet[state];
+  return NULL;
+}
+
+static bool TrajGetVertex(const TrajAtom & atom, int state, float *v)
+{
+  CoordSet *cs = (CoordSet *) TrajGetCoordSet(atom.obj, state);
+  return cs && CoordSetGetAtomTxfVertex(cs, atom.atm, v);
+}
+
+/* clamps [first, last] to the states of `atoms`, returns the number of states */
+static int TrajGetStateRange(const std::vector<TrajAtom> & atoms, int &first, int &last)
+{
+  int n_state = 0;
+  for(auto & atom : atoms)
+    if(n_state < atom.obj->NCSet)
+      n_state = atom.obj->NCSet;
+  if(first < 0)
+    first = 0;
+  if(last < 0 || last >= n_state)
+    last = n_state - 1;
+  return (last < first) ? 0 : (last - first + 1);
+}
+
+static std::vector<TrajAtom> TrajGetAtoms(PyMOLGlobals * G, const char *s1)
+{
+  std::vector<TrajAtom> atoms;
+  for(SeleAtomIterator iter(G, s1); iter.next();)
+    atoms.push_back({iter.obj, iter.getAtm()});
+  return atoms;
+}
+
+/* 1-D array, or 2-D array with `n_col` columns if n_col > 0 */
+static PyObject *TrajAsNumPy(const std::vector<float> & values, int n_col = 0)
+{
+#ifndef _PYMOL_NUMPY
+  return PConvToPyObject(values);
+#else
+  import_array1(NULL);
+
+  npy_intp dims[2] = { (npy_intp) values.size(), n_col };
+  if(n_col > 0)
+    dims[0] /= n_col;
+  PyObject *result = PyArray_SimpleNew((n_col > 0) ? 2 : 1, dims, NPY_FLOAT32);
+  if(result && !values.empty())
+    memcpy(PyArray_DATA((PyArrayObject *) result), values.data(),
+           values.size() * sizeof(float));
+  return result;
+#endif
+}
+
+/*
+ * Distance (2 selections), angle (3) or dihedral (4) in every state,
+ * like cmd.get_distance, cmd.get_angle and cmd.get_dihedral.
+ */
+PyObject *ExecutiveGetGeometrySeries(PyMOLGlobals * G,
+                                     const std::vector<std::string> & seles,
+                                     int first, int last)
+{
+  std::vector<TrajAtom> atoms;
+  std::vector<float> values;
+
+  if(seles.size() < 2 || seles.size() > 4) {
+    ErrMessage(G, "GetGeometrySeries", "Need 2, 3 or 4 selections.");
+    return NULL;
+  }
+
+  for(auto & sele : seles) {
+    SelectorTmp tmpsele(G, sele.c_str());
+    TrajAtom atom;
+    if(tmpsele.getIndex() < 0 ||
+       !SelectorGetSingleAtomObjectIndex(G, tmpsele.getIndex(), &atom.obj, &atom.atm)) {
+      PRINTFB(G, FB_Executive, FB_Errors)
+        " GetGeometrySeries-Error: Selection %d doesn't contain a single atom.\n",
+        (int) atoms.size() + 1 ENDFB(G);
+      return NULL;
+    }
+    atoms.push_back(atom);
+  }
+
+  values.resize(TrajGetStateRange(atoms, first, last));
+
+  pymol::parallel_for(SettingGetGlobal_i(G, cSetting_max_threads), values.size(),
+      [&](int i) {
+    float v[4][3], d1[3], d2[3];
+    float value = NAN;
+
+    for(size_t a = 0; a < atoms.size(); a++) {
+      if(!TrajGetVertex(atoms[a], first + i, v[a])) {
+        values[i] = value;
+        return;
+      }
+    }
+
+    switch (atoms.size()) {
+    case 2:
+      value = (float) diff3f(v[0], v[1]);
+      break;
+    case 3:
+      subtract3f(v[0], v[1], d1);
+      subtract3f(v[2], v[1], d2);
+      value = rad_to_deg(get_angle3f(d1, d2));
+      break;
+    case 4:
+      value = rad_to_deg(get_dihedral3f(v[0], v[1], v[2], v[3]));
+      break;
+    }
+
+    values[i] = value;
+  });
+
+  return TrajAsNumPy(values);
+}
+
+/*
+ * Radius of gyration (not mass weighted) of the selection in every state
+ */
+PyObject *ExecutiveGetGyrationSeries(PyMOLGlobals * G, const char *s1,
+                                     int first, int last)
+{
+  std::vector<TrajAtom> atoms = TrajGetAtoms(G, s1);
+  std::vector<float> values(TrajGetStateRange(atoms, first, last));
+
+  pymol::parallel_for(SettingGetGlobal_i(G, cSetting_max_threads), values.size(),
+      [&](int i) {
+    std::vector<float> coords;
+    double com[3] = { 0.0, 0.0, 0.0 }, sum = 0.0;
+    float v[3];
+
+    coords.reserve(atoms.size() * 3);
+
+    for(auto & atom : atoms) {
+      if(TrajGetVertex(atom, first + i, v)) {
+        coords.insert(coords.end(), v, v + 3);
+        for(int d = 0; d < 3; d++)
+          com[d] += v[d];
+      }
+    }
+
+    size_t n = coords.size() / 3;
+    if(!n) {
+      values[i] = NAN;
+      return;
+    }
+
+    for(int d = 0; d < 3; d++)
+      com[d] /= n;
+
+    for(size_t j = 0; j < coords.size(); j += 3) {
+      for(int d = 0; d < 3; d++) {
+        double dv = coords[j + d] - com[d];
+        sum += dv * dv;
+      }
+    }
+
+    values[i] = (float) sqrt(sum / n);
+  });
+
+  return TrajAsNumPy(values);
+}
+
+/*
+ * Root mean square fluctuation of every selected atom about its mean
+ * position over the states. No fitting is done, use intra_fit first.
+ */
+PyObject *ExecutiveGetRMSF(PyMOLGlobals * G, const char *s1, int first, int last)
+{
+  std::vector<TrajAtom> atoms = TrajGetAtoms(G, s1);
+  std::vector<float> values(atoms.size());
+  int n_state = TrajGetStateRange(atoms, first, last);
+
+  pymol::parallel_for_chunks(
+      pymol::parallel_chunk_count(SettingGetGlobal_i(G, cSetting_max_threads),
+                                  atoms.size() * n_state, 4096),
+      atoms.size(), [&](int, size_t begin, size_t end) {
+    std::vector<float> coords;
+    float v[3];
+
+    for(size_t a = begin; a < end; a++) {
+      double mean[3] = { 0.0, 0.0, 0.0 }, sum = 0.0;
+
+      coords.clear();
+      for(int state = first; state < first + n_state; state++) {
+        if(TrajGetVertex(atoms[a], state, v)) {
+          coords.insert(coords.end(), v, v + 3);
+          for(int d = 0; d < 3; d++)
+            mean[d] += v[d];
+        }
+      }
+
+      size_t n = coords.size() / 3;
+      if(!n) {
+        values[a] = NAN;
+        continue;
+      }
+
+      for(int d = 0; d < 3; d++)
+        mean[d] /= n;
+
+      for(size_t j = 0; j < coords.size(); j += 3) {
+        for(int d = 0; d < 3; d++) {
+          double dv = coords[j + d] - mean[d];
+          sum += dv * dv;
+        }
+      }
+
+      values[a] = (float) sqrt(sum / n);
+    }
+  });
+
+  return TrajAsNumPy(values);
+}
+
+
 /*========================================================================*/
 int ExecutiveSetDihe(PyMOLGlobals * G, const char *s0, const char *s1, const char *s2, const char *s3,
                      float value, int state, int quiet)
@@ -9110,15 +10000,9 @@ int ExecutiveSetDihe(PyMOLGlobals * G, const char *s0, const char *s1, const cha
 float ExecutiveGetArea(PyMOLGlobals * G, const char *s0, int sta0, int load_b)
 {
   ObjectMolecule *obj0;
-  RepDot *rep;
   CoordSet *cs;
   float result = -1.0F;
-  int a, sele0;
-  int known_member = -1;
-  int is_member;
-  int *ati;
-  float *area;
-  AtomInfoType *ai = NULL;
+  int sele0;
   ObjectMoleculeOpRec op;
 
   SelectorTmp tmpsele0(G, s0);
@@ -9138,9 +10022,12 @@ float ExecutiveGetArea(PyMOLGlobals * G, const char *s0, int sta0, int load_b)
       if(!cs)
         ErrMessage(G, "Area", "Invalid state.");
       else {
-        rep = (RepDot *) RepDotDoNew(cs, cRepDotAreaType, sta0);
-        if(!rep)
-          ErrMessage(G, "Area", "Can't get dot representation.");
+        std::vector<float> area(obj0->NAtom, 0.0F);
+        float *area_ptr = area.data();
+
+        if(!RepDotGetAtomAreas(G, 1, &cs, &area_ptr,
+                               SettingGetGlobal_i(G, cSetting_max_threads)))
+          ErrMessage(G, "Area", "Can't compute surface area.");
         else {
 
           if(load_b) {
@@ -9152,31 +10039,20 @@ float ExecutiveGetArea(PyMOLGlobals * G, const char *s0, int sta0, int load_b)
             ExecutiveObjMolSeleOp(G, sele0, &op);
           }
 
-          result = 0.0;
-
-          area = rep->A;
-          ati = rep->Atom;
-
-          is_member = false;
-
-          for(a = 0; a < rep->N; a++) {
+          double sum = 0.0;
 
-            if(known_member != (*ati)) {
-              known_member = (*ati);
-              ai = obj0->AtomInfo + known_member;
-              is_member = SelectorIsMember(G, ai->selEntry, sele0);
-            }
+          for(int idx = 0; idx < cs->NIndex; idx++) {
+            int atm = cs->IdxToAtm[idx];
+            AtomInfoType *ai = obj0->AtomInfo + atm;
 
-            if(is_member) {
-              result += (*area);
+            if(SelectorIsMember(G, ai->selEntry, sele0)) {
+              sum += area[atm];
               if(load_b)
-                ai->b += (*area);
+                ai->b += area[atm];
             }
-            area++;
-            ati++;
           }
 
-          rep->R.fFree((Rep *) rep);    /* free the representation */
+          result = (float) sum;
         }
       }
     }
@@ -9185,6 +10061,69 @@ float ExecutiveGetArea(PyMOLGlobals * G, const char *s0, int sta0, int load_b)
 }
 
 
+/*========================================================================*/
+/*
+ * Surface area of every selected atom (see RepDotGetAtomAreas), in one
+ * state (1-D array) or in all states (state = -1, 2-D array with one row
+ * per state). Each object is treated separately, atoms of other objects
+ * don't occlude. Atoms without coordinates in a state give NaN.
+ */
+PyObject *ExecutiveGetAtomAreas(PyMOLGlobals * G, const char *s0, int state)
+{
+  std::vector<TrajAtom> atoms = TrajGetAtoms(G, s0);
+  std::map<ObjectMolecule *, int> obj_index;
+  std::vector<ObjectMolecule *> objs;
+  std::vector<CoordSet *> cs_list;
+  std::vector<std::vector<float> > areas;
+  std::vector<float *> area_ptrs;
+  std::vector<float> values;
+  int first = state, last = state;
+  int n_state;
+
+  if(state < -1)
+    first = last = SceneGetState(G);
+
+  n_state = TrajGetStateRange(atoms, first, last);
+
+  for(auto & atom : atoms) {
+    if(obj_index.find(atom.obj) == obj_index.end()) {
+      obj_index[atom.obj] = objs.size();
+      objs.push_back(atom.obj);
+    }
+  }
+
+  /* one area buffer per (state, object) */
+  areas.resize(n_state * objs.size());
+  for(int s = 0; s < n_state; s++) {
+    for(size_t o = 0; o < objs.size(); o++) {
+      CoordSet *cs = (CoordSet *) TrajGetCoordSet(objs[o], first + s);
+      auto & area = areas[s * objs.size() + o];
+      area.assign(objs[o]->NAtom, NAN);
+      if(cs) {
+        cs_list.push_back(cs);
+        area_ptrs.push_back(area.data());
+      }
+    }
+  }
+
+  if(!RepDotGetAtomAreas(G, cs_list.size(), cs_list.data(), area_ptrs.data(),
+                         SettingGetGlobal_i(G, cSetting_max_threads))) {
+    ErrMessage(G, "GetAtomAreas", "Can't compute surface area.");
+    return NULL;
+  }
+
+  values.reserve(n_state * atoms.size());
+  for(int s = 0; s < n_state; s++) {
+    for(auto & atom : atoms) {
+      const auto & area = areas[s * objs.size() + obj_index[atom.obj]];
+      values.push_back(area[atom.atm]);
+    }
+  }
+
+  return TrajAsNumPy(values, (state == -1) ? atoms.size() : 0);
+}
+
+
 /*========================================================================*/
 char *ExecutiveGetNames(PyMOLGlobals * G, int mode, int enabled_only, const char *s0)
 {
@@ -10589,7 +11528,15 @@ int ExecutiveIterate(PyMOLGlobals * G, const char *str1, const char *expr, int r
     op1.s1 = expr;
     op1.py_ob1 = space;
 #endif
-    ExecutiveObjMolSeleOp(G, sele1, &op1);
+    std::unique_ptr<AlterExpr> fast;
+    if(!read_only)
+      fast.reset(new AlterExpr(G, expr, false));
+    if(fast && fast->isValid()) {
+      /* simple assignments, no Python evaluation per atom */
+      op1.i1 = fast->apply(sele1);
+    } else {
+      ExecutiveObjMolSeleOp(G, sele1, &op1);
+    }
     if(!quiet) {
       if(!read_only) {
         PRINTFB(G, FB_Executive, FB_Actions)
@@ -10655,6 +11602,7 @@ int ExecutiveSelectList(PyMOLGlobals * G, const char *sele_name, const char *s1,
             OVreturn_word ret;
             int n_idx = 0;
             int *idx_list = VLAlloc(int, list_len);
+            OVOneToAny_Reserve(o2a, obj->NAtom);
             ai = obj->AtomInfo;
 
             for(a = 0; a < obj->NAtom; a++) {
@@ -10811,6 +11759,8 @@ int ExecutiveIterateList(PyMOLGlobals * G, const char *name,
           n_eval++;
       }
     }
+    if(!read_only)
+      SelectorInvalidateEvalCache(G);
   } else {
     PRINTFB(G, FB_Executive, FB_Errors)
       " AlterList-Error: selection cannot span more than one object.\n" ENDFB(G);
@@ -10870,7 +11820,18 @@ int ExecutiveIterateState(PyMOLGlobals * G, int state, const char *str1, const c
     ObjectMoleculeOpRecInit(&op1);
     op1.i1 = 0;
 
+    std::unique_ptr<AlterExpr> fast;
+    if(!read_only)
+      fast.reset(new AlterExpr(G, expr, true));
+    if(fast && !fast->isValid())
+      fast.reset();
+
     for(state = start_state; state < stop_state; state++) {
+      if(fast) {
+        /* simple assignments, no Python evaluation per atom */
+        op1.i1 += fast->apply(sele1, state);
+        continue;
+      }
       op1.code = OMOP_AlterState;
 #ifdef _WEBGL
 #else
@@ -11650,7 +12611,6 @@ float *ExecutiveRMSStates(PyMOLGlobals * G, const char *s1, int target, int mode
   ObjectMoleculeOpRecInit(&op1);
   ObjectMoleculeOpRecInit(&op2);
   op1.vv1 = NULL;
-  op2.vv1 = NULL;
 
   if(!SelectorGetSingleObjectMolecule(G, sele1)) {
     if(mode != 2) {
@@ -11680,14 +12640,11 @@ float *ExecutiveRMSStates(PyMOLGlobals * G, const char *s1, int target, int mode
     op2.i3 = mix;
     op2.f1VLA = VLAlloc(float, 10);
     VLASize(op2.f1VLA, float, 0);       /* failsafe */
-    op2.vv1 = (float *) VLAMalloc(1000, sizeof(float), 5, 0);
     op2.code = OMOP_SFIT;
-    op2.nvv1 = 0;
     ExecutiveObjMolSeleOp(G, sele1, &op2);
     result = op2.f1VLA;
     VLAFreeP(op1.vv1);
     VLAFreeP(op1.i1VLA);
-    VLAFreeP(op2.vv1);
   }
   return (result);
 }
@@ -13176,6 +14133,18 @@ const char *ExecutiveFindBestNameMatch(PyMOLGlobals * G, const char *name)
   best = 0;
   result = name;
 
+  /* only wildcards and case variants need the full scan */
+  if(!strchr(name, '*')) {
+    switch (ExecutiveFoldedNameCount(I, name)) {
+    case 0:
+      return result;
+    case 1:
+      if((rec = ExecutiveFindSpecExact(I, name)))
+        return rec->name;
+    }
+    rec = NULL;
+  }
+
   while(ListIterate(I->Spec, rec, next)) {
     wm = WordMatch(G, name, rec->name, true);
     if(wm < 0) {
@@ -13217,16 +14186,11 @@ static SpecRec *ExecutiveFindSpec(PyMOLGlobals * G, const char *name)
   // ignore % prefix
   if(name[0] && name[0] == '%')
     name++;
-  {                             /* first, try for perfect, case-specific match */
-    OVreturn_word result;
-    if(OVreturn_IS_OK((result = OVLexicon_BorrowFromCString(I->Lex, name)))) {
-      if(OVreturn_IS_OK((result = OVOneToOne_GetForward(I->Key, result.word)))) {
-        if(!TrackerGetCandRef(I->Tracker, result.word, (TrackerRef **) (void *) &rec)) {
-          rec = NULL;
-        }
-      }
-    }
-    if(!rec) {                  /* otherwise try partial/case-nonspecific match */
+  /* first, try for perfect, case-specific match */
+  rec = ExecutiveFindSpecExact(I, name);
+  if(!rec) {                    /* otherwise try case-nonspecific match */
+    if(SettingGetGlobal_b(G, cSetting_ignore_case) &&
+       ExecutiveFoldedNameCount(I, name)) {
       rec = ExecutiveAnyCaseNameMatch(G, name);
     }
   }
@@ -13244,27 +14208,38 @@ void ExecutiveObjMolSeleOp(PyMOLGlobals * G, int sele, ObjectMoleculeOpRec * op)
 
 	/* if we're given a valid selection */
   if(sele >= 0) {
+    auto apply = [&](ObjectMolecule * obj) {
+      switch (op->code) {
+      case OMOP_RenameAtoms:
+        {
+          int result = SelectorRenameObjectAtoms(G, obj, sele, op->i2, update_table);
+          if(result > 0)
+            op->i1 += result;
+          update_table = false;
+        }
+        break;
+      default:
+        /* all other cases, perform the operation on obj */
+        ObjectMoleculeSeleOp(obj, sele, op);
+        break;
+      }
+    };
+
+    /* selections of a single object (e.g. object names) don't need to
+       visit all the other objects, unless the operation also touches
+       atoms outside of the selection */
+    if(ObjectMoleculeSeleOpMembersOnly(op) &&
+       (obj = SelectorGetKnownSingleObjectMolecule(G, sele))) {
+      apply(obj);
+      return;
+    }
+
 		/* iterate over all the objects in the global list */
     while(ListIterate(I->Spec, rec, next)) {
       if(rec->type == cExecObject) {
         if(rec->obj->type == cObjectMolecule) {
 					/* if the objects are valid molecules, then perform the operation in op_code */
-          obj = (ObjectMolecule *) rec->obj;
-
-          switch (op->code) {
-          case OMOP_RenameAtoms:
-            {
-              int result = SelectorRenameObjectAtoms(G, obj, sele, op->i2, update_table);
-              if(result > 0)
-                op->i1 += result;
-              update_table = false;
-            }
-            break;
-          default:
-						/* all other cases, perform the operation on obj */
-            ObjectMoleculeSeleOp(obj, sele, op);
-            break;
-          }
+          apply((ObjectMolecule *) rec->obj);
         }
       }
     }
@@ -14554,6 +15529,61 @@ Block *ExecutiveGetBlock(PyMOLGlobals * G)
 
 
 /*========================================================================*/
+/*
+ * Applies symmetry operator `symmat` to `n` coordinates in `v` and moves
+ * the result into the unit cell of the fractional point `tc`, plus
+ * (x, y, z) lattice steps. Same arithmetic as the CoordSetRealToFrac,
+ * CoordSetTransform44f, CoordSetGetAverage, CoordSetFracToReal sequence.
+ */
+static void SymExpTransformCoords(const CCrystal * cryst, const float *symmat,
+                                  const float *tc, int x, int y, int z,
+                                  float *v, int n)
+{
+  int a, c, tt[3];
+  float m[16], ts[3] = {0.f, 0.f, 0.f};
+  double accum[3] = {0.0, 0.0, 0.0};
+
+  /* convert coordinates into fractional, based on unit cell */
+  for(a = 0; a < n; a++)
+    transform33f3f(cryst->RealToFrac, v + 3 * a, v + 3 * a);
+  for(a = 0; a < n; a++)
+    transform44f3f(symmat, v + 3 * a, v + 3 * a);
+
+  if(n) {
+    for(a = 0; a < n; a++) {
+      accum[0] += v[3 * a];
+      accum[1] += v[3 * a + 1];
+      accum[2] += v[3 * a + 2];
+    }
+    ts[0] = (float) (accum[0] / n);
+    ts[1] = (float) (accum[1] / n);
+    ts[2] = (float) (accum[2] / n);
+  }
+
+  identity44f(m);
+  /* compute the effective translation resulting
+     from application of the symmetry operator so
+     that we can shift it into the cell of the
+     target selection */
+  for(c = 0; c < 3; c++) {      /* manual rounding - rint broken */
+    /* here, we subtract the center of mass of the selection from tc */
+    ts[c] = tc[c] - ts[c];
+    if(ts[c] < 0)
+      ts[c] -= 0.5;
+    else
+      ts[c] += 0.5;
+    tt[c] = (int) ts[c];
+  }
+  /* translate the coordinate set by adding Tx, Ty, Tz from the symmetry matrix */
+  m[3] = (float) tt[0] + x;
+  m[7] = (float) tt[1] + y;
+  m[11] = (float) tt[2] + z;
+  for(a = 0; a < n; a++)
+    transform44f3f(m, v + 3 * a, v + 3 * a);
+  for(a = 0; a < n; a++)
+    transform33f3f(cryst->FracToReal, v + 3 * a, v + 3 * a);
+}
+
 void ExecutiveSymExp(PyMOLGlobals * G, const char *name,
                      const char *oname, const char *s1, float cutoff, int segi, int quiet)
 {                               /* TODO state */
@@ -14562,11 +15592,10 @@ void ExecutiveSymExp(PyMOLGlobals * G, const char *name,
   ObjectMolecule *new_obj = NULL;
   ObjectMoleculeOpRec op;
   MapType *map;
-  int x, y, z, b, c, i, j, h, k, l, n;
+  int x, y, z, b;
   ov_size a;
-  CoordSet *cs, *os;
-  int keepFlag, sele, tt[3];
-  float *v1, *v2, m[16], tc[3], ts[3];
+  int sele;
+  float tc[3];
   OrthoLineType new_name;
   float auto_save;
 
@@ -14634,91 +15663,129 @@ void ExecutiveSymExp(PyMOLGlobals * G, const char *name,
       ErrMessage(G, "ExecutiveSymExp", "No atoms indicated!");
     } else {
       int nsymmat = obj->Symmetry->getNSymMat();
+      const CCrystal *cryst = obj->Symmetry->Crystal;
       map = MapNew(G, -cutoff, op.vv1, op.nvv1, NULL);
       if(map) {
+        /* 3.  Find the mates which come within cutoff of the selection.
+         * Only coordinates are transformed here, so candidates can be
+         * tested in parallel and only the kept ones get copied. */
+        int n_cand = 27 * nsymmat;
+        std::vector<char> keep(n_cand);
+        float sele_min[3], sele_max[3];
+
         MapSetupExpress(map);
+
+        /* bounding box of the selection, grown by the cutoff */
+        copy3f(op.vv1, sele_min);
+        copy3f(op.vv1, sele_max);
+        for(int i = 1; i < op.nvv1; i++) {
+          const float *v = op.vv1 + 3 * i;
+          for(int c = 0; c < 3; c++) {
+            if(sele_min[c] > v[c])
+              sele_min[c] = v[c];
+            if(sele_max[c] < v[c])
+              sele_max[c] = v[c];
+          }
+        }
+        for(int c = 0; c < 3; c++) {
+          sele_min[c] -= cutoff;
+          sele_max[c] += cutoff;
+        }
+
+        pymol::parallel_for(SettingGetGlobal_i(G, cSetting_max_threads), n_cand,
+            [&](int cand) {
+          /* same order as the x, y, z, a loops below */
+          int cx = cand / (9 * nsymmat) - 1;
+          int cy = (cand / (3 * nsymmat)) % 3 - 1;
+          int cz = (cand / nsymmat) % 3 - 1;
+          const float *symmat = obj->Symmetry->getSymMat(cand % nsymmat);
+          std::vector<float> coord;
+          bool keepFlag = false;
+
+          for(int b = 0; b < obj->NCSet; b++) {
+            const CoordSet *os = obj->CSet[b];
+            if(!os)
+              continue;
+
+            int n = os->NIndex;
+            coord.assign(os->Coord, os->Coord + 3 * n);
+            SymExpTransformCoords(cryst, symmat, tc, cx, cy, cz,
+                                  coord.data(), n);
+
+            if(!keepFlag) {
+              /* bounding box culling */
+              float cs_min[3], cs_max[3];
+              bool overlap = n > 0;
+              if(overlap) {
+                copy3f(coord.data(), cs_min);
+                copy3f(coord.data(), cs_max);
+                for(int i = 1; i < n; i++) {
+                  const float *v = coord.data() + 3 * i;
+                  for(int c = 0; c < 3; c++) {
+                    if(cs_min[c] > v[c])
+                      cs_min[c] = v[c];
+                    if(cs_max[c] < v[c])
+                      cs_max[c] = v[c];
+                  }
+                }
+                for(int c = 0; c < 3; c++) {
+                  if(cs_min[c] > sele_max[c] || cs_max[c] < sele_min[c])
+                    overlap = false;
+                }
+              }
+
+              /* this steps through the coordinate list until it finds a vertex close enough */
+              for(int i = 0; overlap && !keepFlag && i < n; i++) {
+                const float *v2 = coord.data() + 3 * i;
+                int h, k, l;
+                MapLocus(map, v2, &h, &k, &l);
+                int e = *(MapEStart(map, h, k, l));
+                if(e) {
+                  for(int j = map->EList[e++]; j >= 0; j = map->EList[e++]) {
+                    /* if op.vv1+3*j (a vertex) is within cutoff angstroms of v2, keep it and break */
+                    if(within3f(op.vv1 + 3 * j, v2, cutoff)) {
+                      keepFlag = true;
+                      break;
+                    }
+                  }
+                }
+              }
+            }
+            if(keepFlag) {
+              /* make sure that we aren't simply duplicating the template coordinates */
+              const float *v1 = os->Coord;
+              const float *v2 = coord.data();
+              keepFlag = false;
+              for(int i = 0; i < n; i++) {
+                if(diffsq3f(v1, v2) > R_SMALL8) {
+                  keepFlag = true;
+                  break;
+                }
+                v1++;
+                v2++;
+              }
+            }
+          }
+          keep[cand] = keepFlag;
+        });
+
+        /* 4.  Make and manage the new objects */
         /* go out no more than one lattice step in each direction: -1, 0, +1 */
         for(x = -1; x < 2; x++)
           for(y = -1; y < 2; y++)
             for(z = -1; z < 2; z++)
               for(a = 0; a < nsymmat; a++) {
-								/* make a copy of the original */
-                new_obj = ObjectMoleculeCopy(obj);
-
-                keepFlag = false;
-                for(b = 0; b < new_obj->NCSet; b++)
-                  if(new_obj->CSet[b]) {
-										/* get the new and original coordinate sets for this state */
-                    cs = new_obj->CSet[b];
-                    os = obj->CSet[b];
-										/* convert coordinates into fractional, based on unit cell */
-                    CoordSetRealToFrac(cs, obj->Symmetry->Crystal);
-                    CoordSetTransform44f(cs, obj->Symmetry->getSymMat(a));
-                    CoordSetGetAverage(cs, ts);
-                    identity44f(m);
-                    /* compute the effective translation resulting
-                       from application of the symmetry operator so
-                       that we can shift it into the cell of the
-                       target selection */
-                    for(c = 0; c < 3; c++) {    /* manual rounding - rint broken */
-											/* here, we subtract the center of mass of the selection from tc */
-                      ts[c] = tc[c] - ts[c];
-                      if(ts[c] < 0)
-                        ts[c] -= 0.5;
-                      else
-                        ts[c] += 0.5;
-                      tt[c] = (int) ts[c];
-                    }
-										/* translate the coordinate set by adding Tx, Ty, Tz from the symmetry matrix */
-										/* Now we're at the center of mass and can make an non-affine rotation */
-                    m[3] = (float) tt[0] + x;
-                    m[7] = (float) tt[1] + y;
-                    m[11] = (float) tt[2] + z;
-										/* cs = m x cs, for rotation matrix, m and coordinate set cs */
-                    CoordSetTransform44f(cs, m);
-										
-										/* this steps through the coordinate list until it finds a vertex close enough */
-                    CoordSetFracToReal(cs, obj->Symmetry->Crystal);
-                    if(!keepFlag) {
-											/* for each coordinate in this coordinate set */
-                      v2 = cs->Coord;
-                      n = cs->NIndex;
-                      while(n--) {
-                        MapLocus(map, v2, &h, &k, &l);
-                        i = *(MapEStart(map, h, k, l));
-                        if(i) {
-                          j = map->EList[i++];
-                          while(j >= 0) {
-														/* if op.vv1+3*j (a vertex) is within cutoff angstroms of v2, keep it and break */
-                            if(within3f(op.vv1 + 3 * j, v2, cutoff)) {
-                              keepFlag = true;
-                              break;
-                            }
-                            j = map->EList[i++];
-                          }
-                        }
-                        v2 += 3;
-                        if(keepFlag)
-                          break;
-                      }
-                    }
-                    if(keepFlag) {
-                      /* make sure that we aren't simply duplicating the template coordinates */
-                      keepFlag = false;
-                      v1 = os->Coord;
-                      v2 = cs->Coord;
-                      n = cs->NIndex;
-                      while(n--) {
-                        if(diffsq3f(v1, v2) > R_SMALL8) {
-                          keepFlag = true;
-                          break;
-                        }
-                        v1++;
-                        v2++;
-                      }
-                    }
+                if(keep[((x + 1) * 9 + (y + 1) * 3 + (z + 1)) * nsymmat + a]) {
+                  /* we need to create new object */
+
+                  /* make a copy of the original */
+                  new_obj = ObjectMoleculeCopy(obj);
+                  for(b = 0; b < new_obj->NCSet; b++) {
+                    CoordSet *cs = new_obj->CSet[b];
+                    if(cs)
+                      SymExpTransformCoords(cryst, obj->Symmetry->getSymMat(a),
+                                            tc, x, y, z, cs->Coord, cs->NIndex);
                   }
-                if(keepFlag) {  /* we need to create new object */
 
                   /* TODO: should also transform the U tensor at this point... */
 
@@ -14785,8 +15852,6 @@ void ExecutiveSymExp(PyMOLGlobals * G, const char *name,
                       LexDec(G, segi);
                     }
                   }
-                } else {
-                  ((CObject *) new_obj)->fFree((CObject *) new_obj);
                 }
               }
         MapFree(map);
@@ -15033,22 +16098,25 @@ void ExecutiveManageObject(PyMOLGlobals * G, CObject * obj, int zoom, int quiet)
 
   if(SettingGetGlobal_b(G, cSetting_auto_hide_selections))
     ExecutiveHideSelections(G);
-  while(ListIterate(I->Spec, rec, next)) {
-    if(rec->obj == obj) {
-      exists = true;
-    }
+  if(I->ObjRec.count(obj)) {
+    exists = true;
   }
   if(!exists) {
-    while(ListIterate(I->Spec, rec, next)) {
-      if(rec->type == cExecObject) {
-        if(strcmp(rec->obj->Name, obj->Name) == 0)
-          break;
+    rec = ExecutiveFindSpecExact(I, obj->Name);
+    if(rec && rec->type != cExecObject) {
+      rec = NULL;
+      while(ListIterate(I->Spec, rec, next)) {
+        if(rec->type == cExecObject) {
+          if(strcmp(rec->obj->Name, obj->Name) == 0)
+            break;
+        }
       }
     }
     if(rec) {                   /* another object of this type already exists */
       /* purge it */
       SceneObjectDel(G, rec->obj, false);
       ExecutiveInvalidateSceneMembers(G);
+      I->ObjRec.erase(rec->obj);
       rec->obj->fFree(rec->obj);
       rec->obj = NULL;
     } else {
@@ -15091,12 +16159,22 @@ void ExecutiveManageObject(PyMOLGlobals * G, CObject * obj, int zoom, int quiet)
 
     TrackerLink(I->Tracker, rec->cand_id, I->all_names_list_id, 1);
     TrackerLink(I->Tracker, rec->cand_id, I->all_obj_list_id, 1);
-    ListAppend(I->Spec, rec, next, SpecRec);
+    {
+      /* append after the previously managed object if that's still the
+         last record, without walking the list */
+      auto it = I->ObjRec.find(I->LastManaged);
+      if(it != I->ObjRec.end() && !it->second->next) {
+        it->second->next = rec;
+      } else {
+        ListAppend(I->Spec, rec, next, SpecRec);
+      }
+      I->LastManaged = obj;
+    }
     ExecutiveAddKey(I, rec);
     ExecutiveInvalidatePanelList(G);
 
     if(rec->visible) {
-      rec->in_scene = SceneObjectAdd(G, obj);
+      rec->in_scene = SceneObjectAdd(G, obj, !I->ManageBatch);
       ExecutiveInvalidateSceneMembers(G);
     }
     ExecutiveDoAutoGroup(G, rec);
@@ -15130,6 +16208,27 @@ void ExecutiveManageObject(PyMOLGlobals * G, CObject * obj, int zoom, int quiet)
 }
 
 
+/*========================================================================*/
+/*
+ * Register many objects in a row: between Begin and End,
+ * ExecutiveManageObject doesn't recount the scene frames (which visits all
+ * objects) for every new object. Calls may nest.
+ */
+void ExecutiveManageObjectsBegin(PyMOLGlobals * G)
+{
+  G->Executive->ManageBatch++;
+}
+
+void ExecutiveManageObjectsEnd(PyMOLGlobals * G)
+{
+  CExecutive *I = G->Executive;
+  if(I->ManageBatch && !--I->ManageBatch) {
+    SceneCountFrames(G);
+    SceneChanged(G);
+  }
+}
+
+
 /*========================================================================*/
 void ExecutiveManageSelection(PyMOLGlobals * G, const char *name)
 {
@@ -16922,11 +18021,12 @@ PyObject * ExecutiveCEAlign(PyMOLGlobals * G, PyObject * listA, PyObject * listB
 #else
   int i=0;
   int smaller;
-  double **dmA ,**dmB, **S;
+  double *dmA, *dmB, *S;
   int bufferSize;
   pcePoint coordsA, coordsB;
   pathCache paths = NULL;
   PyObject * result;
+  int n_thread = SettingGetGlobal_i(G, cSetting_max_threads);
 
   smaller = lenA < lenB ? lenA : lenB;
 	
@@ -16935,20 +18035,20 @@ PyObject * ExecutiveCEAlign(PyMOLGlobals * G, PyObject * listA, PyObject * listB
   coordsB = (pcePoint) getCoords(listB, lenB);
 	
   /* calculate the distance matrix for each protein */
-  dmA = (double**) calcDM(coordsA, lenA);
-  dmB = (double**) calcDM(coordsB, lenB);
+  dmA = calcDM(coordsA, lenA, n_thread);
+  dmB = calcDM(coordsB, lenB, n_thread);
 	
   /* calculate the CE Similarity matrix */
-  S = (double**) calcS(dmA, dmB, lenA, lenB, windowSize);
+  S = calcS(dmA, dmB, lenA, lenB, windowSize, n_thread);
 	
   /* find the best path through the CE Sim. matrix */
   bufferSize = 0;
 
   /* the following line HANGS PyMOL */
-  paths = (pathCache) findPath(S, dmA, dmB, lenA, lenB, d0, d1, windowSize, gapMax, &bufferSize);
+  paths = (pathCache) findPath(S, dmA, dmB, lenA, lenB, d0, d1, windowSize, gapMax, &bufferSize, n_thread);
 	
   /* Get the optimal superposition here... */
-  result = (PyObject*) findBest(coordsA, coordsB, paths, bufferSize, smaller, windowSize);
+  result = (PyObject*) findBest(coordsA, coordsB, paths, bufferSize, smaller, windowSize, n_thread);
 	
   /* release memory */
   free(coordsA);
@@ -16957,18 +18057,9 @@ PyObject * ExecutiveCEAlign(PyMOLGlobals * G, PyObject * listA, PyObject * listB
     free(paths[i]);
   free(paths);
 	
-  /* distance matrices	 */
-  for ( i = 0; i < lenA; i++ )
-    free( dmA[i] );
+  /* distance and similarity matrices */
   free(dmA);
-	
-  for  ( i = 0; i < lenB; i++ )
-    free( dmB[i] );
   free(dmB);
-	
-  /* similarity matrix */
-  for ( i = 0; i < lenA; i++ )
-    free( S[i] );
   free(S);
 	
   return (PyObject*) result;
@@ -17038,6 +18129,8 @@ ok_except1:
 
 void ExecutiveUniqueIDAtomDictInvalidate(PyMOLGlobals * G) {
   CExecutive *I = G->Executive;
+  if (pymol::is_detached())
+    return;     // invalidated again when the object gets registered
   if (I->m_eoo) {
     OVOneToOne_DEL_AUTO_NULL(I->m_id2eoo);
     VLAFreeP(I->m_eoo);
@@ -17,6 +17,9 @@ Z* -------------------------------------------------------------------
 #ifndef _H_Executive
 #define _H_Executive
 
+#include <string>
+#include <vector>
+
 #include"os_python.h"
 
 #include"PyMOLGlobals.h"
@@ -191,6 +194,17 @@ int ExecutiveLoad(PyMOLGlobals * G,
                   const char * object_props=NULL, const char * atom_props=NULL,
                   bool mimic=true);
 
+struct ExecutiveLoadBatchEntry {
+  std::string filename;
+  std::string object_name;
+  cLoadType_t format;
+};
+
+int ExecutiveLoadBatch(PyMOLGlobals * G,
+                       const std::vector<ExecutiveLoadBatchEntry> & entries,
+                       int state, int zoom, int discrete, int multiplex,
+                       int quiet);
+
 int ExecutiveDebug(PyMOLGlobals * G, const char *name);
 
 typedef struct {
@@ -220,6 +234,13 @@ int ExecutiveAlign(PyMOLGlobals * G, const char *s1, const char *s2, const char
                    ExecutiveRMSInfo * rms_info, int transform, int reset,
                    float seq_wt, float radius, float scale, float base,
                    float coord_wt, float expect, int window, float ante);
+int ExecutiveAlignMatrix(PyMOLGlobals * G, const std::vector<std::string> & seles,
+                         const char *mat_file, float gap, float extend,
+                         int max_gap, int max_skip, float cutoff, int cycles,
+                         int quiet, int state, float seq_wt, float radius,
+                         float scale, float base, float coord_wt, float expect,
+                         int window, float ante, std::vector<float> & rms,
+                         std::vector<int> & n_atom, std::vector<float> & score);
 
 void ExecutiveUpdateColorDepends(PyMOLGlobals * G, ObjectMolecule * mol);
 void ExecutiveUpdateCoordDepends(PyMOLGlobals * G, ObjectMolecule * mol);
@@ -259,6 +280,8 @@ int ExecutiveInit(PyMOLGlobals * G);
 void ExecutiveFree(PyMOLGlobals * G);
 int ExecutivePop(PyMOLGlobals * G, const char *target, const char *source, int quiet);
 void ExecutiveManageObject(PyMOLGlobals * G, CObject * obj, int allow_zoom, int quiet);
+void ExecutiveManageObjectsBegin(PyMOLGlobals * G);
+void ExecutiveManageObjectsEnd(PyMOLGlobals * G);
 void ExecutiveUpdateObjectSelection(PyMOLGlobals * G, CObject * obj);
 void ExecutiveManageSelection(PyMOLGlobals * G, const char *name);
 Block *ExecutiveGetBlock(PyMOLGlobals * G);
@@ -298,6 +321,12 @@ int ExecutiveGetAngle(PyMOLGlobals * G, const char *s0, const char *s1, const ch
                       int state);
 int ExecutiveGetDihe(PyMOLGlobals * G, const char *s0, const char *s1, const char *s2, const char *s3,
                      float *value, int state);
+PyObject *ExecutiveGetGeometrySeries(PyMOLGlobals * G,
+                                     const std::vector<std::string> & seles,
+                                     int first, int last);
+PyObject *ExecutiveGetGyrationSeries(PyMOLGlobals * G, const char *s1,
+                                     int first, int last);
+PyObject *ExecutiveGetRMSF(PyMOLGlobals * G, const char *s1, int first, int last);
 int ExecutiveSetDihe(PyMOLGlobals * G, const char *s0, const char *s1, const char *s2, const char *s3,
                      float value, int state=0, int quiet=1);
 int ExecutiveRMS(PyMOLGlobals * G, const char *sele1, const char *sele2, int mode, float refine,
@@ -374,6 +403,7 @@ char *ExecutiveGetNames(PyMOLGlobals * G, int mode, int enabled_only, const char
 bool ExecutiveIsMoleculeOrSelection(PyMOLGlobals * G, const char *name);
 int ExecutiveGetType(PyMOLGlobals * G, const char *name, WordType type);
 float ExecutiveGetArea(PyMOLGlobals * G, const char *s0, int sta0, int load_b);
+PyObject *ExecutiveGetAtomAreas(PyMOLGlobals * G, const char *s0, int state);
 void ExecutiveInvalidateSelectionIndicators(PyMOLGlobals *G);
 void ExecutiveInvalidateSelectionIndicatorsCGO(PyMOLGlobals *G);
 void ExecutiveRenderSelections(PyMOLGlobals * G, int curState, int slot, GridInfo *grid);
@@ -482,6 +512,7 @@ int ExecutiveReinitialize(PyMOLGlobals * G, int what, const char *pattern);
 const char *ExecutiveFindBestNameMatch(PyMOLGlobals * G, const char *name);
 int ExecutiveSetVisFromPyDict(PyMOLGlobals * G, PyObject * dict);
 PyObject *ExecutiveGetVisAsPyDict(PyMOLGlobals * G);
+PyObject *ExecutiveGetMemoryReport(PyMOLGlobals * G);
 CField   *ExecutiveGetVolumeField(PyMOLGlobals * G, const char * objName, int state);
 int       ExecutiveSetVolumeRamp(PyMOLGlobals * G, const char * objName, float *ramp_list, int list_size);
 PyObject *ExecutiveGetVolumeRamp(PyMOLGlobals * G, const char * objName);
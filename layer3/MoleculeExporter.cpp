@@ -9,6 +9,8 @@
 #include <algorithm>
 #include <cstdarg>
 #include <clocale>
+#include <cstdio>
+#include <functional>
 #include <memory>
 
 #ifndef _PYMOL_NO_MSGPACKC
@@ -34,6 +36,7 @@
 #include "PConv.h"
 #include "CifDataValueFormatter.h"
 #include "MaeExportHelpers.h"
+#include "Parallel.h"
 
 #ifdef _PYMOL_IP_PROPERTIES
 #include "Property.h"
@@ -100,6 +103,12 @@ enum {
   cMolExportByCoordSet = 2,
 };
 
+// streaming output
+enum {
+  cMolExportFlushSize = 1 << 20,        // bytes handed to the sink at once
+  cMolExportBatchSize = 1 << 16,        // atom records formatted at once
+};
+
 // for re-indexed bonds
 struct BondRef {
   BondType * ref;
@@ -119,6 +128,12 @@ struct AtomRef {
 struct MoleculeExporter {
   pymol::vla<char> m_buffer; // out
 
+  // Optional streaming output. If set, "m_buffer" is handed to the sink
+  // whenever it has grown beyond cMolExportFlushSize, instead of
+  // accumulating the whole file. The sink returns false on error.
+  std::function<bool(const char *, size_t)> m_sink;
+  bool m_sink_failed;
+
 protected:
   int m_offset;
   CoordSet        * m_last_cs;
@@ -150,6 +165,15 @@ protected:
   std::vector<BondRef> m_bonds;
   std::vector<int> m_tmpids;
 
+  // "m_buffer" has a placeholder which is filled in later (e.g. an atom
+  // count), so it must not be handed to the sink yet
+  bool m_deferred;
+
+  // atom records collected for formatAtoms
+  std::vector<AtomRef> m_atom_batch;
+  int m_atom_batch_state;
+  int m_sele;
+
 public:
   // quasi constructor (easier to inherit than a real constructor)
   virtual void init(PyMOLGlobals * G_) {
@@ -165,6 +189,8 @@ public:
     m_last_state = -1;
     m_retain_ids = false;
     m_id = 0;
+    m_deferred = false;
+    m_sink_failed = false;
 
     setMulti(getMultiDefault());
   }
@@ -239,6 +265,41 @@ private:
    */
   void populateBondRefs();
 
+protected:
+  /*
+   * Hand the buffer to the sink (if any) once it is large enough, or
+   * unconditionally with force=true.
+   */
+  void flush(bool force = false);
+
+  /*
+   * writeAtom() for formats which implement formatAtoms: collect the
+   * current atom for formatting with writeAtomBatch().
+   */
+  void batchAtom() {
+    m_atom_batch.emplace_back(AtomRef { m_iter.getAtomInfo(),
+        { m_coord[0], m_coord[1], m_coord[2] }, getTmpID() });
+    m_atom_batch_state = m_iter.state;
+    if (m_atom_batch.size() >= cMolExportBatchSize)
+      writeAtomBatch();
+  }
+
+  /*
+   * Format the collected atom records into "m_buffer"
+   */
+  void writeAtomBatch();
+
+  /*
+   * Format the atom records [begin, end) into `buffer` at `offset` (which
+   * is advanced). Line-oriented formats whose atom records don't depend
+   * on each other implement this and call batchAtom() from writeAtom().
+   * Called concurrently for different ranges, so implementations must
+   * not modify the exporter or any other global state. All records are
+   * from the same coordinate set, which has state "m_atom_batch_state".
+   */
+  virtual void formatAtoms(pymol::vla<char>& buffer, int& offset,
+      const AtomRef * begin, const AtomRef * end) {}
+
 protected:
   // functions to be implemented by derived classes
   virtual int getMultiDefault() const = 0;
@@ -302,6 +363,7 @@ void MoleculeExporter::endCoordSet() {
 }
 
 void MoleculeExporter::execute(int sele, int state) {
+  m_sele = sele;
   m_iter.init(G, sele, state);
   m_iter.setPerObject(m_multi != cMolExportGlobal);
 
@@ -309,6 +371,8 @@ void MoleculeExporter::execute(int sele, int state) {
 
   while (m_iter.next()) {
     if (m_last_cs != m_iter.cs) {
+      writeAtomBatch();
+
       if (m_last_cs) {
         endCoordSet();
       } else if (m_multi == cMolExportGlobal) {
@@ -345,8 +409,13 @@ void MoleculeExporter::execute(int sele, int state) {
     }
 
     writeAtom();
+
+    if (m_offset >= cMolExportFlushSize)
+      flush();
   }
 
+  writeAtomBatch();
+
   if (m_last_cs)
     endCoordSet();
   if (m_last_obj)
@@ -359,9 +428,62 @@ void MoleculeExporter::execute(int sele, int state) {
     writeBonds();
   }
 
+  flush(true);
+
   m_buffer.resize(m_offset);
 }
 
+void MoleculeExporter::flush(bool force) {
+  if (!m_sink || m_deferred || !m_offset)
+    return;
+
+  if (!force && m_offset < cMolExportFlushSize)
+    return;
+
+  if (!m_sink_failed && !m_sink(m_buffer, m_offset))
+    m_sink_failed = true;
+
+  m_offset = 0;
+}
+
+/*
+ * Formats the atom records collected by batchAtom(), in contiguous chunks
+ * on up to "max_threads" threads. Chunks are appended in order, so the
+ * output is identical to formatting them one by one.
+ */
+void MoleculeExporter::writeAtomBatch() {
+  const size_t n = m_atom_batch.size();
+  if (!n)
+    return;
+
+  const AtomRef * atoms = m_atom_batch.data();
+  int n_chunk = pymol::parallel_chunk_count(
+      SettingGetGlobal_i(G, cSetting_max_threads), n);
+
+  if (n_chunk < 2) {
+    formatAtoms(m_buffer, m_offset, atoms, atoms + n);
+  } else {
+    std::vector<pymol::vla<char>> buffers(n_chunk);
+    std::vector<int> sizes(n_chunk, 0);
+
+    pymol::parallel_for_chunks(n_chunk, n,
+        [&](int c, size_t begin, size_t end) {
+          buffers[c] = pymol::vla<char>(100 * (end - begin));
+          formatAtoms(buffers[c], sizes[c], atoms + begin, atoms + end);
+        });
+
+    for (int c = 0; c < n_chunk; ++c) {
+      m_buffer.check(m_offset + sizes[c]);
+      memcpy(m_buffer + m_offset, buffers[c], sizes[c]);
+      m_offset += sizes[c];
+    }
+  }
+
+  m_atom_batch.clear();
+
+  flush();
+}
+
 void MoleculeExporter::setRefObject(const char * ref_object, int ref_state) {
   double matrix[16];
 
@@ -462,8 +584,15 @@ struct MoleculeExporterPDB : public MoleculeExporter {
   }
 
   void writeAtom() {
-    CoordSetAtomToPDBStrVLA(G, &m_buffer, &m_offset, m_iter.getAtomInfo(),
-        m_coord, getTmpID() - 1, &m_pdb_info, m_mat_full.ptr);
+    batchAtom();
+  }
+
+  void formatAtoms(pymol::vla<char>& buffer, int& offset,
+      const AtomRef * begin, const AtomRef * end) {
+    for (auto atom = begin; atom != end; ++atom) {
+      CoordSetAtomToPDBStrVLA(G, &buffer, &offset, atom->ref,
+          atom->coord, atom->id - 1, &m_pdb_info, m_mat_full.ptr);
+    }
   }
 
   void writeBonds() {
@@ -659,7 +788,23 @@ struct MoleculeExporterCIF : public MoleculeExporter {
   }
 
   void writeAtom() {
-    const AtomInfoType * ai = m_iter.getAtomInfo();
+    batchAtom();
+  }
+
+  void formatAtoms(pymol::vla<char>& buffer, int& offset,
+      const AtomRef * begin, const AtomRef * end) {
+    // the shared formatter isn't thread-safe
+    CifDataValueFormatter cifrepr;
+    cifrepr.m_buf.resize(10);
+
+    for (auto atom = begin; atom != end; ++atom) {
+      formatAtom(buffer, offset, *atom, cifrepr);
+    }
+  }
+
+  virtual void formatAtom(pymol::vla<char>& buffer, int& offset,
+      const AtomRef& atom, CifDataValueFormatter& cifrepr) {
+    const AtomInfoType * ai = atom.ref;
     const char * entity_id = NULL;
 
 #ifdef _PYMOL_IP_PROPERTIES
@@ -673,13 +818,13 @@ struct MoleculeExporterCIF : public MoleculeExporter {
       entity_id = LexStr(G, ai->custom);
     }
 
-    m_offset += VLAprintf(m_buffer, m_offset,
+    offset += VLAprintf(buffer, offset,
         "%-6s %-3d %s %-3s " // type .. name
         "%s %-3s %s %s " // alt .. entity_id
         "%d %s %6.3f %6.3f %6.3f " // resv .. z
         "%4.2f %6.2f %d %s %d\n",  // q .. state
         ai->hetatm ? "HETATM" : "ATOM",
-        getTmpID(),
+        atom.id,
         cifrepr(ai->elem),
         cifrepr(LexStr(G, ai->name)),
         cifrepr(ai->alt),
@@ -688,10 +833,10 @@ struct MoleculeExporterCIF : public MoleculeExporter {
         cifrepr(entity_id),
         ai->resv,
         cifrepr(ai->inscode, "?"),
-        m_coord[0], m_coord[1], m_coord[2],
+        atom.coord[0], atom.coord[1], atom.coord[2],
         ai->q, ai->b, ai->formalCharge,
         cifrepr(LexStr(G, ai->chain)),
-        m_iter.state + 1);
+        m_atom_batch_state + 1);
   }
 
   void writeBonds() {
@@ -726,12 +871,13 @@ struct MoleculeExporterPMCIF : public MoleculeExporterCIF {
         "_atom_site.pymol_ss\n");
   }
 
-  void writeAtom() {
-    MoleculeExporterCIF::writeAtom();
+  void formatAtom(pymol::vla<char>& buffer, int& offset,
+      const AtomRef& atom, CifDataValueFormatter& cifrepr) {
+    MoleculeExporterCIF::formatAtom(buffer, offset, atom, cifrepr);
 
-    const AtomInfoType * ai = m_iter.getAtomInfo();
+    const AtomInfoType * ai = atom.ref;
 
-    m_offset += VLAprintf(m_buffer, m_offset,
+    offset += VLAprintf(buffer, offset,
         "%d %d %s\n",
         ai->color,
         ai->visRep,
@@ -953,6 +1099,7 @@ struct MoleculeExporterMOL2 : public MoleculeExporter {
 
     // defer until number of substructures known
     m_counts_offset = m_offset;
+    m_deferred = true;
     m_offset += VLAprintf(m_buffer, m_offset,
         "X X X                   \n" // deferred
         "SMALL\n"
@@ -998,6 +1145,7 @@ struct MoleculeExporterMOL2 : public MoleculeExporter {
     m_counts_offset += sprintf(m_buffer + m_counts_offset, "%d %d %d",
         m_n_atoms, (int) m_bonds.size(), (int) m_substs.size());
     m_buffer[m_counts_offset] = ' '; // overwrite terminator
+    m_deferred = false;
 
     // RTI BOND
     // bond_id origin_atom_id target_atom_id bond_type [status_bits]
@@ -1083,6 +1231,7 @@ struct MoleculeExporterMAE : public MoleculeExporter {
 
     // defer until number of atoms known
     m_n_atoms_offset = m_offset;
+    m_deferred = true;
 
     m_offset += VLAprintf(m_buffer, m_offset,
         "m_atom[X]            {\n" // place holder
@@ -1178,6 +1327,7 @@ struct MoleculeExporterMAE : public MoleculeExporter {
     // atom count
     m_n_atoms_offset += sprintf(m_buffer + m_n_atoms_offset, "m_atom[%d]", m_n_atoms);
     m_buffer[m_n_atoms_offset] = ' '; // overwrite terminator
+    m_deferred = false;
 
     if (!m_bonds.empty()) {
       // table with zero rows not allowed
@@ -1244,9 +1394,27 @@ struct MoleculeExporterXYZ : public MoleculeExporter {
   void beginMolecule() {
     MoleculeExporter::beginMolecule();
 
-    // defer until number of atoms known
     m_n_atoms = 0;
+
+    if (m_multi == cMolExportByCoordSet) {
+      // one coordinate set, count in advance so nothing has to be deferred
+      const auto cs = m_iter.cs;
+      const auto ai = m_iter.obj->AtomInfo;
+      int n_atoms = 0;
+      for (int idx = 0; idx < cs->NIndex; ++idx) {
+        if (SelectorIsMember(G, ai[cs->IdxToAtm[idx]].selEntry, m_sele))
+          ++n_atoms;
+      }
+
+      m_n_atoms_offset = -1;
+      m_offset += VLAprintf(m_buffer, m_offset, "%-10d\n%s\n",
+          n_atoms, getTitleOrName());
+      return;
+    }
+
+    // defer until number of atoms known
     m_n_atoms_offset = m_offset;
+    m_deferred = true;
 
     m_offset += VLAprintf(m_buffer, m_offset,
         "X         \n" // natoms (deferred)
@@ -1255,18 +1423,26 @@ struct MoleculeExporterXYZ : public MoleculeExporter {
   }
 
   void writeAtom() {
-    const auto ai = m_iter.getAtomInfo();
-
-    m_offset += VLAprintf(m_buffer, m_offset,
-        "%s %f %f %f\n", ai->elem, m_coord[0], m_coord[1], m_coord[2]);
-
+    batchAtom();
     ++m_n_atoms;
   }
 
+  void formatAtoms(pymol::vla<char>& buffer, int& offset,
+      const AtomRef * begin, const AtomRef * end) {
+    for (auto atom = begin; atom != end; ++atom) {
+      offset += VLAprintf(buffer, offset, "%s %f %f %f\n", atom->ref->elem,
+          atom->coord[0], atom->coord[1], atom->coord[2]);
+    }
+  }
+
   void writeBonds() {
+    if (m_n_atoms_offset < 0)
+      return;
+
     // atom count
     m_n_atoms_offset += sprintf(m_buffer + m_n_atoms_offset, "%d", m_n_atoms);
     m_buffer[m_n_atoms_offset] = ' '; // overwrite terminator
+    m_deferred = false;
   }
 
   bool isExcludedBond(int atm1, int atm2) {
@@ -1378,6 +1554,92 @@ public:
 
 /*========================================================================*/
 
+/*
+ * Create an exporter for the given format, or NULL if the format is not
+ * known.
+ */
+static MoleculeExporter * MoleculeExporterNew(PyMOLGlobals * G,
+    const char *format)
+{
+  if (strcmp(format, "pdb") == 0) {
+    return new MoleculeExporterPDB;
+  } else if (strcmp(format, "pmcif") == 0) {
+    return new MoleculeExporterPMCIF;
+  } else if (strcmp(format, "cif") == 0) {
+    return new MoleculeExporterCIF;
+  } else if (strcmp(format, "sdf") == 0) {
+    return new MoleculeExporterSDF;
+  } else if (strcmp(format, "pqr") == 0) {
+    return new MoleculeExporterPQR;
+  } else if (strcmp(format, "mol2") == 0) {
+    return new MoleculeExporterMOL2;
+  } else if (strcmp(format, "mol") == 0) {
+    return new MoleculeExporterMOL;
+  } else if (strcmp(format, "xyz") == 0) {
+    return new MoleculeExporterXYZ;
+  } else if (strcmp(format, "mae") == 0) {
+    return new MoleculeExporterMAE;
+  } else if (strcmp(format, "mmtf") == 0) {
+#ifndef _PYMOL_NO_MSGPACKC
+    return new MoleculeExporterMMTF;
+#else
+    PRINTFB(G, FB_ObjectMolecule, FB_Errors)
+      " Error: This build has no fast MMTF support.\n" ENDFB(G);
+    return nullptr;
+#endif
+  }
+
+  PRINTFB(G, FB_ObjectMolecule, FB_Errors)
+    " Error: unknown format: '%s'\n", format ENDFB(G);
+  return nullptr;
+}
+
+/*
+ * Run the export. With a sink, the file contents are streamed to it,
+ * otherwise they are left in the returned exporter's "m_buffer".
+ *
+ * Returns NULL if the selection or format is invalid.
+ */
+static std::unique_ptr<MoleculeExporter> MoleculeExporterRun(
+    PyMOLGlobals * G,
+    const char *format,
+    const char *selection,
+    int state,
+    const char *ref_object,
+    int ref_state,
+    int multi,
+    const std::function<bool(const char *, size_t)>& sink)
+{
+  SelectorTmp tmpsele1(G, selection);
+  int sele = tmpsele1.getIndex();
+
+  if (sele < 0)
+    return nullptr;
+
+  if (ref_state < -1)
+   ref_state = state;
+
+  // do "effective" current states
+  if (state == -2)
+    state = -3;
+
+  std::unique_ptr<MoleculeExporter> exporter(MoleculeExporterNew(G, format));
+  if (!exporter)
+    return nullptr;
+
+  // Ensure "." decimal point in printf. It's possible to change this from
+  // Python, so don't rely on a persistent global value.
+  std::setlocale(LC_NUMERIC, "C");
+
+  exporter->init(G);
+  exporter->m_sink = sink;
+  exporter->setMulti(multi);
+  exporter->setRefObject(ref_object, ref_state);
+  exporter->execute(sele, state);
+
+  return exporter;
+}
+
 /*
  * Export the given selection to a molecular file format.
  *
@@ -1405,63 +1667,87 @@ pymol::vla<char> MoleculeExporterGetStr(PyMOLGlobals * G,
     int multi,
     bool quiet)
 {
-  SelectorTmp tmpsele1(G, selection);
-  int sele = tmpsele1.getIndex();
+  auto exporter = MoleculeExporterRun(G, format, selection, state,
+      ref_object, ref_state, multi, nullptr);
 
-  if (sele < 0)
+  if (!exporter)
     return nullptr;
 
-  std::unique_ptr<MoleculeExporter> exporter;
+  return std::move(exporter->m_buffer);
+}
 
-  if (ref_state < -1)
-   ref_state = state;
+/*
+ * Like MoleculeExporterGetStr, but hand the file contents to `sink` in
+ * pieces of bounded size while exporting, so the complete file never has
+ * to be held in memory (except for formats which need a whole molecule
+ * to write its header, like MOL2 and MAE).
+ *
+ * Returns false if the selection or format is invalid or if the sink
+ * returned false.
+ */
+bool MoleculeExporterWrite(PyMOLGlobals * G,
+    const std::function<bool(const char *, size_t)>& sink,
+    const char *format,
+    const char *selection,
+    int state,
+    const char *ref_object,
+    int ref_state,
+    int multi,
+    bool quiet)
+{
+  auto exporter = MoleculeExporterRun(G, format, selection, state,
+      ref_object, ref_state, multi, sink);
 
-  // do "effective" current states
-  if (state == -2)
-    state = -3;
+  return exporter && !exporter->m_sink_failed;
+}
 
-  if (strcmp(format, "pdb") == 0) {
-    exporter.reset(new MoleculeExporterPDB);
-  } else if (strcmp(format, "pmcif") == 0) {
-    exporter.reset(new MoleculeExporterPMCIF);
-  } else if (strcmp(format, "cif") == 0) {
-    exporter.reset(new MoleculeExporterCIF);
-  } else if (strcmp(format, "sdf") == 0) {
-    exporter.reset(new MoleculeExporterSDF);
-  } else if (strcmp(format, "pqr") == 0) {
-    exporter.reset(new MoleculeExporterPQR);
-  } else if (strcmp(format, "mol2") == 0) {
-    exporter.reset(new MoleculeExporterMOL2);
-  } else if (strcmp(format, "mol") == 0) {
-    exporter.reset(new MoleculeExporterMOL);
-  } else if (strcmp(format, "xyz") == 0) {
-    exporter.reset(new MoleculeExporterXYZ);
-  } else if (strcmp(format, "mae") == 0) {
-    exporter.reset(new MoleculeExporterMAE);
-  } else if (strcmp(format, "mmtf") == 0) {
-#ifndef _PYMOL_NO_MSGPACKC
-    exporter.reset(new MoleculeExporterMMTF);
-#else
+/*
+ * Export to a file, see MoleculeExporterWrite. The file is only opened
+ * (and truncated, unless `append` is true) once the export has started.
+ */
+bool MoleculeExporterWriteFile(PyMOLGlobals * G,
+    const char *filename,
+    bool append,
+    const char *format,
+    const char *selection,
+    int state,
+    const char *ref_object,
+    int ref_state,
+    int multi,
+    bool quiet)
+{
+  FILE *fp = NULL;
+  bool open_failed = false;
+
+  auto fopen_once = [&]() {
+    if (!fp && !open_failed) {
+      fp = fopen(filename, append ? "ab" : "wb");
+      open_failed = !fp;
+    }
+    return fp;
+  };
+
+  bool ok = MoleculeExporterWrite(G,
+      [&](const char *data, size_t size) {
+        return fopen_once() && fwrite(data, 1, size, fp) == size;
+      }, format, selection, state, ref_object, ref_state, multi, quiet);
+
+  // empty output still creates the file
+  if (ok)
+    ok = fopen_once() != NULL;
+
+  if (fp && fclose(fp) != 0)
+    ok = false;
+
+  if (open_failed) {
     PRINTFB(G, FB_ObjectMolecule, FB_Errors)
-      " Error: This build has no fast MMTF support.\n" ENDFB(G);
-    return nullptr;
-#endif
-  } else {
+      " Error: cannot open file '%s' for writing\n", filename ENDFB(G);
+  } else if (fp && !ok) {
     PRINTFB(G, FB_ObjectMolecule, FB_Errors)
-      " Error: unknown format: '%s'\n", format ENDFB(G);
-    return nullptr;
+      " Error: writing '%s' failed\n", filename ENDFB(G);
   }
 
-  // Ensure "." decimal point in printf. It's possible to change this from
-  // Python, so don't rely on a persistent global value.
-  std::setlocale(LC_NUMERIC, "C");
-
-  exporter->init(G);
-  exporter->setMulti(multi);
-  exporter->setRefObject(ref_object, ref_state);
-  exporter->execute(sele, state);
-
-  return std::move(exporter->m_buffer);
+  return ok;
 }
 
 /*========================================================================*/
@@ -4,6 +4,8 @@
  * (c) 2016 Schrodinger, Inc.
  */
 
+#include <functional>
+
 #include "os_python.h"
 #include "os_std.h"
 #include "vla.h"
@@ -19,5 +21,26 @@ pymol::vla<char> MoleculeExporterGetStr(PyMOLGlobals * G,
     int multi=-1,
     bool quiet=true);
 
+bool MoleculeExporterWrite(PyMOLGlobals * G,
+    const std::function<bool(const char *, size_t)>& sink,
+    const char *format,
+    const char *sele="all",
+    int state=-2,
+    const char *ref_object="",
+    int ref_state=-1,
+    int multi=-1,
+    bool quiet=true);
+
+bool MoleculeExporterWriteFile(PyMOLGlobals * G,
+    const char *filename,
+    bool append,
+    const char *format,
+    const char *sele="all",
+    int state=-2,
+    const char *ref_object="",
+    int ref_state=-1,
+    int multi=-1,
+    bool quiet=true);
+
 PyObject *MoleculeExporterGetPyBonds(PyMOLGlobals * G,
     const char *selection, int state);
@@ -14,6 +14,9 @@ I* Additional authors of this source file include:
 -*
 Z* -------------------------------------------------------------------
 */
+#include <utility>
+#include <vector>
+
 #include"os_python.h"
 #include "os_std.h"
 #include "MemoryDebug.h"
@@ -21,6 +24,7 @@ Z* -------------------------------------------------------------------
 #include "PlugIOManager.h"
 #include "Selector.h"
 #include "CoordSet.h"
+#include "RepCache.h"
 #include "Feedback.h"
 #include "Scene.h"
 #include "Executive.h"
@@ -28,6 +32,8 @@ Z* -------------------------------------------------------------------
 #include "Lex.h"
 #include "CGO.h"
 #include "ObjectCGO.h"
+#include "AtomIterators.h"
+#include "Vector.h"
 
 #ifndef _PYMOL_VMD_PLUGINS
 int PlugIOManagerInit(PyMOLGlobals * G)
@@ -87,6 +93,16 @@ CObject * PlugIOManagerLoad(PyMOLGlobals * G, CObject ** obj_ptr,
   return 0;
 }
 
+int PlugIOManagerSaveTraj(PyMOLGlobals * G, const char *fname,
+    const char *sele, int start, int stop, int interval, int quiet,
+    const char *plugin_type)
+{
+  PRINTFB(G, FB_ObjectMolecule, FB_Errors)
+    " ObjectMolecule-Error: sorry, VMD Molfile Plugins not compiled into this build.\n"
+    ENDFB(G);
+  return 0;
+}
+
 #else
 
 #include "molfile_plugin.h"
@@ -209,6 +225,7 @@ int PlugIOManagerLoadTraj(PyMOLGlobals * G, ObjectMolecule * obj,
       } else {
         ok_assert(1, cs = CoordSetNew(G));
         ok_assert(1, cs->Coord = VLAlloc(float, 3 * natoms));
+        VLASetTag(cs->Coord, cMemoryCoords);
 
         cs->Obj = obj;
         cs->NIndex = natoms;
@@ -256,6 +273,7 @@ int PlugIOManagerLoadTraj(PyMOLGlobals * G, ObjectMolecule * obj,
 
 		  /* make sure we have room for 'frame' CoordSet*'s in obj->CSet */
 		  /* TODO: TEST this function */
+                  RepCacheJoinObject(G, obj);
                   VLACheck(obj->CSet, CoordSet*, frame); /* was CoordSet* */
 		  /* bump the object's state count */
                   if(obj->NCSet <= frame) obj->NCSet = frame + 1;
@@ -626,6 +644,7 @@ ObjectMolecule *PlugIOManagerLoadMol(PyMOLGlobals * G, ObjectMolecule *origObj,
   while (/* true */ plugin->read_next_timestep != NULL) {
     ok_assert(1, cs = CoordSetNew(G));
     ok_assert(1, cs->Coord = VLAlloc(float, 3 * natoms));
+    VLASetTag(cs->Coord, cMemoryCoords);
 
     timestep.coords = cs->Coord;
     timestep.velocities = NULL;
@@ -648,6 +667,7 @@ ObjectMolecule *PlugIOManagerLoadMol(PyMOLGlobals * G, ObjectMolecule *origObj,
   if (!I->NCSet) {
     ok_assert(1, cs = CoordSetNew(G));
     ok_assert(1, cs->Coord = VLAlloc(float, 3 * natoms));
+    VLASetTag(cs->Coord, cMemoryCoords);
 
     cs->Obj = I;
     cs->NIndex = natoms;
@@ -921,6 +941,166 @@ ok_except1:
   return NULL;
 }
 
+/*
+ * State of `obj` to write for trajectory frame `state`: single-state
+ * objects are static (like in the viewer) if static_singletons is on
+ */
+static int SaveTrajObjectState(ObjectMolecule * obj, int state)
+{
+  if(obj->NCSet == 1 &&
+     SettingGet_b(obj->Obj.G, obj->Obj.Setting, NULL, cSetting_static_singletons))
+    return 0;
+  return state;
+}
+
+/*
+ * Write the coordinates of the atoms in `sele` as a trajectory, one frame
+ * per state, streaming frame by frame. States start, start + interval, ...
+ * up to stop (0-based, stop < 0 for the last state) are written; states in
+ * which not all atoms have coordinates are skipped. Single-state objects
+ * contribute their only state to every frame if static_singletons is on.
+ *
+ * Like "save", object state matrices are applied to the coordinates.
+ */
+int PlugIOManagerSaveTraj(PyMOLGlobals * G, const char *fname,
+    const char *sele, int start, int stop, int interval, int quiet,
+    const char *plugin_type)
+{
+  CPlugIOManager *I = G->PlugIOManager;
+  molfile_plugin_t *plugin = NULL;
+  void *file_handle = NULL;
+  molfile_timestep_t timestep;
+  std::vector<std::pair<ObjectMolecule *, int> > atoms;
+  std::vector<float> coords;
+  int n_state = 0, n_frame = 0, n_skip = 0;
+  int ok = true;
+
+  ok_assert(1, I);
+  plugin = find_plugin(I, plugin_type);
+
+  if(!plugin) {
+    PRINTFB(G, FB_ObjectMolecule, FB_Errors)
+      " PlugIOManager: unable to locate plugin '%s'\n", plugin_type ENDFB(G);
+    return false;
+  }
+
+  // writers with a structure (pdb, xyz, ...) need write_structure first
+  if(plugin->write_timestep == NULL || plugin->write_structure) {
+    PRINTFB(G, FB_ObjectMolecule, FB_Errors)
+      " PlugIOManager: plugin '%s' can't write trajectories\n", plugin_type ENDFB(G);
+    return false;
+  }
+
+  // atoms in selection order (grouped by object)
+  for(SeleAtomIterator iter(G, sele); iter.next();) {
+    atoms.emplace_back(iter.obj, iter.getAtm());
+    if(n_state < iter.obj->NCSet)
+      n_state = iter.obj->NCSet;
+  }
+
+  if(atoms.empty()) {
+    PRINTFB(G, FB_ObjectMolecule, FB_Errors)
+      " PlugIOManager: no atoms selected\n" ENDFB(G);
+    return false;
+  }
+
+  if(start < 0)
+    start = 0;
+  if(stop < 0 || stop >= n_state)
+    stop = n_state - 1;
+  if(interval < 1)
+    interval = 1;
+
+  file_handle = plugin->open_file_write(fname, plugin_type, atoms.size());
+
+  if(!file_handle) {
+    PRINTFB(G, FB_ObjectMolecule, FB_Errors)
+      " PlugIOManager: plugin '%s' cannot open '%s'.\n", plugin_type, fname ENDFB(G);
+    return false;
+  }
+
+  coords.resize(3 * atoms.size());
+  memset(&timestep, 0, sizeof(timestep));
+  timestep.coords = coords.data();
+
+  for(int state = start; ok && state <= stop; state += interval) {
+    ObjectMolecule *obj = NULL;
+    CoordSet *cs = NULL;
+    int obj_state = state;
+    double matrix[16];
+    bool has_matrix = false;
+    float *v = coords.data();
+
+    for(auto it = atoms.begin(); it != atoms.end(); ++it, v += 3) {
+      if(obj != it->first) {
+        obj = it->first;
+        obj_state = SaveTrajObjectState(obj, state);
+        cs = (obj_state < obj->NCSet) ? obj->CSet[obj_state] : NULL;
+        has_matrix = cs &&
+          ObjectGetTotalMatrix(&obj->Obj, obj_state, false, matrix);
+      }
+
+      int idx = cs ? cs->atmToIdx(it->second) : -1;
+      if(idx < 0)
+        break;
+
+      if(has_matrix)
+        transform44d3f(matrix, cs->Coord + 3 * idx, v);
+      else
+        copy3f(cs->Coord + 3 * idx, v);
+    }
+
+    if(v != coords.data() + coords.size()) {
+      n_skip++;
+      continue;
+    }
+
+    // unit cell of the first object
+    obj = atoms.front().first;
+    obj_state = SaveTrajObjectState(obj, state);
+    cs = (obj_state < obj->NCSet) ? obj->CSet[obj_state] : NULL;
+    CSymmetry *sym = (cs && cs->Symmetry) ? cs->Symmetry : obj->Symmetry;
+    if(sym && sym->Crystal) {
+      timestep.A = sym->Crystal->Dim[0];
+      timestep.B = sym->Crystal->Dim[1];
+      timestep.C = sym->Crystal->Dim[2];
+      timestep.alpha = sym->Crystal->Angle[0];
+      timestep.beta  = sym->Crystal->Angle[1];
+      timestep.gamma = sym->Crystal->Angle[2];
+    } else {
+      timestep.A = timestep.B = timestep.C = 0.f;
+      timestep.alpha = timestep.beta = timestep.gamma = 90.f;
+    }
+
+    timestep.physical_time = state;
+
+    if(plugin->write_timestep(file_handle, &timestep) != MOLFILE_SUCCESS) {
+      PRINTFB(G, FB_ObjectMolecule, FB_Errors)
+        " PlugIOManager: writing state %d to '%s' failed\n", state + 1, fname ENDFB(G);
+      ok = false;
+    } else {
+      n_frame++;
+    }
+  }
+
+  plugin->close_file_write(file_handle);
+
+  if(n_skip) {
+    PRINTFB(G, FB_ObjectMolecule, FB_Warnings)
+      " PlugIOManager: skipped %d states with missing coordinates\n", n_skip ENDFB(G);
+  }
+
+  if(ok && !quiet) {
+    PRINTFB(G, FB_ObjectMolecule, FB_Actions)
+      " PlugIOManager: wrote %d frames of %d atoms to '%s'.\n",
+      n_frame, (int) atoms.size(), fname ENDFB(G);
+  }
+
+  return ok;
+ok_except1:
+  return false;
+}
+
 #ifdef __cplusplus
 }
 #endif
@@ -931,7 +1111,8 @@ ok_except1:
  * Find a plugin by filename extension
  *
  * ext: File extension
- * mask: plugin needs to read any content (0), structure (1), trajectory (2) or map (4)
+ * mask: plugin needs to read any content (0), structure (1), trajectory (2)
+ *       or map (4), or write coordinate-only trajectories (16)
  */
 const char * PlugIOManagerFindPluginByExt(PyMOLGlobals * G, const char * ext, int mask) {
 #ifdef _PYMOL_VMD_PLUGINS
@@ -949,7 +1130,8 @@ const char * PlugIOManagerFindPluginByExt(PyMOLGlobals * G, const char * ext, in
     if (((mask & 0x1) && p->read_structure) ||
         ((mask & 0x2) && p->read_next_timestep) ||
         ((mask & 0x4) && p->read_volumetric_data) ||
-        ((mask & 0x8) && p->read_rawgraphics))
+        ((mask & 0x8) && p->read_rawgraphics) ||
+        ((mask & 0x10) && p->write_timestep && !p->write_structure))
       return p->name;
   }
 #endif
@@ -41,6 +41,9 @@ ObjectMolecule *PlugIOManagerLoadMol(PyMOLGlobals * G, ObjectMolecule *origObj,
     const char *fname, int state, int quiet, const char *plugin_type);
 CObject * PlugIOManagerLoad(PyMOLGlobals * G, CObject ** obj_ptr,
     const char *fname, int state, int quiet, const char *plugin_type);
+int PlugIOManagerSaveTraj(PyMOLGlobals * G, const char *fname,
+    const char *sele, int start, int stop, int interval, int quiet,
+    const char *plugin_type);
 
 #ifdef __cplusplus
 }
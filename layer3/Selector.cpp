@@ -14,6 +14,8 @@ I* Additional authors of this source file include:
 Z* -------------------------------------------------------------------
 */
 
+#include <map>
+#include <string>
 #include <vector>
 
 #include"os_python.h"
@@ -44,6 +46,8 @@ Z* -------------------------------------------------------------------
 #include"Seeker.h"
 #include "Lex.h"
 #include "Mol2Typing.h"
+#include "Parallel.h"
+#include "PyMOL.h"
 
 #include"OVContext.h"
 #include"OVLexicon.h"
@@ -157,12 +161,14 @@ static int SelectorLogic2(PyMOLGlobals * G, EvalElem * base);
 static int SelectorOperator22(PyMOLGlobals * G, EvalElem * base, int state);
 static int *SelectorEvaluate(PyMOLGlobals * G, SelectorWordType * word, int state, int quiet);
 static SelectorWordType *SelectorParse(PyMOLGlobals * G, const char *s);
-static void SelectorPurgeMembers(PyMOLGlobals * G, int sele);
+static void SelectorPurgeMembers(PyMOLGlobals * G, int sele,
+                                 const SelectionInfoRec * info = NULL);
 static int SelectorEmbedSelection(PyMOLGlobals * G, int *atom, const char *name,
                                   ObjectMolecule * obj, int no_dummies, int exec_manage);
 static int *SelectorGetIndexVLA(PyMOLGlobals * G, int sele);
 static int *SelectorGetIndexVLAImpl(PyMOLGlobals * G, CSelector *I, int sele);
 static void SelectorClean(PyMOLGlobals * G);
+static void SelectorReleaseTable(PyMOLGlobals * G);
 static void SelectorCleanImpl(PyMOLGlobals * G, CSelector *I);
 static int *SelectorApplyMultipick(PyMOLGlobals * G, Multipick * mp);
 static int SelectorCheckNeighbors(PyMOLGlobals * G, int maxDepth, ObjectMolecule * obj,
@@ -706,6 +712,286 @@ static short fcmp(float a, float b, int oper) {
   return false;
 }
 
+/*========================================================================*/
+/*
+ * Evaluates `pred(ai)` for the table atoms [a0, a1) in parallel chunks
+ * (see "max_threads") and stores the result in `sele`.
+ *
+ * Returns the number of selected atoms.
+ */
+template <typename Pred>
+static int SelectorSelectParallel(PyMOLGlobals * G, int *sele, int a0, int a1,
+                                  Pred pred)
+{
+  CSelector *I = G->Selector;
+  const TableRec *i_table = I->Table;
+  ObjectMolecule * const *i_obj = I->Obj;
+  int n_chunk = pymol::parallel_chunk_count(
+      SettingGetGlobal_i(G, cSetting_max_threads), a1 - a0);
+  std::vector<int> count(n_chunk, 0);
+
+  pymol::parallel_for_chunks(n_chunk, a1 - a0,
+      [&](int chunk, size_t begin, size_t end) {
+        int c = 0;
+        for(int a = a0 + begin, a_end = a0 + end; a < a_end; ++a) {
+          const TableRec *rec = i_table + a;
+          if((sele[a] = pred(i_obj[rec->model]->AtomInfo + rec->atom)))
+            c++;
+        }
+        count[chunk] = c;
+      });
+
+  int c = 0;
+  for(int chunk_count : count)
+    c += chunk_count;
+  return c;
+}
+
+/*
+ * Float property comparison with the operator switch hoisted out of
+ * the atom loop, so the inner loops are plain compares.
+ */
+template <typename Getter>
+static int SelectorSelectFloatCmp(PyMOLGlobals * G, int *sele, int oper,
+                                  float comp1, Getter get)
+{
+  CSelector *I = G->Selector;
+  switch (oper) {
+  case SCMP_GTHN:
+    return SelectorSelectParallel(G, sele, cNDummyAtoms, I->NAtom,
+        [&](const AtomInfoType * ai) { return get(ai) > comp1; });
+  case SCMP_LTHN:
+    return SelectorSelectParallel(G, sele, cNDummyAtoms, I->NAtom,
+        [&](const AtomInfoType * ai) { return get(ai) < comp1; });
+  case SCMP_EQAL:
+    return SelectorSelectParallel(G, sele, cNDummyAtoms, I->NAtom,
+        [&](const AtomInfoType * ai) { return fabs(get(ai) - comp1) < R_SMALL4; });
+  }
+  return 0;
+}
+
+/*
+ * Selects the table atoms [a0, a1) whose lexicon-backed property (name,
+ * resn, chain, ...) satisfies `match(const char*)`.
+ *
+ * Atoms share few distinct strings, so instead of matching every atom,
+ * the distinct lexicon ids are collected (in parallel chunks), each id is
+ * matched exactly once, and the atoms are then selected by table lookup.
+ *
+ * Returns the number of selected atoms.
+ */
+template <typename Getter, typename Match>
+static int SelectorSelectByLexIdx(PyMOLGlobals * G, int *sele, int a0, int a1,
+                                  Getter get, Match match)
+{
+  CSelector *I = G->Selector;
+  const TableRec *i_table = I->Table;
+  ObjectMolecule * const *i_obj = I->Obj;
+  int n_chunk = pymol::parallel_chunk_count(
+      SettingGetGlobal_i(G, cSetting_max_threads), a1 - a0);
+
+  // distinct lexicon ids per chunk
+  std::vector<std::vector<char>> seen(n_chunk);
+  pymol::parallel_for_chunks(n_chunk, a1 - a0,
+      [&](int chunk, size_t begin, size_t end) {
+        auto& seen_chunk = seen[chunk];
+        for(int a = a0 + begin, a_end = a0 + end; a < a_end; ++a) {
+          const TableRec *rec = i_table + a;
+          size_t idx = get(i_obj[rec->model]->AtomInfo + rec->atom);
+          if(idx >= seen_chunk.size())
+            seen_chunk.resize(idx + 1, 0);
+          seen_chunk[idx] = 1;
+        }
+      });
+
+  // match each distinct string once (matchers are not thread safe)
+  std::vector<signed char> hit;
+  for(auto& seen_chunk : seen) {
+    if(hit.size() < seen_chunk.size())
+      hit.resize(seen_chunk.size(), -1);
+    for(size_t idx = 0; idx < seen_chunk.size(); ++idx) {
+      if(seen_chunk[idx] && hit[idx] < 0)
+        hit[idx] = match(LexStr(G, idx)) ? 1 : 0;
+    }
+  }
+
+  return SelectorSelectParallel(G, sele, a0, a1,
+      [&](const AtomInfoType * ai) { return hit[get(ai)] > 0; });
+}
+
+/*
+ * Element symbol variant of SelectorSelectByLexIdx. Elements are stored
+ * inline (not in the lexicon) and there are only a handful of distinct
+ * values, so a small list of resolved symbols is sufficient.
+ */
+static int SelectorSelectByElem(PyMOLGlobals * G, int *sele,
+                                CWordMatcher * matcher)
+{
+  CSelector *I = G->Selector;
+  std::vector<std::pair<std::string, bool>> resolved;
+
+  for(SelectorAtomIterator iter(I); iter.next();) {
+    const char *elem = iter.getAtomInfo()->elem;
+    auto it = resolved.begin();
+    for(; it != resolved.end() && it->first != elem; ++it);
+    if(it == resolved.end())
+      resolved.emplace_back(elem, WordMatcherMatchAlpha(matcher, elem) != 0);
+  }
+
+  return SelectorSelectParallel(G, sele, cNDummyAtoms, I->NAtom,
+      [&](const AtomInfoType * ai) {
+        for(auto& item : resolved)
+          if(item.first == ai->elem)
+            return item.second;
+        return false;
+      });
+}
+
+/*========================================================================*/
+#define cSelectorEvalCacheSize 32
+
+/*
+ * Keywords which only depend on atom properties (and the table layout),
+ * but not on coordinates, states, object names or named selections.
+ */
+static bool SelectorEvalCacheable(int code)
+{
+  switch (code) {
+  case SELE_NAMs:
+  case SELE_ELEs:
+  case SELE_RSNs:
+  case SELE_RSIs:
+  case SELE_CHNs:
+  case SELE_SEGs:
+  case SELE_CUST:
+  case SELE_LABs:
+  case SELE_ALTs:
+  case SELE_TTYs:
+  case SELE_SSTs:
+  case SELE_IDXs:
+  case SELE_ID_s:
+  case SELE_RNKs:
+  case SELE_NTYs:
+  case SELE_FLGs:
+  case SELE_BVLx:
+  case SELE_QVLx:
+  case SELE_PCHx:
+  case SELE_FCHx:
+    return true;
+  }
+  return false;
+}
+
+static std::string SelectorEvalCacheKey(const EvalElem * base, int n_arg)
+{
+  std::string key(std::to_string(base->code));
+  for(int i = 1; i <= n_arg; ++i) {
+    key += '\0';
+    key += base[i].text;
+  }
+  return key;
+}
+
+/*
+ * Restore a memoized keyword result into `base->sele` (must be allocated
+ * and zeroed). Returns false if there is no valid entry.
+ */
+static bool SelectorEvalCacheRecall(PyMOLGlobals * G, EvalElem * base, int n_arg)
+{
+  CSelector *I = G->Selector;
+  SelectorEvalCache *cache = I->EvalCache;
+  if(!cache || !SelectorEvalCacheable(base->code))
+    return false;
+
+  auto key = SelectorEvalCacheKey(base, n_arg);
+  for(auto it = cache->entries.begin(); it != cache->entries.end(); ++it) {
+    if(it->key != key)
+      continue;
+    if(it->sele.size() != I->NAtom)
+      break;
+
+    // move to front (least recently used entries get dropped)
+    cache->entries.splice(cache->entries.begin(), cache->entries, it);
+
+    const auto& sele = it->sele;
+    for(int a = cNDummyAtoms; a < I->NAtom; ++a)
+      base->sele[a] = sele[a];
+
+    PRINTFD(G, FB_Selector)
+      " SelectorEvalCacheRecall: reusing result for code %x\n", base->code ENDFD;
+    return true;
+  }
+  return false;
+}
+
+static void SelectorEvalCacheStore(PyMOLGlobals * G, const EvalElem * base, int n_arg)
+{
+  CSelector *I = G->Selector;
+  SelectorEvalCache *cache = I->EvalCache;
+  if(!cache || !SelectorEvalCacheable(base->code))
+    return;
+
+  if(cache->entries.size() >= cSelectorEvalCacheSize)
+    cache->entries.pop_back();
+
+  cache->entries.push_front(SelectorEvalCache::Entry());
+  auto& entry = cache->entries.front();
+  entry.key = SelectorEvalCacheKey(base, n_arg);
+  entry.sele.assign(base->sele, base->sele + I->NAtom);
+}
+
+/*
+ * Must be called whenever atom properties which can be used in selection
+ * expressions may have changed (alter, label, dss, atom editing, ...)
+ */
+void SelectorInvalidateEvalCache(PyMOLGlobals * G)
+{
+  CSelector *I = G->Selector;
+  if(pymol::is_detached())
+    return;                     /* new objects are not in the cache yet */
+  if(I && I->EvalCache)
+    I->EvalCache->entries.clear();
+}
+
+/*
+ * Drops the memoized results if the table layout changed. `layout` is a
+ * signature of the table which the caller derives from the per-object
+ * generation counters (see SelectorEvalCacheLayout), zero means unknown.
+ */
+static void SelectorEvalCacheCheckTable(CSelector * I, uint64_t layout)
+{
+  if(!I->EvalCache)
+    return;
+
+  if(!layout || I->EvalCache->table_hash != layout) {
+    I->EvalCache->table_hash = layout;
+    I->EvalCache->entries.clear();
+  }
+}
+
+/*
+ * FNV-1a over the table segments, O(number of objects)
+ */
+static uint64_t SelectorEvalCacheLayout(
+    const std::vector<SelectorTableSegment> & segments)
+{
+  uint64_t hash = 14695981039346656037ULL;
+  auto mix = [&hash](uint64_t value) {
+    hash = (hash ^ value) * 1099511628211ULL;
+  };
+  for(auto & seg : segments) {
+    mix((uintptr_t) seg.obj);
+    mix(seg.generation);
+    mix(seg.n_atom);
+    mix(seg.state);
+    mix((uintptr_t) seg.cs);
+    mix(seg.cs_n_index);
+    mix(seg.start);
+    mix(seg.count);
+  }
+  return hash ? hash : 1;
+}
+
 #define cINTER_ENTRIES 11
 
 int SelectorRenameObjectAtoms(PyMOLGlobals * G, ObjectMolecule * obj, int sele, int force,
@@ -736,6 +1022,7 @@ int SelectorRenameObjectAtoms(PyMOLGlobals * G, ObjectMolecule * obj, int sele,
         return 0;
       }
       result = ObjectMoleculeRenameAtoms(obj, flag, force);
+      SelectorInvalidateEvalCache(G);
     }
     FreeP(flag);
   }
@@ -1154,6 +1441,14 @@ static int IntInOrder(int *list, int a, int b)
   return (list[a] <= list[b]);
 }
 
+static std::string SelectorFoldName(const char *name)
+{
+  std::string folded(name);
+  for(auto & c : folded)
+    c = tolower(c);
+  return folded;
+}
+
 static int SelectorAddName(PyMOLGlobals * G, int index)
 {
   CSelector *I = G->Selector;
@@ -1162,6 +1457,7 @@ static int SelectorAddName(PyMOLGlobals * G, int index)
   OVstatus status;
   if(OVreturn_IS_OK((result = OVLexicon_GetFromCString(I->Lex, I->Name[index])))) {
     if(OVreturn_IS_OK((status = OVOneToOne_Set(I->NameOffset, result.word, index)))) {
+      (*I->FoldedNames)[SelectorFoldName(I->Name[index])]++;
       ok = true;
     }
   }
@@ -1176,6 +1472,9 @@ static int SelectorDelName(PyMOLGlobals * G, int index)
   if(OVreturn_IS_OK((result = OVLexicon_BorrowFromCString(I->Lex, I->Name[index])))) {
     if(OVreturn_IS_OK(OVLexicon_DecRef(I->Lex, result.word)) &&
        OVreturn_IS_OK(OVOneToOne_DelForward(I->NameOffset, result.word))) {
+      auto it = I->FoldedNames->find(SelectorFoldName(I->Name[index]));
+      if(it != I->FoldedNames->end() && !--it->second)
+        I->FoldedNames->erase(it);
       ok = true;
     }
   }
@@ -1642,6 +1941,12 @@ static ov_diff SelectGetNameOffset(PyMOLGlobals * G, const char *name, ov_size m
       }
     }
   }
+  if(result < 0 && !strchr(name, '*') && strlen(name) + 1 <= minMatch) {
+    /* without wildcards and partial matches, only a case variant of a
+       known name can still match */
+    if(!ignCase || !I->FoldedNames->count(SelectorFoldName(name)))
+      return result;
+  }
   if(result < 0) {              /* not found, so try partial/ignored-case match */
 
     int offset, wm, best_match, best_offset;
@@ -1745,7 +2050,7 @@ void SelectorSelectByID(PyMOLGlobals * G, const char *name, ObjectMolecule * obj
   SelectorEmbedSelection(G, atom, name, NULL, true, -1);
   FreeP(atom);
   FreeP(lookup);
-  SelectorClean(G);
+  SelectorReleaseTable(G);
 }
 
 void SelectorDefragment(PyMOLGlobals * G)
@@ -1802,7 +2107,7 @@ static void SelectorDeleteSeleAtOffset(PyMOLGlobals * G, int n)
   int id;
   id = I->Info[n].ID;
   SelectorDelName(G, n);
-  SelectorPurgeMembers(G, id);
+  SelectorPurgeMembers(G, id, I->Info + n);
 
   I->NActive--;
   {
@@ -4181,6 +4486,25 @@ ObjectMolecule *SelectorGetFastSingleObjectMolecule(PyMOLGlobals * G, int sele)
 }
 
 
+/*========================================================================*/
+/*
+ * Like SelectorGetFastSingleObjectMolecule, but without the fallback: NULL
+ * if the selection wasn't created from atoms of a single object.
+ */
+ObjectMolecule *SelectorGetKnownSingleObjectMolecule(PyMOLGlobals * G, int sele)
+{
+  CSelector *I = G->Selector;
+  int sele_idx = SelectorIndexByID(G, sele);
+  if(sele_idx >= 0) {
+    SelectionInfoRec *info = I->Info + sele_idx;
+    if(info->justOneObjectFlag &&
+       ExecutiveValidateObjectPtr(G, (CObject *) info->theOneObject, cObjectMolecule))
+      return info->theOneObject;
+  }
+  return NULL;
+}
+
+
 /*========================================================================*/
 ObjectMolecule *SelectorGetFastSingleAtomObjectIndex(PyMOLGlobals * G, int sele,
                                                      int *index)
@@ -5065,7 +5389,7 @@ int SelectorSubdivide(PyMOLGlobals * G, const char *pref, int sele1, int sele2,
     FreeP(comp);
     FreeP(pkset);
     VLAFreeP(stk);
-    SelectorClean(G);
+    SelectorReleaseTable(G);
   }
   PRINTFD(G, FB_Selector)
     " SelectorSubdivideObject: leaving...nFrag %d\n", nFrag ENDFD;
@@ -6187,6 +6511,7 @@ int SelectorAssignAtomTypes(PyMOLGlobals * G, int sele, int state, int quiet, in
       }
     }
   }
+  SelectorInvalidateEvalCache(G);     /* text_type */
   return 1;
 #else
   if (format != 1) {
@@ -6208,6 +6533,7 @@ int SelectorAssignAtomTypes(PyMOLGlobals * G, int sele, int state, int quiet, in
     LexAssign(G, iter.getAtomInfo()->textType,
         getMOL2Type(obj, iter.getAtm()));
   }
+  SelectorInvalidateEvalCache(G);     /* text_type */
   return 1;
 #endif
 }
@@ -6410,69 +6736,453 @@ ok_except1:
 }
 
 /*========================================================================*/
-void SelectorUpdateCmd(PyMOLGlobals * G, int sele0, int sele1, int sta0, int sta1,
-                       int matchmaker, int quiet)
+#ifndef _PYMOL_NOPY
+/*
+ * Atoms of the selection in iterate order, plus the atom property
+ * descriptor for `name` if it can be accessed in bulk.
+ */
+static AtomPropertyInfo * SelectorGetAtomPropertyAtoms(PyMOLGlobals * G,
+    int sele, const char *name, const char *errstr,
+    std::vector<std::pair<ObjectMolecule *, int> > &atoms)
 {
-  CSelector *I = G->Selector;
-  int a, b;
-  int at0 = 0, at1;
-  int *vla0 = NULL;
-  int *vla1 = NULL;
-  int c0 = 0, c1 = 0;
-  int i0 = 0, i1;
-  ObjectMolecule *obj0 = NULL, *obj1;
-  CoordSet *cs0;
-  const CoordSet *cs1;
-  int matched_flag;
-  int b_start;
-  int ccc = 0;
+  AtomPropertyInfo *ap = PyMOL_GetAtomPropertyInfo(G->PyMOL, name);
+
+  if(ap) {
+    switch (ap->Ptype) {
+    case cPType_float:
+    case cPType_int:
+    case cPType_schar:
+    case cPType_index:
+    case cPType_int_as_string:
+    case cPType_string:
+      break;
+    default:
+      ap = NULL;
+    }
+  }
 
-  bool ignore_case = SettingGetGlobal_b(G, cSetting_ignore_case);
-  bool ignore_case_chain = SettingGetGlobal_b(G, cSetting_ignore_case_chain);
+  if(!ap) {
+    PRINTFB(G, FB_Selector, FB_Errors)
+      " %s-Error: unsupported atom property '%s'\n", errstr, name ENDFB(G);
+    return NULL;
+  }
 
-  PRINTFD(G, FB_Selector)
-    " SelectorUpdateCmd-Debug: entered sta0 %d sta1 %d", sta0, sta1 ENDFD;
+  for(SeleAtomIterator iter(G, sele); iter.next();)
+    atoms.emplace_back(iter.obj, iter.getAtm());
 
-  // either both or none must be "all states"
-  if (sta0 != sta1) {
-    if (sta0 == cSelectorUpdateTableAllStates) {
-      sta0 = sta1;
-    } else if (sta1 == cSelectorUpdateTableAllStates) {
-      sta1 = sta0;
-    }
+  return ap;
+}
+#endif
+
+/*
+ * Get an atom property (b, q, vdw, partial_charge, resv, color, reps,
+ * protons, ...) for all atoms in the selection as a 1D numpy array, in
+ * one pass over the atom table instead of one Python callback per atom.
+ *
+ * String properties are returned as an object array, or with `codes` as a
+ * (codes, categories) tuple where codes is an int32 array indexing into the
+ * list of distinct values. The lexicon makes the latter a cheap lookup.
+ */
+PyObject *SelectorGetAtomPropertyAsNumPy(PyMOLGlobals * G, int sele,
+    const char *name, int codes)
+{
+#ifndef _PYMOL_NUMPY
+  printf("No numpy support\n");
+  return NULL;
+#else
+
+  std::vector<std::pair<ObjectMolecule *, int> > atoms;
+  AtomPropertyInfo *ap = SelectorGetAtomPropertyAtoms(G, sele, name,
+      "GetAtomProperty", atoms);
+  PyObject *result = NULL, *categories = NULL;
+  npy_intp dims[1] = {(npy_intp) atoms.size()};
+  int typenum;
+
+  if(!ap)
+    return NULL;
+
+  import_array1(NULL);
+
+  switch (ap->Ptype) {
+    case cPType_float:  typenum = NPY_FLOAT32; break;
+    case cPType_schar:  typenum = NPY_INT8; break;
+    case cPType_int:
+    case cPType_index:  typenum = NPY_INT32; break;
+    default:            typenum = codes ? NPY_INT32 : NPY_OBJECT;
   }
 
-  if((sta0 < 0) || (sta1 < 0) || (sta0 != sta1)) {
-    SelectorUpdateTable(G, cSelectorUpdateTableAllStates, -1);
-  } else {
-    SelectorUpdateTable(G, sta0, -1);
+  result = PyArray_SimpleNew(1, dims, typenum);
+  if(!result)
+    return NULL;
+
+  char *dataptr = (char *) PyArray_DATA((PyArrayObject *)result);
+  const size_t n = atoms.size();
+
+  switch (ap->Ptype) {
+  case cPType_float:
+    for(size_t i = 0; i < n; i++) {
+      const AtomInfoType *ai = atoms[i].first->AtomInfo + atoms[i].second;
+      ((float *) dataptr)[i] = *(const float *) ((const char *) ai + ap->offset);
+    }
+    break;
+  case cPType_schar:
+    for(size_t i = 0; i < n; i++) {
+      const AtomInfoType *ai = atoms[i].first->AtomInfo + atoms[i].second;
+      ((signed char *) dataptr)[i] = *((const signed char *) ai + ap->offset);
+    }
+    break;
+  case cPType_int:
+    for(size_t i = 0; i < n; i++) {
+      const AtomInfoType *ai = atoms[i].first->AtomInfo + atoms[i].second;
+      ((int *) dataptr)[i] = *(const int *) ((const char *) ai + ap->offset);
+    }
+    break;
+  case cPType_index:
+    for(size_t i = 0; i < n; i++) {
+      ((int *) dataptr)[i] = atoms[i].second + 1;
+    }
+    break;
+  default:
+    {
+      // one Python string per distinct value, collected in `categories`
+      std::map<std::string, int> str_codes;
+      std::map<lexidx_t, int> lex_codes;
+
+      for(size_t i = 0; i < n; i++) {
+        const char *ai = (const char *) (atoms[i].first->AtomInfo + atoms[i].second);
+        int code;
+
+        if(ap->Ptype == cPType_int_as_string) {
+          lexidx_t lex = *(const lexidx_t *) (ai + ap->offset);
+          auto it = lex_codes.find(lex);
+          if(it == lex_codes.end()) {
+            code = lex_codes.size();
+            lex_codes[lex] = code;
+            if(!categories)
+              categories = PyList_New(0);
+            PyObject *item = PyString_FromString(LexStr(G, lex));
+            PyList_Append(categories, item);
+            Py_DECREF(item);
+          } else {
+            code = it->second;
+          }
+        } else {
+          const char *str = ai + ap->offset;
+          auto it = str_codes.find(str);
+          if(it == str_codes.end()) {
+            code = str_codes.size();
+            str_codes[str] = code;
+            if(!categories)
+              categories = PyList_New(0);
+            PyObject *item = PyString_FromString(str);
+            PyList_Append(categories, item);
+            Py_DECREF(item);
+          } else {
+            code = it->second;
+          }
+        }
+
+        if(codes) {
+          ((int *) dataptr)[i] = code;
+        } else {
+          PyObject *item = PyList_GET_ITEM(categories, code);
+          Py_INCREF(item);
+          ((PyObject **) dataptr)[i] = item;
+        }
+      }
+
+      if(codes) {
+        if(!categories)
+          categories = PyList_New(0);
+        return Py_BuildValue("(NN)", result, categories);
+      }
+
+      Py_XDECREF(categories);
+    }
   }
 
-  vla0 = SelectorGetIndexVLA(G, sele0);
-  vla1 = SelectorGetIndexVLA(G, sele1);
+  return result;
+#endif
+}
 
-  if (vla0 && vla1) {
-    c0 = VLAGetSize(vla0);
-    c1 = VLAGetSize(vla1);
+/*
+ * Set an atom property for all atoms in the selection from a sequence
+ * (preferably a numpy array) with one value per atom, in iterate order.
+ * String properties also accept a (codes, categories) tuple as returned
+ * by SelectorGetAtomPropertyAsNumPy. Dependent fields are updated like
+ * with "alter" (e.g. protons and vdw for elem).
+ */
+int SelectorLoadAtomProperty(PyMOLGlobals * G, PyObject * values, int sele,
+    const char *name)
+{
+#ifdef _PYMOL_NOPY
+  return false;
+#else
+
+  std::vector<std::pair<ObjectMolecule *, int> > atoms;
+  std::vector<lexidx_t> lex_categories;
+  std::vector<std::string> str_categories;
+  PyObject *seq = NULL, *codes = NULL;
+  AtomPropertyInfo *ap = SelectorGetAtomPropertyAtoms(G, sele, name,
+      "SetAtomProperty", atoms);
+  const size_t n = atoms.size();
+
+  if(!ap)
+    return false;
+
+  if(ap->Ptype == cPType_index) {
+    PRINTFB(G, FB_Selector, FB_Errors)
+      " SetAtomProperty-Error: '%s' is read-only\n", name ENDFB(G);
+    return false;
   }
 
-  if (c0 < 1 || c1 < 1)
-    ErrMessage(G, "Update", "no coordinates updated.");
-  else {
+  const bool is_string = (ap->Ptype == cPType_int_as_string ||
+                          ap->Ptype == cPType_string);
+
+  // atoms [0, n_done) may have been modified, also on errors
+  size_t n_done = 0;
+  auto invalidate = [&]() {
+    int level = (ap->id == ATOM_PROP_COLOR) ? cRepInvColor :
+                (ap->id == ATOM_PROP_REPS)  ? cRepInvVisib : cRepInvRep;
+    ObjectMolecule *last = NULL;
+    for(size_t i = 0; i < n_done; i++) {
+      if(atoms[i].first != last) {
+        last = atoms[i].first;
+        ObjectMoleculeInvalidate(last, cRepAll, level, -1);
+      }
+    }
+    if(n_done)
+      SelectorInvalidateEvalCache(G);
+  };
+
+  // (codes, categories)
+  if(is_string && PyTuple_Check(values) && PyTuple_Size(values) == 2) {
+    PyObject *cats = PyTuple_GET_ITEM(values, 1);
+    codes = PyTuple_GET_ITEM(values, 0);
+    ok_assert(1, PySequence_Check(cats));
+
+    Py_ssize_t n_cat = PySequence_Size(cats);
+    for(Py_ssize_t c = 0; c < n_cat; c++) {
+      PyObject *item = PySequence_GetItem(cats, c);
+      PyObject *valobj = item ? PyObject_Str(item) : NULL;
+      Py_XDECREF(item);
+      ok_assert(1, valobj);
+      const char *valstr = PyString_AsString(valobj);
+      if(ap->Ptype == cPType_int_as_string)
+        lex_categories.push_back(LexIdx(G, valstr));
+      else
+        str_categories.push_back(valstr);
+      Py_DECREF(valobj);
+    }
 
-    b = 0;
-    for(a = 0; a < c1; a++) {   /* iterate over source atoms */
-      /* NOTE, this algorithm is N^2 and slow in the worst case...
-         however the best case (N) is quite common, especially when merging 
-         files written out of PyMOL */
+    values = codes;
+  }
 
-      i1 = vla1[a];
-      at1 = I->Table[i1].atom;
-      obj1 = I->Obj[I->Table[i1].model];
-      matched_flag = false;
+  if(!PySequence_Check(values)) {
+    ErrMessage(G, "SetAtomProperty", "passed argument is not a sequence");
+    ok_raise(1);
+  }
 
-      switch (matchmaker) {
-      case 0:                 
+  if(n != (size_t) PySequence_Size(values)) {
+    ErrMessage(G, "SetAtomProperty", "atom count mismatch");
+    ok_raise(1);
+  }
+
+  // fast path: numeric data from a contiguous array of the native type
+#ifdef _PYMOL_NUMPY
+  if(!is_string || codes) {
+    int typenum;
+    import_array1(false);
+
+    switch (ap->Ptype) {
+      case cPType_float:  typenum = NPY_FLOAT32; break;
+      case cPType_schar:  typenum = NPY_INT8; break;
+      default:            typenum = NPY_INT32;
+    }
+
+    seq = PyArray_FROMANY(values, typenum, 1, 1,
+        NPY_ARRAY_IN_ARRAY | NPY_ARRAY_FORCECAST);
+    ok_assert(2, seq);
+  }
+#endif
+
+  if(!seq) {
+    seq = PySequence_Fast(values, "expected a sequence");
+    ok_assert(2, seq);
+  }
+
+  for(size_t i = 0; i < n; i++) {
+    AtomInfoType *ai = atoms[i].first->AtomInfo + atoms[i].second;
+    char *dest = (char *) ai + ap->offset;
+    PyObject *item = NULL;
+    long code = 0;
+
+    n_done = i + 1;
+
+#ifdef _PYMOL_NUMPY
+    if(PyArray_Check(seq)) {
+      const void *ptr = PyArray_GETPTR1((PyArrayObject *) seq, i);
+      switch (ap->Ptype) {
+      case cPType_float:
+        *(float *) dest = *(const float *) ptr;
+        break;
+      case cPType_schar:
+        *(signed char *) dest = *(const signed char *) ptr;
+        break;
+      case cPType_int:
+        *(int *) dest = *(const int *) ptr;
+        break;
+      default:
+        code = *(const int *) ptr;
+      }
+    } else
+#endif
+    {
+      item = PySequence_Fast_GET_ITEM(seq, i);
+      switch (ap->Ptype) {
+      case cPType_float:
+        ok_assert(2, PConvPyObjectToFloat(item, (float *) dest));
+        break;
+      case cPType_schar:
+        *(signed char *) dest = (signed char) PyInt_AsLong(item);
+        break;
+      case cPType_int:
+        *(int *) dest = (int) PyInt_AsLong(item);
+        break;
+      default:
+        if(codes)
+          code = PyInt_AsLong(item);
+      }
+      ok_assert(2, !PyErr_Occurred());
+    }
+
+    if(is_string) {
+      if(codes) {
+        size_t n_cat = lex_categories.size() + str_categories.size();
+        if(code < 0 || (size_t) code >= n_cat) {
+          ErrMessage(G, "SetAtomProperty", "category code out of range");
+          ok_raise(1);
+        }
+        if(ap->Ptype == cPType_int_as_string)
+          LexAssign(G, *(lexidx_t *) dest, lex_categories[code]);
+        else
+          UtilNCopy(dest, str_categories[code].c_str(), ap->maxlen + 1);
+      } else {
+        PyObject *valobj = PyObject_Str(item);
+        ok_assert(2, valobj);
+        const char *valstr = PyString_AsString(valobj);
+        if(ap->Ptype == cPType_int_as_string)
+          LexAssign(G, *(lexidx_t *) dest, valstr);
+        else
+          UtilNCopy(dest, valstr, ap->maxlen + 1);
+        Py_DECREF(valobj);
+      }
+    }
+
+    // same side effects as alter
+    switch (ap->id) {
+    case ATOM_PROP_ELEM:
+      ai->protons = 0;
+      ai->vdw = 0;
+      AtomInfoAssignParameters(G, ai);
+      break;
+    case ATOM_PROP_RESV:
+      ai->inscode = '\0';
+      break;
+    case ATOM_PROP_SS:
+      ai->ssType[0] = toupper(ai->ssType[0]);
+      break;
+    case ATOM_PROP_FORMAL_CHARGE:
+      ai->chemFlag = false;
+      break;
+    }
+  }
+
+  invalidate();
+
+  Py_DECREF(seq);
+  for(auto lex : lex_categories)
+    LexDec(G, lex);
+  return true;
+
+  // error handling
+ok_except2:
+  if(PyErr_Occurred())
+    PyErr_Print();
+ok_except1:
+  invalidate();
+  Py_XDECREF(seq);
+  for(auto lex : lex_categories)
+    LexDec(G, lex);
+  ErrMessage(G, "SetAtomProperty", "failed");
+  return false;
+#endif
+}
+
+/*========================================================================*/
+void SelectorUpdateCmd(PyMOLGlobals * G, int sele0, int sele1, int sta0, int sta1,
+                       int matchmaker, int quiet)
+{
+  CSelector *I = G->Selector;
+  int a, b;
+  int at0 = 0, at1;
+  int *vla0 = NULL;
+  int *vla1 = NULL;
+  int c0 = 0, c1 = 0;
+  int i0 = 0, i1;
+  ObjectMolecule *obj0 = NULL, *obj1;
+  CoordSet *cs0;
+  const CoordSet *cs1;
+  int matched_flag;
+  int b_start;
+  int ccc = 0;
+
+  bool ignore_case = SettingGetGlobal_b(G, cSetting_ignore_case);
+  bool ignore_case_chain = SettingGetGlobal_b(G, cSetting_ignore_case_chain);
+
+  PRINTFD(G, FB_Selector)
+    " SelectorUpdateCmd-Debug: entered sta0 %d sta1 %d", sta0, sta1 ENDFD;
+
+  // either both or none must be "all states"
+  if (sta0 != sta1) {
+    if (sta0 == cSelectorUpdateTableAllStates) {
+      sta0 = sta1;
+    } else if (sta1 == cSelectorUpdateTableAllStates) {
+      sta1 = sta0;
+    }
+  }
+
+  if((sta0 < 0) || (sta1 < 0) || (sta0 != sta1)) {
+    SelectorUpdateTable(G, cSelectorUpdateTableAllStates, -1);
+  } else {
+    SelectorUpdateTable(G, sta0, -1);
+  }
+
+  vla0 = SelectorGetIndexVLA(G, sele0);
+  vla1 = SelectorGetIndexVLA(G, sele1);
+
+  if (vla0 && vla1) {
+    c0 = VLAGetSize(vla0);
+    c1 = VLAGetSize(vla1);
+  }
+
+  if (c0 < 1 || c1 < 1)
+    ErrMessage(G, "Update", "no coordinates updated.");
+  else {
+
+    b = 0;
+    for(a = 0; a < c1; a++) {   /* iterate over source atoms */
+      /* NOTE, this algorithm is N^2 and slow in the worst case...
+         however the best case (N) is quite common, especially when merging 
+         files written out of PyMOL */
+
+      i1 = vla1[a];
+      at1 = I->Table[i1].atom;
+      obj1 = I->Obj[I->Table[i1].model];
+      matched_flag = false;
+
+      switch (matchmaker) {
+      case 0:                 
         /* simply assume that atoms are stored in PyMOL in the identical order, one for one */
         if(b < c0) {
           i0 = vla0[b];
@@ -6939,7 +7649,12 @@ int SelectorIndexByName(PyMOLGlobals * G, const char *sname, int ignore_case)
 
 
 /*========================================================================*/
-static void SelectorPurgeMembers(PyMOLGlobals * G, int sele)
+/*
+ * info: if given and the selection is known to cover a single object, only
+ * that object's atoms are visited (nothing, if the object is gone)
+ */
+static void SelectorPurgeMembers(PyMOLGlobals * G, int sele,
+                                 const SelectionInfoRec * info)
 {
   CSelector *I = G->Selector;
   void *iterator = NULL;
@@ -6950,28 +7665,37 @@ static void SelectorPurgeMembers(PyMOLGlobals * G, int sele)
     MemberType *I_Member = I->Member;
     int I_FreeMember = I->FreeMember;
 
-    while(ExecutiveIterateObjectMolecule(G, &obj, &iterator)) {
-      if(obj->Obj.type == cObjectMolecule) {
-        AtomInfoType *ai = obj->AtomInfo;
-        int a, n_atom = obj->NAtom;
-        for(a = 0; a < n_atom; a++) {
-          int s = (ai++)->selEntry;
-          int l = -1;
-          while(s) {
-            MemberType *i_member_s = I_Member + s;
-            int nxt = i_member_s->next;
-            if(i_member_s->selection == sele) {
-              if(l > 0)
-                I_Member[l].next = i_member_s->next;
-              else
-                ai[-1].selEntry = i_member_s->next;
-	      changed = 1;
-              i_member_s->next = I_FreeMember;
-              I_FreeMember = s;
-            }
-            l = s;
-            s = nxt;
+    auto purge = [&](ObjectMolecule * obj) {
+      AtomInfoType *ai = obj->AtomInfo;
+      int a, n_atom = obj->NAtom;
+      for(a = 0; a < n_atom; a++) {
+        int s = (ai++)->selEntry;
+        int l = -1;
+        while(s) {
+          MemberType *i_member_s = I_Member + s;
+          int nxt = i_member_s->next;
+          if(i_member_s->selection == sele) {
+            if(l > 0)
+              I_Member[l].next = i_member_s->next;
+            else
+              ai[-1].selEntry = i_member_s->next;
+            changed = 1;
+            i_member_s->next = I_FreeMember;
+            I_FreeMember = s;
           }
+          l = s;
+          s = nxt;
+        }
+      }
+    };
+
+    if(info && info->justOneObjectFlag) {
+      if(ExecutiveValidateObjectPtr(G, (CObject *) info->theOneObject, cObjectMolecule))
+        purge(info->theOneObject);
+    } else {
+      while(ExecutiveIterateObjectMolecule(G, &obj, &iterator)) {
+        if(obj->Obj.type == cObjectMolecule) {
+          purge(obj);
         }
       }
     }
@@ -7455,7 +8179,7 @@ static int _SelectorCreate(PyMOLGlobals * G, const char *sname, const char *sele
   if(ok)
     c = SelectorEmbedSelection(G, atom, name, embed_obj, false, executive_manage);
   FreeP(atom);
-  SelectorClean(G);
+  SelectorReleaseTable(G);
   /* ignore reporting on quiet */
   if(!quiet) {
     /* ignore reporting on internal/private names */
@@ -7574,10 +8298,41 @@ static void SelectorCleanImpl(PyMOLGlobals * G, CSelector *I)
   FreeP(I->Flag2);
   I->Flag2 = NULL;
   I->NAtom = 0;
+  if(I->TableCache)
+    I->TableCache->valid = false;
   ExecutiveInvalidateSelectionIndicatorsCGO(G);
 }
 
 
+/*========================================================================*/
+/*
+ * Done with the atom table. Unlike SelectorClean, this keeps a table
+ * which SelectorUpdateTableImpl can reuse for the next selection.
+ */
+static void SelectorReleaseTable(PyMOLGlobals * G)
+{
+  CSelector *I = G->Selector;
+  if(I->TableCache && I->TableCache->valid) {
+    ExecutiveInvalidateSelectionIndicatorsCGO(G);
+  } else {
+    SelectorClean(G);
+  }
+}
+
+
+/*========================================================================*/
+/*
+ * Forget the layout of the current atom table, so that the next update
+ * starts from scratch. Must be called before objects get deleted.
+ */
+void SelectorInvalidateTable(PyMOLGlobals * G)
+{
+  CSelector *I = G->Selector;
+  if(I && I->TableCache)
+    I->TableCache->valid = false;
+}
+
+
 /*========================================================================*/
 static int *SelectorUpdateTableSingleObject(PyMOLGlobals * G, ObjectMolecule * obj,
                                             int req_state,
@@ -7722,6 +8477,243 @@ int SelectorUpdateTable(PyMOLGlobals * G, int req_state, int domain)
   return (SelectorUpdateTableImpl(G, G->Selector, req_state, domain));
 }
 
+/*
+ * Table update for the common case (no domain) which only touches what
+ * changed since the last update: Objects are compared segment by segment
+ * against the previous layout (see SelectorTableSegment) and only new or
+ * modified objects are rescanned. The table is updated in place, only the
+ * range between the unchanged leading and trailing objects is rewritten.
+ */
+static int SelectorUpdateTableCached(PyMOLGlobals * G, CSelector *I, int req_state)
+{
+  SelectorTableCache *cache = I->TableCache;
+  std::vector<SelectorTableSegment> segments;
+  void *iterator = NULL;
+  ObjectMolecule *obj = NULL;
+  int n_cset = 0;
+
+  auto add_segment = [&](ObjectMolecule * obj, int state) {
+    SelectorTableSegment seg;
+    seg.obj = obj;
+    seg.generation = obj->SeleGeneration;
+    seg.n_atom = obj->NAtom;
+    seg.state = state;
+    seg.cs = (state >= 0 && state < obj->NCSet) ? obj->CSet[state] : NULL;
+    seg.cs_n_index = seg.cs ? seg.cs->NIndex : 0;
+    seg.start = seg.count = 0;
+    segments.push_back(seg);
+  };
+
+  auto same_segment = [](const SelectorTableSegment & a,
+                         const SelectorTableSegment & b) {
+    return a.obj == b.obj && a.generation == b.generation &&
+      a.n_atom == b.n_atom && a.state == b.state && a.cs == b.cs &&
+      a.cs_n_index == b.cs_n_index;
+  };
+
+  /* current layout */
+  if(I->Origin)
+    add_segment(I->Origin, -1);
+  if(I->Center)
+    add_segment(I->Center, -1);
+
+  while(ExecutiveIterateObjectMolecule(G, &obj, &iterator)) {
+    int state = req_state;
+    if(n_cset < obj->NCSet)
+      n_cset = obj->NCSet;
+    switch (req_state) {
+    case cSelectorUpdateTableCurrentState:
+      state = SettingGetGlobal_i(G, cSetting_state) - 1;
+      break;
+    case cSelectorUpdateTableEffectiveStates:
+      state = ObjectGetCurrentState(&obj->Obj, true);
+      break;
+    default:
+      if(req_state < 0)
+        state = -1;             /* all states */
+      break;
+    }
+    add_segment(obj, state);
+  }
+
+  I->NCSet = n_cset;
+  I->SeleBaseOffsetsValid = (req_state == cSelectorUpdateTableAllStates);
+
+  const auto & old_segments = cache->segments;
+  bool reuse = cache->valid && I->Table && cache->req_state == req_state;
+  size_t n_same = 0;
+
+  if(reuse) {
+    while(n_same < segments.size() && n_same < old_segments.size() &&
+          same_segment(segments[n_same], old_segments[n_same]))
+      ++n_same;
+
+    if(n_same == segments.size() && n_same == old_segments.size()) {
+      /* nothing changed, but another table may have been built in the
+         meantime, so restore the object offsets */
+      for(auto & seg : old_segments)
+        seg.obj->SeleBase = seg.count ? seg.start : 0;
+      ExecutiveInvalidateSelectionIndicatorsCGO(G);
+      return true;
+    }
+  }
+
+  /* unchanged objects at the end of the table */
+  size_t n_tail = 0;
+  if(reuse) {
+    while(n_same + n_tail < segments.size() &&
+          n_same + n_tail < old_segments.size() &&
+          same_segment(segments[segments.size() - 1 - n_tail],
+                       old_segments[old_segments.size() - 1 - n_tail]))
+      ++n_tail;
+  } else {
+    FreeP(I->Table);
+  }
+
+  const size_t mid_end = segments.size() - n_tail;
+  const size_t old_mid_end = old_segments.size() - n_tail;
+
+  /* unchanged objects which moved within the changed range */
+  std::map<const ObjectMolecule *, const SelectorTableSegment *> old_by_obj;
+  if(reuse) {
+    for(size_t i = n_same; i < old_mid_end; ++i)
+      old_by_obj[old_segments[i].obj] = &old_segments[i];
+  }
+
+  /* the table is only spliced between the leading and trailing unchanged
+     objects, everything else stays in place */
+  TableRec *table = I->Table;
+  ov_size old_n_atom = I->NAtom;
+  ov_size head = 0;
+  int head_models = 0;
+  for(size_t i = 0; i < n_same; ++i) {
+    segments[i].start = old_segments[i].start;
+    segments[i].count = old_segments[i].count;
+    head = old_segments[i].start + old_segments[i].count;
+    if(old_segments[i].count)
+      head_models++;
+  }
+
+  int old_mid_models = head_models;
+  for(size_t i = n_same; i < old_mid_end; ++i) {
+    if(old_segments[i].count)
+      old_mid_models++;
+  }
+
+  std::vector<TableRec> mid;
+  int modelCnt = head_models;
+
+  for(size_t i = n_same; i < mid_end; ++i) {
+    auto & seg = segments[i];
+    const SelectorTableSegment *old_seg = NULL;
+    size_t mid_start = mid.size();
+    TableRec rec;
+    rec.model = modelCnt;
+    rec.index = 0;
+    rec.f1 = 0.0F;
+
+    if(reuse) {
+      auto it = old_by_obj.find(seg.obj);
+      if(it != old_by_obj.end() && same_segment(seg, *it->second))
+        old_seg = it->second;
+    }
+
+    if(old_seg) {
+      const TableRec *src = table + old_seg->start;
+      for(ov_size a = 0; a < old_seg->count; ++a) {
+        rec.atom = src[a].atom;
+        mid.push_back(rec);
+      }
+    } else if(seg.state < 0) {
+      for(rec.atom = 0; rec.atom < seg.n_atom; ++rec.atom)
+        mid.push_back(rec);
+    } else if(seg.cs) {
+      for(rec.atom = 0; rec.atom < seg.n_atom; ++rec.atom) {
+        if(seg.cs->atmToIdx(rec.atom) >= 0)
+          mid.push_back(rec);
+      }
+    }
+
+    seg.start = head + mid_start;
+    seg.count = mid.size() - mid_start;
+    if(seg.count)               /* skip excluded models */
+      modelCnt++;
+  }
+
+  ov_size c = head + mid.size();        /* where the trailing objects go */
+  ov_size old_tail = n_tail ? old_segments[old_mid_end].start : old_n_atom;
+  ov_size tail_len = n_tail ? old_n_atom - old_tail : 0;
+  ov_size n_atom = c + tail_len;
+  int model_shift = modelCnt - old_mid_models;
+
+  if(!table) {
+    table = Alloc(TableRec, n_atom);
+  } else if(n_atom > old_n_atom) {
+    table = Realloc(table, TableRec, n_atom);
+  }
+  ErrChkPtr(G, table);
+
+  if(tail_len && c != old_tail)
+    memmove(table + c, table + old_tail, sizeof(TableRec) * tail_len);
+  if(reuse && n_atom < old_n_atom)
+    table = Realloc(table, TableRec, n_atom);
+  if(!mid.empty())
+    memcpy(table + head, mid.data(), sizeof(TableRec) * mid.size());
+
+  if(model_shift) {
+    for(ov_size a = c; a < n_atom; ++a)
+      table[a].model += model_shift;
+  }
+
+  for(size_t i = mid_end; i < segments.size(); ++i) {
+    const auto & old_seg = old_segments[old_mid_end + (i - mid_end)];
+    segments[i].start = old_seg.start - old_tail + c;
+    segments[i].count = old_seg.count;
+    if(old_seg.count)
+      modelCnt++;
+  }
+
+  ObjectMolecule **model_obj = Alloc(ObjectMolecule *, modelCnt);
+  ErrChkPtr(G, model_obj);
+  modelCnt = 0;
+  for(auto & seg : segments) {
+    if(seg.count) {
+      model_obj[modelCnt++] = seg.obj;
+      seg.obj->SeleBase = seg.start;    /* make note of where this object starts */
+    } else {
+      seg.obj->SeleBase = 0;
+    }
+  }
+
+  FreeP(I->Obj);
+  I->Table = table;
+  I->Obj = model_obj;
+  I->NModel = modelCnt;
+  I->NAtom = n_atom;
+
+  /* scratch arrays only need to be resized */
+  if(!I->Flag1 || old_n_atom != n_atom) {
+    FreeP(I->Flag1);
+    FreeP(I->Flag2);
+    FreeP(I->Vertex);
+    I->Flag1 = Alloc(int, n_atom);
+    ErrChkPtr(G, I->Flag1);
+    I->Flag2 = Alloc(int, n_atom);
+    ErrChkPtr(G, I->Flag2);
+    I->Vertex = Alloc(float, n_atom * 3);
+    ErrChkPtr(G, I->Vertex);
+  }
+
+  SelectorEvalCacheCheckTable(I, SelectorEvalCacheLayout(segments));
+
+  cache->segments.swap(segments);
+  cache->req_state = req_state;
+  cache->valid = true;
+
+  ExecutiveInvalidateSelectionIndicatorsCGO(G);
+  return true;
+}
+
 int SelectorUpdateTableImpl(PyMOLGlobals * G, CSelector *I, int req_state, int domain)
 {
   int a = 0;
@@ -7738,6 +8730,9 @@ int SelectorUpdateTableImpl(PyMOLGlobals * G, CSelector *I, int req_state, int d
   if(!I->Center)
     I->Center = ObjectMoleculeDummyNew(G, cObjectMoleculeDummyCenter);
 
+  if(domain < 0 && I->TableCache)
+    return SelectorUpdateTableCached(G, I, req_state);
+
   SelectorClean(G);
   I->NCSet = 0;
 
@@ -7915,6 +8910,8 @@ int SelectorUpdateTableImpl(PyMOLGlobals * G, CSelector *I, int req_state, int d
   ErrChkPtr(G, I->Flag2);
   I->Vertex = Alloc(float, c * 3);
   ErrChkPtr(G, I->Vertex);
+  /* no layout signature without the table cache (or with a domain) */
+  SelectorEvalCacheCheckTable(I, 0);
   /* printf("selector update table state=%d, natom=%d\n",req_state,c); */
   return (true);
 }
@@ -8426,7 +9423,7 @@ static int SelectorSelect1(PyMOLGlobals * G, EvalElem * base, int quiet)
 {
   CSelector *I = G->Selector;
   CWordMatcher *matcher = NULL;
-  int a, b, c = 0, hit_flag;
+  int a, b, c = 0;
   ObjectMolecule **i_obj = I->Obj, *obj, *last_obj;
   TableRec *i_table = I->Table, *table_a;
   int ignore_case = SettingGetGlobal_b(G, cSetting_ignore_case);
@@ -8450,6 +9447,8 @@ static int SelectorSelect1(PyMOLGlobals * G, EvalElem * base, int quiet)
   PRINTFD(G, FB_Selector)
     " SelectorSelect1: base: %p sele: %p\n", (void *) base, (void *) base->sele ENDFD;
   ErrChkPtr(G, base->sele);
+  if(SelectorEvalCacheRecall(G, base, 1))
+    return true;
   switch (base->code) {
   case SELE_PEPs:
     if(base[1].text[0]) {
@@ -8587,12 +9586,22 @@ static int SelectorSelect1(PyMOLGlobals * G, EvalElem * base, int quiet)
       WordMatchOptionsConfigAlphaList(&options, atom_name_wildcard[0], ignore_case);
 
       matcher = WordMatcherNew(G, base[1].text, &options, false);
+      if(!matcher)
+        WordPrimeCommaMatch(G, base[1].text);
 
-      table_a = i_table + cNDummyAtoms;
-      base_0_sele_a = &base[0].sele[cNDummyAtoms];
+      auto match_name = [&](const char *name) -> bool {
+        if(matcher)
+          return WordMatcherMatchAlpha(matcher, name);
+        return WordMatchCommaExact(G, base[1].text, name, ignore_case) < 0;
+      };
+      auto get_name = [](const AtomInfoType * ai) { return ai->name; };
+
+      /* process runs of atoms which share the same wildcard, since
+         the matcher has to be rebuilt when the wildcard changes */
+      int run_start = cNDummyAtoms;
       last_obj = NULL;
       for(a = cNDummyAtoms; a < I_NAtom; a++) {
-        obj = i_obj[table_a->model];
+        obj = i_obj[i_table[a].model];
         if(obj != last_obj) {
 
           /* allow objects to have their own atom_name_wildcards...this is a tricky workaround
@@ -8605,6 +9614,10 @@ static int SelectorSelect1(PyMOLGlobals * G, EvalElem * base, int quiet)
             atom_name_wildcard = wildcard;
 
           if(options.wildcard != atom_name_wildcard[0]) {
+            c += SelectorSelectByLexIdx(G, base[0].sele, run_start, a,
+                get_name, match_name);
+            run_start = a;
+
             options.wildcard = atom_name_wildcard[0];
             if(matcher)
               WordMatcherFree(matcher);
@@ -8614,22 +9627,9 @@ static int SelectorSelect1(PyMOLGlobals * G, EvalElem * base, int quiet)
           }
           last_obj = obj;
         }
-
-        const char * name = LexStr(G, obj->AtomInfo[table_a->atom].name);
-        if(matcher)
-          hit_flag =
-            WordMatcherMatchAlpha(matcher,
-                                  name);
-        else
-          hit_flag = (WordMatchCommaExact(G, base[1].text,
-                                          name,
-                                          ignore_case) < 0);
-
-        if((*base_0_sele_a = hit_flag))
-          c++;
-        table_a++;
-        base_0_sele_a++;
       }
+      c += SelectorSelectByLexIdx(G, base[0].sele, run_start, I_NAtom,
+          get_name, match_name);
       if(matcher)
         WordMatcherFree(matcher);
     }
@@ -8644,21 +9644,9 @@ static int SelectorSelect1(PyMOLGlobals * G, EvalElem * base, int quiet)
       base_0_sele_a = &base[0].sele[cNDummyAtoms];
 
       if((matcher = WordMatcherNew(G, base[1].text, &options, true))) {
-	AtomInfoType * ai;
-        table_a = i_table + cNDummyAtoms;
-        base_0_sele_a = &base[0].sele[cNDummyAtoms];
-
-#ifndef NO_MMLIBS
-#endif
-        for(a = cNDummyAtoms; a < I_NAtom; a++) {
-          ai = i_obj[table_a->model]->AtomInfo + table_a->atom;
-#ifndef NO_MMLIBS
-#endif
-          if((*base_0_sele_a = WordMatcherMatchAlpha(matcher, LexStr(G, ai->textType))))
-	    c++;
-          table_a++;
-          base_0_sele_a++;
-        }
+        c = SelectorSelectByLexIdx(G, base[0].sele, cNDummyAtoms, I_NAtom,
+            [](const AtomInfoType * ai) { return ai->textType; },
+            [&](const char *text) { return WordMatcherMatchAlpha(matcher, text); });
         WordMatcherFree(matcher);
       }
     }
@@ -8674,17 +9662,7 @@ static int SelectorSelect1(PyMOLGlobals * G, EvalElem * base, int quiet)
       base_0_sele_a = &base[0].sele[cNDummyAtoms];
 
       if((matcher = WordMatcherNew(G, base[1].text, &options, true))) {
-        table_a = i_table + cNDummyAtoms;
-        base_0_sele_a = &base[0].sele[cNDummyAtoms];
-
-        for(a = cNDummyAtoms; a < I_NAtom; a++) {
-          if((*base_0_sele_a =
-              WordMatcherMatchAlpha(matcher,
-                                    i_obj[table_a->model]->AtomInfo[table_a->atom].elem)))
-            c++;
-          table_a++;
-          base_0_sele_a++;
-        }
+        c = SelectorSelectByElem(G, base[0].sele, matcher);
         WordMatcherFree(matcher);
       }
     }
@@ -8794,19 +9772,12 @@ static int SelectorSelect1(PyMOLGlobals * G, EvalElem * base, int quiet)
       }
 
       if((matcher = WordMatcherNew(G, base[1].text, &options, true))) {
-        table_a = i_table + cNDummyAtoms;
-        base_0_sele_a = &base[0].sele[cNDummyAtoms];
-
-        for(a = cNDummyAtoms; a < I_NAtom; a++) {
-          if((*base_0_sele_a =
-              WordMatcherMatchAlpha(matcher, LexStr(G,
-                  *reinterpret_cast<lexidx_t*>
-                  (((char*)(i_obj[table_a->model]->AtomInfo + table_a->atom)) + offset)
-                  ))))
-            c++;
-          table_a++;
-          base_0_sele_a++;
-        }
+        c = SelectorSelectByLexIdx(G, base[0].sele, cNDummyAtoms, I_NAtom,
+            [offset](const AtomInfoType * ai) {
+              return *reinterpret_cast<const lexidx_t*>
+                (((const char*) ai) + offset);
+            },
+            [&](const char *text) { return WordMatcherMatchAlpha(matcher, text); });
         WordMatcherFree(matcher);
       }
     }
@@ -8970,17 +9941,9 @@ static int SelectorSelect1(PyMOLGlobals * G, EvalElem * base, int quiet)
       base_0_sele_a = &base[0].sele[cNDummyAtoms];
 
       if((matcher = WordMatcherNew(G, base[1].text, &options, true))) {
-        table_a = i_table + cNDummyAtoms;
-        base_0_sele_a = &base[0].sele[cNDummyAtoms];
-
-        for(a = cNDummyAtoms; a < I_NAtom; a++) {
-          auto& resn = i_obj[table_a->model]->AtomInfo[table_a->atom].resn;
-          if((*base_0_sele_a =
-              WordMatcherMatchAlpha(matcher, LexStr(G, resn))))
-            c++;
-          table_a++;
-          base_0_sele_a++;
-        }
+        c = SelectorSelectByLexIdx(G, base[0].sele, cNDummyAtoms, I_NAtom,
+            [](const AtomInfoType * ai) { return ai->resn; },
+            [&](const char *text) { return WordMatcherMatchAlpha(matcher, text); });
         WordMatcherFree(matcher);
       }
     }
@@ -9201,6 +10164,8 @@ static int SelectorSelect1(PyMOLGlobals * G, EvalElem * base, int quiet)
   }
   PRINTFD(G, FB_Selector)
     " SelectorSelect1:  %d atoms selected.\n", c ENDFD;
+  if(ok)
+    SelectorEvalCacheStore(G, base, 1);
   return (ok);
 }
 
@@ -9216,11 +10181,12 @@ static int SelectorSelect2(PyMOLGlobals * G, EvalElem * base, int state)
   int exact;
   int ignore_case = SettingGetGlobal_b(G, cSetting_ignore_case);
 
-  AtomInfoType *at1;
   CSelector *I = G->Selector;
   base->type = STYP_LIST;
   base->sele = Calloc(int, I->NAtom);
   ErrChkPtr(G, base->sele);
+  if(SelectorEvalCacheRecall(G, base, 2))
+    return true;
   switch (base->code) {
   case SELE_XVLx:
   case SELE_YVLx:
@@ -9295,159 +10261,33 @@ static int SelectorSelect2(PyMOLGlobals * G, EvalElem * base, int state)
         break;
       }
       if(ok) {
-        switch (oper) {
-        case SCMP_GTHN:
-          switch (base->code) {
-          case SELE_BVLx:
-            for(a = cNDummyAtoms; a < I->NAtom; a++) {
-              at1 = &I->Obj[I->Table[a].model]->AtomInfo[I->Table[a].atom];
-              if(at1->b > comp1) {
-                base[0].sele[a] = true;
-                c++;
-              } else {
-                base[0].sele[a] = false;
-              }
-            }
-            break;
-          case SELE_QVLx:
-            for(a = cNDummyAtoms; a < I->NAtom; a++) {
-              at1 = &I->Obj[I->Table[a].model]->AtomInfo[I->Table[a].atom];
-              if(at1->q > comp1) {
-                base[0].sele[a] = true;
-                c++;
-              } else {
-                base[0].sele[a] = false;
-              }
-            }
-            break;
-          case SELE_PCHx:
-            for(a = cNDummyAtoms; a < I->NAtom; a++) {
-              at1 = &I->Obj[I->Table[a].model]->AtomInfo[I->Table[a].atom];
-              if(at1->partialCharge > comp1) {
-                base[0].sele[a] = true;
-                c++;
-              } else {
-                base[0].sele[a] = false;
-              }
-            }
-            break;
-          case SELE_FCHx:
-            for(a = cNDummyAtoms; a < I->NAtom; a++) {
-              at1 = &I->Obj[I->Table[a].model]->AtomInfo[I->Table[a].atom];
-              if(at1->formalCharge > comp1) {
-                base[0].sele[a] = true;
-                c++;
-              } else {
-                base[0].sele[a] = false;
-              }
-            }
-            break;
-          }
+        switch (base->code) {
+        case SELE_BVLx:
+          c = SelectorSelectFloatCmp(G, base->sele, oper, comp1,
+              [](const AtomInfoType * ai) { return ai->b; });
           break;
-        case SCMP_LTHN:
-          switch (base->code) {
-          case SELE_BVLx:
-            for(a = cNDummyAtoms; a < I->NAtom; a++) {
-              at1 = &I->Obj[I->Table[a].model]->AtomInfo[I->Table[a].atom];
-              if(at1->b < comp1) {
-                base[0].sele[a] = true;
-                c++;
-              } else {
-                base[0].sele[a] = false;
-              }
-            }
-            break;
-          case SELE_QVLx:
-            for(a = cNDummyAtoms; a < I->NAtom; a++) {
-              at1 = &I->Obj[I->Table[a].model]->AtomInfo[I->Table[a].atom];
-              if(at1->q < comp1) {
-                base[0].sele[a] = true;
-                c++;
-              } else {
-                base[0].sele[a] = false;
-              }
-            }
-            break;
-          case SELE_PCHx:
-            for(a = cNDummyAtoms; a < I->NAtom; a++) {
-              at1 = &I->Obj[I->Table[a].model]->AtomInfo[I->Table[a].atom];
-              if(at1->partialCharge < comp1) {
-                base[0].sele[a] = true;
-                c++;
-              } else {
-                base[0].sele[a] = false;
-              }
-            }
-            break;
-          case SELE_FCHx:
-            for(a = cNDummyAtoms; a < I->NAtom; a++) {
-              at1 = &I->Obj[I->Table[a].model]->AtomInfo[I->Table[a].atom];
-              if(at1->formalCharge < comp1) {
-                base[0].sele[a] = true;
-                c++;
-              } else {
-                base[0].sele[a] = false;
-              }
-            }
-            break;
-          }
+        case SELE_QVLx:
+          c = SelectorSelectFloatCmp(G, base->sele, oper, comp1,
+              [](const AtomInfoType * ai) { return ai->q; });
           break;
-        case SCMP_EQAL:
-          switch (base->code) {
-          case SELE_BVLx:
-            for(a = cNDummyAtoms; a < I->NAtom; a++) {
-              at1 = &I->Obj[I->Table[a].model]->AtomInfo[I->Table[a].atom];
-              if(fabs(at1->b - comp1) < R_SMALL4) {
-                base[0].sele[a] = true;
-                c++;
-              } else {
-                base[0].sele[a] = false;
-              }
-            }
-            break;
-          case SELE_QVLx:
-            for(a = cNDummyAtoms; a < I->NAtom; a++) {
-              at1 = &I->Obj[I->Table[a].model]->AtomInfo[I->Table[a].atom];
-              if(fabs(at1->q - comp1) < R_SMALL4) {
-                base[0].sele[a] = true;
-                c++;
-              } else {
-                base[0].sele[a] = false;
-              }
-            }
-            break;
-          case SELE_PCHx:
-            for(a = cNDummyAtoms; a < I->NAtom; a++) {
-              at1 = &I->Obj[I->Table[a].model]->AtomInfo[I->Table[a].atom];
-              if(fabs(at1->partialCharge - comp1) < R_SMALL4) {
-                base[0].sele[a] = true;
-                c++;
-              } else {
-                base[0].sele[a] = false;
-              }
-            }
-            break;
-          case SELE_FCHx:
-            for(a = cNDummyAtoms; a < I->NAtom; a++) {
-              at1 = &I->Obj[I->Table[a].model]->AtomInfo[I->Table[a].atom];
-              if(fabs(at1->formalCharge - comp1) < R_SMALL4) {
-                base[0].sele[a] = true;
-                c++;
-              } else {
-                base[0].sele[a] = false;
-              }
-            }
-            break;
-          }
+        case SELE_PCHx:
+          c = SelectorSelectFloatCmp(G, base->sele, oper, comp1,
+              [](const AtomInfoType * ai) { return ai->partialCharge; });
+          break;
+        case SELE_FCHx:
+          c = SelectorSelectFloatCmp(G, base->sele, oper, comp1,
+              [](const AtomInfoType * ai) { return (float) ai->formalCharge; });
           break;
         }
-        break;
       }
     }
+    break;
   }
 
   PRINTFD(G, FB_Selector)
     " SelectorSelect2: %d atoms selected.\n", c ENDFD;
+  if(ok)
+    SelectorEvalCacheStore(G, base, 2);
   return (ok);
 }
 
@@ -10994,6 +11834,9 @@ void SelectorFreeImpl(PyMOLGlobals * G, CSelector *I, short init2)
     OVLexicon_DEL_AUTO_NULL(I->Lex);
     OVOneToAny_DEL_AUTO_NULL(I->Key);
     OVOneToOne_DEL_AUTO_NULL(I->NameOffset);
+    DeleteP(I->EvalCache);
+    DeleteP(I->TableCache);
+    DeleteP(I->FoldedNames);
   }
   FreeP(I);
 }
@@ -11069,6 +11912,7 @@ void SelectorReinit(PyMOLGlobals * G)
   OVLexicon_DEL_AUTO_NULL(I->Lex);
   OVOneToAny_DEL_AUTO_NULL(I->Key);
   OVOneToOne_DEL_AUTO_NULL(I->NameOffset);
+  I->FoldedNames->clear();
 
   SelectorInit2(G, I);
 }
@@ -11095,10 +11939,14 @@ int SelectorInitImpl(PyMOLGlobals * G, CSelector **Iarg, short init2){
 
     if (init2){
       I->Member = (MemberType *) VLAMalloc(100, sizeof(MemberType), 5, true);
+      VLASetTag(I->Member, cMemorySelector);
       I->NMember = 0;
       I->FreeMember = 0;
       I->Name = VLAlloc(SelectorWordType, 10);
       I->Info = VLAlloc(SelectionInfoRec, 10);
+      I->EvalCache = new SelectorEvalCache();
+      I->TableCache = new SelectorTableCache();
+      I->FoldedNames = new std::unordered_map<std::string, int>();
       SelectorInit2(G, I);
     } else {
       CSelector *GI = G->Selector;
@@ -11112,6 +11960,7 @@ int SelectorInitImpl(PyMOLGlobals * G, CSelector **Iarg, short init2){
       I->Lex = GI->Lex;
       I->Key = GI->Key;
       I->NameOffset = GI->NameOffset;
+      I->FoldedNames = GI->FoldedNames;
       I->Name = GI->Name;
       I->Info = GI->Info;      
     }
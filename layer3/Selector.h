@@ -60,6 +60,9 @@ void SelectorCylinder(PyMOLGlobals * G, const char *sele, const char *onoff);
 int SelectorUpdateTable(PyMOLGlobals * G, int req_state, int domain);
 int SelectorUpdateTableImpl(PyMOLGlobals * G, CSelector *I, int req_state, int domain);
 
+void SelectorInvalidateEvalCache(PyMOLGlobals * G);
+void SelectorInvalidateTable(PyMOLGlobals * G);
+
 #define cSelectorUpdateTableAllStates -1
 #define cSelectorUpdateTableCurrentState -2
 #define cSelectorUpdateTableEffectiveStates -3
@@ -75,6 +78,10 @@ int SelectorGetTmp(PyMOLGlobals * G, const char *input, char *store, bool quiet=
 int SelectorCheckTmp(PyMOLGlobals * G, const char *name);
 int SelectorLoadCoords(PyMOLGlobals * G, PyObject * coords, int sele, int state);
 PyObject *SelectorGetCoordsAsNumPy(PyMOLGlobals * G, int sele, int state);
+PyObject *SelectorGetAtomPropertyAsNumPy(PyMOLGlobals * G, int sele,
+    const char *name, int codes);
+int SelectorLoadAtomProperty(PyMOLGlobals * G, PyObject * values, int sele,
+    const char *name);
 float SelectorSumVDWOverlap(PyMOLGlobals * G, int sele1, int state1,
                             int sele2, int state2, float adjust);
 int SelectorVdwFit(PyMOLGlobals * G, int sele1, int state1, int sele2, int state2,
@@ -172,6 +179,7 @@ ObjectMolecule *SelectorGetCachedSingleAtom(PyMOLGlobals * G, int sele, int *the
 ObjectMolecule *SelectorGetFastSingleAtomObjectIndex(PyMOLGlobals * G, int sele,
                                                      int *index);
 ObjectMolecule *SelectorGetFastSingleObjectMolecule(PyMOLGlobals * G, int sele);
+ObjectMolecule *SelectorGetKnownSingleObjectMolecule(PyMOLGlobals * G, int sele);
 MapType *SelectorGetSpacialMapFromSeleCoord(PyMOLGlobals * G, int sele, int state,
                                             float cutoff, float **coord_vla);
 int SelectorNameIsKeyword(PyMOLGlobals * G, const char *name);
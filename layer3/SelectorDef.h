@@ -8,6 +8,12 @@
 
 #include "os_std.h"
 
+#include <cstdint>
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
 #include "Selector.h"
 #include "ObjectMolecule.h"
 
@@ -35,6 +41,52 @@ struct SelectionInfoRec {
   int theOneAtom;
 };
 
+/*
+ * Memoized results of atom property keywords (e.g. "name CA", "b > 50"),
+ * so that scripts which evaluate many similar selections don't rescan
+ * all atoms for shared terms. Entries are valid for one table layout
+ * (see `table_hash`) and are dropped by SelectorInvalidateEvalCache
+ * whenever atom properties may have changed.
+ *
+ * Only single keyword terms are memoized, not composite expressions:
+ * and/or/not combine their operands in one pass over the atoms, which
+ * costs about as much as restoring a memoized result, and subexpressions
+ * usually contain terms which depend on coordinates, states or named
+ * selections (within, present, %sele) and would need their own
+ * invalidation.
+ */
+struct SelectorEvalCache {
+  struct Entry {
+    std::string key;            // keyword code and arguments
+    std::vector<bool> sele;
+  };
+  std::list<Entry> entries;     // most recently used first
+  uint64_t table_hash = 0;      // layout signature, see SelectorEvalCacheCheckTable
+};
+
+/*
+ * Layout of the atom table built by SelectorUpdateTableImpl, one segment
+ * per iterated object (including the dummies and objects which
+ * contribute no atoms). Segments whose object didn't change are copied
+ * instead of being rebuilt, and if nothing changed at all, the table is
+ * reused as is.
+ */
+struct SelectorTableSegment {
+  ObjectMolecule *obj;
+  int generation;               // obj->SeleGeneration when built
+  int n_atom;                   // obj->NAtom when built
+  int state;                    // -1 for all states
+  const CoordSet *cs;           // coordinate set for `state` (or NULL)
+  int cs_n_index;
+  ov_size start, count;         // range in Table
+};
+
+struct SelectorTableCache {
+  bool valid = false;
+  int req_state = 0;
+  std::vector<SelectorTableSegment> segments;
+};
+
 struct CSelector {
   MemberType *Member;           /* Must be first in structure, so that we can get this w/o knowing the struct */
   SelectorWordType *Name;       /* this seems rather excessive, since name len < ObjNameMax ... */
@@ -55,4 +107,7 @@ struct CSelector {
   OVLexicon *Lex;
   OVOneToAny *Key;
   OVOneToOne *NameOffset;
+  std::unordered_map<std::string, int> *FoldedNames; // lowercase name -> count
+  SelectorEvalCache *EvalCache;
+  SelectorTableCache *TableCache;
 };
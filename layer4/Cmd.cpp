@@ -76,6 +76,7 @@ Z* -------------------------------------------------------------------
 #include"Editor.h"
 #include"Wizard.h"
 #include"SculptCache.h"
+#include"RepCache.h"
 #include"TestPyMOL.h"
 #include"Color.h"
 #include"Seq.h"
@@ -2003,6 +2004,62 @@ static PyObject *CmdGetRenderer(PyObject * self, PyObject * args)
   return Py_BuildValue("(sss)", vendor, renderer, version);
 }
 
+static PyObject *CmdGetRepCacheStats(PyObject * self, PyObject * args)
+{
+  PyMOLGlobals *G = NULL;
+  PyObject *result = NULL;
+  RepCacheStats stats;
+  int reset = 0;
+
+  if(!PyArg_ParseTuple(args, "O|i", &self, &reset)) {
+    API_HANDLE_ERROR;
+    ok_raise(2);
+  }
+
+  API_SETUP_PYMOL_GLOBALS;
+  ok_assert(2, G && APIEnterNotModal(G));
+
+  RepCacheGetStats(G, &stats);
+  if(reset)
+    RepCacheResetStats(G);
+
+  APIExit(G);
+
+  result = Py_BuildValue("{s:K,s:K,s:K,s:i,s:i,s:i,s:i,s:i}",
+      "bytes", (unsigned long long) stats.bytes,
+      "peak", (unsigned long long) stats.peak,
+      "budget", (unsigned long long) stats.budget,
+      "entries", stats.entries,
+      "hits", stats.hits,
+      "builds", stats.builds,
+      "evictions", stats.evictions,
+      "prefetched", stats.prefetched);
+
+ok_except2:
+  return APIAutoNone(result);
+}
+
+static PyObject *CmdGetMemoryReport(PyObject * self, PyObject * args)
+{
+  PyMOLGlobals *G = NULL;
+  PyObject *result = NULL;
+
+  if(!PyArg_ParseTuple(args, "O", &self)) {
+    API_HANDLE_ERROR;
+    ok_raise(2);
+  }
+
+  API_SETUP_PYMOL_GLOBALS;
+  ok_assert(2, G && APIEnterBlockedNotModal(G));
+
+  result = ExecutiveGetMemoryReport(G);
+
+  APIExitBlocked(G);
+
+ok_except2:
+  return APIAutoNone(result);
+}
+
 #include <PyMOLBuildInfo.h>
 
 static PyObject *CmdGetVersion(PyObject * self, PyObject * args)
@@ -2373,6 +2430,59 @@ static PyObject *CmdAlign(PyObject * self, PyObject * args)
   }
 }
 
+static PyObject *CmdAlignMatrix(PyObject * self, PyObject * args)
+{
+  PyMOLGlobals *G = NULL;
+  PyObject *py_seles, *result = NULL;
+  char *mfile;
+  int ok = false;
+  int quiet, cycles, max_skip, max_gap, state, window;
+  float cutoff, gap, extend, seq;
+  float radius, scale, base, coord, expect, ante;
+  std::vector<std::string> seles, tmp;
+  std::vector<float> rms, score;
+  std::vector<int> n_atom;
+
+  ok = PyArg_ParseTuple(args, "OOfiffisiiiffffffif", &self, &py_seles,
+                        &cutoff, &cycles, &gap, &extend, &max_gap,
+                        &mfile, &state, &quiet, &max_skip, &seq,
+                        &radius, &scale, &base, &coord, &expect,
+                        &window, &ante);
+
+  if(ok) {
+    API_SETUP_PYMOL_GLOBALS;
+    ok = (G != NULL) && PConvFromPyObject(G, py_seles, seles);
+  } else {
+    API_HANDLE_ERROR;
+  }
+  if(ok && (ok = APIEnterNotModal(G))) {
+    for(auto & sele : seles) {
+      OrthoLineType s1 = "";
+      if(SelectorGetTmp(G, sele.c_str(), s1) < 0)
+        ok = false;
+      tmp.push_back(s1);
+    }
+    if(ok) {
+      ok = ExecutiveAlignMatrix(G, tmp, mfile, gap, extend, max_gap,
+                                max_skip, cutoff, cycles, quiet, state, seq,
+                                radius, scale, base, coord, expect, window,
+                                ante, rms, n_atom, score);
+    }
+    for(auto & s1 : tmp)
+      SelectorFreeTmp(G, s1.c_str());
+    APIExit(G);
+  }
+  if(ok) {
+    result = Py_BuildValue("(NNN)",
+                           PConvToPyObject(rms),
+                           PConvToPyObject(n_atom),
+                           PConvToPyObject(score));
+  }
+  if(!result)
+    return APIFailure();
+  return result;
+}
+
 static PyObject *CmdGetCoordsAsNumPy(PyObject * self, PyObject * args)
 {
   PyMOLGlobals *G = NULL;
@@ -2405,6 +2515,155 @@ ok_except2:
   return (APIAutoNone(result));
 }
 
+static PyObject *CmdGetAtomPropertyAsNumPy(PyObject * self, PyObject * args)
+{
+  PyMOLGlobals *G = NULL;
+  char *str1, *name;
+  int codes = 0;
+  OrthoLineType s1;
+  PyObject *result = NULL;
+
+  if(!PyArg_ParseTuple(args, "Oss|i", &self, &str1, &name, &codes)) {
+    API_HANDLE_ERROR;
+    ok_raise(2);
+  }
+
+  ok_assert(2, str1[0]);
+  API_SETUP_PYMOL_GLOBALS;
+  ok_assert(2, G && APIEnterBlockedNotModal(G));
+
+  if(SelectorGetTmp(G, str1, s1) >= 0) {
+    int sele1 = SelectorIndexByName(G, s1);
+    if(sele1 >= 0) {
+      result = SelectorGetAtomPropertyAsNumPy(G, sele1, name, codes);
+    }
+    SelectorFreeTmp(G, s1);
+  }
+
+  APIExitBlocked(G);
+ok_except2:
+  return (APIAutoNone(result));
+}
+
+static PyObject *CmdSetAtomProperty(PyObject * self, PyObject * args)
+{
+  PyMOLGlobals *G = NULL;
+  char *str1, *name;
+  int result = false;
+  OrthoLineType s1;
+  PyObject *values = NULL;
+
+  if(!PyArg_ParseTuple(args, "OssO", &self, &str1, &name, &values)) {
+    API_HANDLE_ERROR;
+    ok_raise(2);
+  }
+
+  ok_assert(2, str1[0]);
+  API_SETUP_PYMOL_GLOBALS;
+  ok_assert(2, G && APIEnterBlockedNotModal(G));
+
+  if(SelectorGetTmp(G, str1, s1) >= 0) {
+    int sele1 = SelectorIndexByName(G, s1);
+    if(sele1 >= 0) {
+      result = SelectorLoadAtomProperty(G, values, sele1, name);
+    }
+    SelectorFreeTmp(G, s1);
+  }
+
+  APIExitBlocked(G);
+ok_except2:
+  return APIResultOk(result);
+}
+
+static PyObject *CmdGetGeometrySeries(PyObject * self, PyObject * args)
+{
+  PyMOLGlobals *G = NULL;
+  PyObject *py_seles, *result = NULL;
+  int first, last;
+  std::vector<std::string> seles;
+
+  if(!PyArg_ParseTuple(args, "OOii", &self, &py_seles, &first, &last)) {
+    API_HANDLE_ERROR;
+    ok_raise(2);
+  }
+
+  API_SETUP_PYMOL_GLOBALS;
+  ok_assert(2, G && PConvFromPyObject(G, py_seles, seles));
+  ok_assert(2, APIEnterBlockedNotModal(G));
+
+  result = ExecutiveGetGeometrySeries(G, seles, first, last);
+
+  APIExitBlocked(G);
+ok_except2:
+  return (APIAutoNone(result));
+}
+
+static PyObject *CmdGetGyrationSeries(PyObject * self, PyObject * args)
+{
+  PyMOLGlobals *G = NULL;
+  PyObject *result = NULL;
+  char *str1;
+  int first, last;
+
+  if(!PyArg_ParseTuple(args, "Osii", &self, &str1, &first, &last)) {
+    API_HANDLE_ERROR;
+    ok_raise(2);
+  }
+
+  API_SETUP_PYMOL_GLOBALS;
+  ok_assert(2, G && APIEnterBlockedNotModal(G));
+
+  result = ExecutiveGetGyrationSeries(G, str1, first, last);
+
+  APIExitBlocked(G);
+ok_except2:
+  return (APIAutoNone(result));
+}
+
+static PyObject *CmdGetRMSF(PyObject * self, PyObject * args)
+{
+  PyMOLGlobals *G = NULL;
+  PyObject *result = NULL;
+  char *str1;
+  int first, last;
+
+  if(!PyArg_ParseTuple(args, "Osii", &self, &str1, &first, &last)) {
+    API_HANDLE_ERROR;
+    ok_raise(2);
+  }
+
+  API_SETUP_PYMOL_GLOBALS;
+  ok_assert(2, G && APIEnterBlockedNotModal(G));
+
+  result = ExecutiveGetRMSF(G, str1, first, last);
+
+  APIExitBlocked(G);
+ok_except2:
+  return (APIAutoNone(result));
+}
+
+static PyObject *CmdGetAtomAreas(PyObject * self, PyObject * args)
+{
+  PyMOLGlobals *G = NULL;
+  PyObject *result = NULL;
+  char *str1;
+  int state;
+
+  if(!PyArg_ParseTuple(args, "Osi", &self, &str1, &state)) {
+    API_HANDLE_ERROR;
+    ok_raise(2);
+  }
+
+  API_SETUP_PYMOL_GLOBALS;
+  ok_assert(2, G && APIEnterBlockedNotModal(G));
+
+  result = ExecutiveGetAtomAreas(G, str1, state);
+
+  APIExitBlocked(G);
+ok_except2:
+  return (APIAutoNone(result));
+}
+
 static PyObject *CmdGetCoordSetAsNumPy(PyObject * self, PyObject * args)
 {
   PyMOLGlobals *G = NULL;
@@ -4971,6 +5230,63 @@ ok_except1:
   return APIAutoNone(NULL);
 }
 
+/*
+ * Like CmdGetStr, but streams directly to a file
+ */
+static PyObject *CmdSaveMolecule(PyObject * self, PyObject * args)
+{
+  PyMOLGlobals *G = NULL;
+  char *filename;
+  char *format;
+  char *sele;
+  int state;
+  char *ref;
+  int ref_state;
+  int multi;
+  int append;
+  int quiet;
+  int ok = false;
+
+  ok_assert(1, PyArg_ParseTuple(args, "Osssisiiii", &self, &filename,
+        &format, &sele, &state, &ref, &ref_state, &multi, &append, &quiet));
+  API_SETUP_PYMOL_GLOBALS;
+  ok_assert(1, G && APIEnterNotModal(G));
+
+  ok = MoleculeExporterWriteFile(G, filename, append, format, sele, state,
+      ref, ref_state, multi, quiet);
+
+  APIExit(G);
+  return APIResultOk(ok);
+ok_except1:
+  API_HANDLE_ERROR;
+  return APIFailure();
+}
+
+static PyObject *CmdSaveTraj(PyObject * self, PyObject * args)
+{
+  PyMOLGlobals *G = NULL;
+  char *filename;
+  char *sele;
+  int start, stop, interval;
+  char *plugin;
+  int quiet;
+  int ok = false;
+
+  ok_assert(1, PyArg_ParseTuple(args, "Ossiiisi", &self, &filename,
+        &sele, &start, &stop, &interval, &plugin, &quiet));
+  API_SETUP_PYMOL_GLOBALS;
+  ok_assert(1, G && APIEnterNotModal(G));
+
+  ok = PlugIOManagerSaveTraj(G, filename, sele, start, stop, interval,
+      quiet, plugin);
+
+  APIExit(G);
+  return APIResultOk(ok);
+ok_except1:
+  API_HANDLE_ERROR;
+  return APIFailure();
+}
+
 static PyObject *CmdGetModel(PyObject * self, PyObject * args)
 {
   PyMOLGlobals *G = NULL;
@@ -7344,6 +7660,43 @@ static PyObject *CmdLoad(PyObject * self, PyObject * args)
   return APIResultOk(ok);
 }
 
+static PyObject *CmdLoadBatch(PyObject * self, PyObject * args)
+{
+  PyMOLGlobals *G = NULL;
+  PyObject *py_fnames, *py_onames, *py_types;
+  std::vector<std::string> fnames, onames;
+  std::vector<int> types;
+  std::vector<ExecutiveLoadBatchEntry> entries;
+  int frame, zoom, discrete, multiplex, quiet;
+  int ok = false;
+
+  if(!PyArg_ParseTuple(args, "OOOOiiiii", &self, &py_fnames, &py_onames,
+                       &py_types, &frame, &zoom, &discrete, &multiplex, &quiet)) {
+    API_HANDLE_ERROR;
+    ok_raise(2);
+  }
+
+  API_SETUP_PYMOL_GLOBALS;
+  ok_assert(2, G &&
+      PConvFromPyObject(G, py_fnames, fnames) &&
+      PConvFromPyObject(G, py_onames, onames) &&
+      PConvFromPyObject(G, py_types, types));
+  ok_assert(2, fnames.size() == onames.size() && fnames.size() == types.size());
+
+  for(size_t i = 0; i < fnames.size(); ++i) {
+    entries.push_back({fnames[i], onames[i], (cLoadType_t) types[i]});
+  }
+
+  ok_assert(2, APIEnterNotModal(G));
+
+  ok = ExecutiveLoadBatch(G, entries, frame, zoom, discrete, multiplex, quiet);
+
+  OrthoRestorePrompt(G);
+  APIExit(G);
+ok_except2:
+  return APIResultOk(ok);
+}
+
 static PyObject *CmdLoadTraj(PyObject * self, PyObject * args)
 {
   PyMOLGlobals *G = NULL;
@@ -8439,6 +8792,7 @@ static PyMethodDef Cmd_methods[] = {
   {"_sdof", Cmd_Sdof, METH_VARARGS},
   {"accept", CmdAccept, METH_VARARGS},
   {"align", CmdAlign, METH_VARARGS},
+  {"align_matrix", CmdAlignMatrix, METH_VARARGS},
   {"alter", CmdAlter, METH_VARARGS},
   {"alter_list", CmdAlterList, METH_VARARGS},
   {"alter_state", CmdAlterState, METH_VARARGS},
@@ -8500,6 +8854,7 @@ static PyMethodDef Cmd_methods[] = {
   {"fuse", CmdFuse, METH_VARARGS},
   {"get_angle", CmdGetAngle, METH_VARARGS},
   {"get_area", CmdGetArea, METH_VARARGS},
+  {"get_atom_areas", CmdGetAtomAreas, METH_VARARGS},
   {"get_atom_coords", CmdGetAtomCoords, METH_VARARGS},
   {"get_bond_print", CmdGetBondPrint, METH_VARARGS},
   {"get_busy", CmdGetBusy, METH_VARARGS},
@@ -8508,7 +8863,11 @@ static PyMethodDef Cmd_methods[] = {
   {"get_color", CmdGetColor, METH_VARARGS},
   {"get_colorection", CmdGetColorection, METH_VARARGS},
   {"get_coords", CmdGetCoordsAsNumPy, METH_VARARGS},
+  {"get_atom_property", CmdGetAtomPropertyAsNumPy, METH_VARARGS},
   {"get_coordset", CmdGetCoordSetAsNumPy, METH_VARARGS},
+  {"get_geometry_series", CmdGetGeometrySeries, METH_VARARGS},
+  {"get_gyration_series", CmdGetGyrationSeries, METH_VARARGS},
+  {"get_rmsf", CmdGetRMSF, METH_VARARGS},
   {"get_distance", CmdGetDistance, METH_VARARGS},
   {"get_dihe", CmdGetDihe, METH_VARARGS},
   {"get_drag_object_name", CmdGetDragObjectName, METH_VARARGS},
@@ -8538,6 +8897,8 @@ static PyMethodDef Cmd_methods[] = {
   {"get_progress", CmdGetProgress, METH_VARARGS},
   {"get_phipsi", CmdGetPhiPsi, METH_VARARGS},
   {"get_renderer", CmdGetRenderer, METH_VARARGS},
+  {"get_rep_cache_stats", CmdGetRepCacheStats, METH_VARARGS},
+  {"get_memory_report", CmdGetMemoryReport, METH_VARARGS},
   {"get_raw_alignment", CmdGetRawAlignment, METH_VARARGS},
   {"get_seq_align_str", CmdGetSeqAlignStr, METH_VARARGS},
   {"get_session", CmdGetSession, METH_VARARGS},
@@ -8551,6 +8912,8 @@ static PyMethodDef Cmd_methods[] = {
   {"get_symmetry", CmdGetSymmetry, METH_VARARGS},
   {"get_state", CmdGetState, METH_VARARGS},
   {"get_str", CmdGetStr, METH_VARARGS},
+  {"save_molecule", CmdSaveMolecule, METH_VARARGS},
+  {"save_traj", CmdSaveTraj, METH_VARARGS},
   {"get_title", CmdGetTitle, METH_VARARGS},
   {"get_type", CmdGetType, METH_VARARGS},
   {"get_unused_name", CmdGetUnusedName, METH_VARARGS},
@@ -8584,8 +8947,10 @@ static PyMethodDef Cmd_methods[] = {
   {"label", CmdLabel, METH_VARARGS},
   {"label2", CmdLabel2, METH_VARARGS},
   {"load", CmdLoad, METH_VARARGS},
+  {"load_batch", CmdLoadBatch, METH_VARARGS},
   {"load_color_table", CmdLoadColorTable, METH_VARARGS},
   {"load_coords", CmdLoadCoords, METH_VARARGS},
+  {"set_atom_property", CmdSetAtomProperty, METH_VARARGS},
   {"load_coordset", CmdLoadCoordSet, METH_VARARGS},
   {"load_png", CmdLoadPNG, METH_VARARGS},
   {"load_object", CmdLoadObject, METH_VARARGS},
@@ -47,6 +47,7 @@
 #include "P.h"
 #include "Editor.h"
 #include "SculptCache.h"
+#include "RepCache.h"
 #include "Isosurf.h"
 #include "Tetsurf.h"
 #include "PConv.h"
@@ -2073,6 +2074,7 @@ void PyMOL_Start(CPyMOL * I)
   ControlInit(G);
   AtomInfoInit(G);
   SculptCacheInit(G);
+  RepCacheInit(G);
   VFontInit(G);
   ExecutiveInit(G);
   IsosurfInit(G);
@@ -2156,6 +2158,7 @@ void PyMOL_Stop(CPyMOL * I)
   ExecutiveFree(G);
   VFontFree(G);
   SculptCacheFree(G);
+  RepCacheFree(G);
   AtomInfoFree(G);
   ButModeFree(G);
   ControlFree(G);
@@ -2974,6 +2977,24 @@ int PyMOL_GetBusy(CPyMOL * I, int reset)
   return result;
 }
 
+int PyMOL_GetMemoryUsage(CPyMOL * I, long long *bytes, long long *counts, int size)
+{                               /* lock intentionally omitted, counters are atomic */
+  long long all_bytes[cMemoryTagCount], all_counts[cMemoryTagCount];
+  MemoryGetUsage(all_bytes, all_counts);
+  for(int a = 0; a < size && a < cMemoryTagCount; a++) {
+    if(bytes)
+      bytes[a] = all_bytes[a];
+    if(counts)
+      counts[a] = all_counts[a];
+  }
+  return cMemoryTagCount;
+}
+
+const char *PyMOL_GetMemoryTagName(int tag)
+{
+  return MemoryTagName(tag);
+}
+
 void PyMOL_SetBusy(CPyMOL * I, int value)
 {                               /* lock intentionally omitted */
   if(!I->BusyFlag)
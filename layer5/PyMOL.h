@@ -155,6 +155,8 @@ typedef struct _CPyMOL CPyMOL;
 #define ATOM_PROP_Z 32
 #define ATOM_PROP_SETTINGS 33
 #define ATOM_PROP_PROPERTIES 34
+#define ATOM_PROP_REPS 38
+#define ATOM_PROP_PROTONS 39
 #define ATOM_PROP_ONELETTER 40
 
 /* return status values */
@@ -337,6 +339,14 @@ int PyMOL_GetModalDraw(CPyMOL * I);
 void PyMOL_SetModalDraw(CPyMOL * I, PyMOLModalDrawFn * fn);     /* for internal use only */
 
 
+/* memory accounting -- live bytes and allocation counts per subsystem
+   ("atoms", "coords", "cgo", "fields", "selector", "other"). Fills up to
+   `size` entries and returns the number of subsystems. */
+
+int PyMOL_GetMemoryUsage(CPyMOL * I, long long *bytes, long long *counts, int size);
+const char *PyMOL_GetMemoryTagName(int tag);
+
+
 /* developer/transient privates */
 
 struct _PyMOLGlobals *PyMOL_GetGlobals(CPyMOL * I);
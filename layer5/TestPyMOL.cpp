@@ -17,6 +17,8 @@ Z* -------------------------------------------------------------------
 
 
 /* Module for internal C-level PyMOL tests...*/
+#include <vector>
+
 #include"os_python.h"
 #include"os_predef.h"
 #include"os_std.h"
@@ -37,6 +39,14 @@ Z* -------------------------------------------------------------------
 #include"Control.h"
 
 #include"PyMOL.h"
+#include"Util.h"
+
+#include"OVContext.h"
+#include"OVOneToOne.h"
+#include"OVOneToAny.h"
+#include"OVLexicon.h"
+#include"Parallel.h"
+#include"Setting.h"
 
 static int TestPyMOL_00_00(PyMOLGlobals * G)
 {
@@ -69,6 +79,316 @@ static int TestPyMOL_00_00(PyMOLGlobals * G)
   return (obj != NULL);
 }
 
+/*
+ * Micro-benchmarks of the ov hash tables with n_key sequential (like
+ * unique ids) or random keys: insert, lookup (hits and misses), reverse
+ * lookup, delete. Every pass also checks its results.
+ */
+static void TestPyMOL_02_Report(PyMOLGlobals * G, const char *what, int n, double t)
+{
+  PRINTFB(G, FB_Executive, FB_Results)
+    " Benchmark: %-44s %8.1f ns/op\n", what, t * 1e9 / n ENDFB(G);
+}
+
+static int TestPyMOL_02_Check(PyMOLGlobals * G, const char *what, long got, long expected)
+{
+  if(got == expected)
+    return true;
+  PRINTFB(G, FB_Executive, FB_Errors)
+    " Benchmark-Error: %s: got %ld, expected %ld\n", what, got, expected ENDFB(G);
+  return false;
+}
+
+static int TestPyMOL_02_00(PyMOLGlobals * G, int n_key, int random)
+{
+  OVHeap *heap = G->Context->heap;
+  std::vector<ov_word> keys(n_key);
+  int ok = true;
+  long n_found;
+  double t;
+  char what[64];
+
+  /* random keys are a scrambled (multiplication by an odd constant modulo
+     2^31 is a bijection) sequence, so that they are guaranteed distinct */
+  for(int a = 0; a < n_key; a++)
+    keys[a] = random ?
+      (ov_word) (((ov_uword) (a + 1) * 2654435761U) & 0x7FFFFFFF) : (ov_word) (a + 1);
+
+  const char *kind = random ? "random" : "sequential";
+
+  /* OVOneToOne: key <-> index */
+  for(int presized = 0; presized < 2; presized++) {
+    OVOneToOne *o2o = OVOneToOne_New(heap);
+
+    t = UtilGetSeconds(G);
+    if(presized)
+      OVOneToOne_Reserve(o2o, n_key);
+    n_found = 0;
+    for(int a = 0; a < n_key; a++)
+      n_found += OVreturn_IS_OK(OVOneToOne_Set(o2o, keys[a], a));
+    sprintf(what, "OVOneToOne_Set (%s%s)", kind, presized ? ", presized" : "");
+    TestPyMOL_02_Report(G, what, n_key, UtilGetSeconds(G) - t);
+    ok = TestPyMOL_02_Check(G, what, n_found, n_key) && ok;
+    ok = TestPyMOL_02_Check(G, "OVOneToOne_GetSize",
+                            OVOneToOne_GetSize(o2o).size, n_key) && ok;
+
+    if(!presized) {
+      OVreturn_word ret;
+
+      t = UtilGetSeconds(G);
+      n_found = 0;
+      for(int a = 0; a < n_key; a++)
+        n_found += (OVreturn_IS_OK(ret = OVOneToOne_GetForward(o2o, keys[a])) &&
+                    ret.word == a);
+      sprintf(what, "OVOneToOne_GetForward (%s)", kind);
+      TestPyMOL_02_Report(G, what, n_key, UtilGetSeconds(G) - t);
+      ok = TestPyMOL_02_Check(G, what, n_found, n_key) && ok;
+
+      t = UtilGetSeconds(G);
+      n_found = 0;
+      for(int a = 0; a < n_key; a++)
+        n_found += OVreturn_IS_OK(OVOneToOne_GetForward(o2o, -keys[a] - 1));
+      sprintf(what, "OVOneToOne_GetForward miss (%s)", kind);
+      TestPyMOL_02_Report(G, what, n_key, UtilGetSeconds(G) - t);
+      ok = TestPyMOL_02_Check(G, what, n_found, 0) && ok;
+
+      t = UtilGetSeconds(G);
+      n_found = 0;
+      for(int a = 0; a < n_key; a++)
+        n_found += (OVreturn_IS_OK(ret = OVOneToOne_GetReverse(o2o, a)) &&
+                    ret.word == keys[a]);
+      sprintf(what, "OVOneToOne_GetReverse (%s)", kind);
+      TestPyMOL_02_Report(G, what, n_key, UtilGetSeconds(G) - t);
+      ok = TestPyMOL_02_Check(G, what, n_found, n_key) && ok;
+
+      /* delete every other key, the rest must still be there */
+      t = UtilGetSeconds(G);
+      n_found = 0;
+      for(int a = 0; a < n_key; a += 2)
+        n_found += OVreturn_IS_OK(OVOneToOne_DelForward(o2o, keys[a]));
+      sprintf(what, "OVOneToOne_DelForward (%s)", kind);
+      TestPyMOL_02_Report(G, what, (n_key + 1) / 2, UtilGetSeconds(G) - t);
+      ok = TestPyMOL_02_Check(G, what, n_found, (n_key + 1) / 2) && ok;
+      ok = TestPyMOL_02_Check(G, "OVOneToOne_GetSize after delete",
+                              OVOneToOne_GetSize(o2o).size, n_key / 2) && ok;
+
+      n_found = 0;
+      for(int a = 0; a < n_key; a++) {
+        ret = OVOneToOne_GetForward(o2o, keys[a]);
+        if(a % 2)
+          n_found += (OVreturn_IS_OK(ret) && ret.word == a &&
+                      OVOneToOne_GetReverse(o2o, a).word == keys[a]);
+        else
+          n_found += (ret.status == OVstatus_NOT_FOUND &&
+                      OVOneToOne_GetReverse(o2o, a).status == OVstatus_NOT_FOUND);
+      }
+      ok = TestPyMOL_02_Check(G, "OVOneToOne lookup after delete", n_found, n_key) && ok;
+    }
+
+    OVOneToOne_Del(o2o);
+  }
+
+  /* OVOneToAny: key -> index */
+  for(int presized = 0; presized < 2; presized++) {
+    OVOneToAny *o2a = OVOneToAny_New(heap);
+
+    t = UtilGetSeconds(G);
+    if(presized)
+      OVOneToAny_Reserve(o2a, n_key);
+    n_found = 0;
+    for(int a = 0; a < n_key; a++)
+      n_found += OVreturn_IS_OK(OVOneToAny_SetKey(o2a, keys[a], a));
+    sprintf(what, "OVOneToAny_SetKey (%s%s)", kind, presized ? ", presized" : "");
+    TestPyMOL_02_Report(G, what, n_key, UtilGetSeconds(G) - t);
+    ok = TestPyMOL_02_Check(G, what, n_found, n_key) && ok;
+    ok = TestPyMOL_02_Check(G, "OVOneToAny_GetSize",
+                            OVOneToAny_GetSize(o2a).size, n_key) && ok;
+
+    if(!presized) {
+      OVreturn_word ret;
+
+      t = UtilGetSeconds(G);
+      n_found = 0;
+      for(int a = 0; a < n_key; a++)
+        n_found += (OVreturn_IS_OK(ret = OVOneToAny_GetKey(o2a, keys[a])) &&
+                    ret.word == a);
+      sprintf(what, "OVOneToAny_GetKey (%s)", kind);
+      TestPyMOL_02_Report(G, what, n_key, UtilGetSeconds(G) - t);
+      ok = TestPyMOL_02_Check(G, what, n_found, n_key) && ok;
+
+      t = UtilGetSeconds(G);
+      n_found = 0;
+      for(int a = 0; a < n_key; a++)
+        n_found += OVreturn_IS_OK(OVOneToAny_GetKey(o2a, -keys[a] - 1));
+      sprintf(what, "OVOneToAny_GetKey miss (%s)", kind);
+      TestPyMOL_02_Report(G, what, n_key, UtilGetSeconds(G) - t);
+      ok = TestPyMOL_02_Check(G, what, n_found, 0) && ok;
+
+      /* delete every other key (shrinks the table), the rest must still be there */
+      t = UtilGetSeconds(G);
+      n_found = 0;
+      for(int a = 0; a < n_key; a += 2)
+        n_found += OVreturn_IS_OK(OVOneToAny_DelKey(o2a, keys[a]));
+      sprintf(what, "OVOneToAny_DelKey (%s)", kind);
+      TestPyMOL_02_Report(G, what, (n_key + 1) / 2, UtilGetSeconds(G) - t);
+      ok = TestPyMOL_02_Check(G, what, n_found, (n_key + 1) / 2) && ok;
+      ok = TestPyMOL_02_Check(G, "OVOneToAny_GetSize after delete",
+                              OVOneToAny_GetSize(o2a).size, n_key / 2) && ok;
+
+      n_found = 0;
+      for(int a = 0; a < n_key; a++) {
+        ret = OVOneToAny_GetKey(o2a, keys[a]);
+        if(a % 2)
+          n_found += (OVreturn_IS_OK(ret) && ret.word == a);
+        else
+          n_found += (ret.status == OVstatus_NOT_FOUND);
+      }
+      ok = TestPyMOL_02_Check(G, "OVOneToAny lookup after delete", n_found, n_key) && ok;
+
+      for(int a = 1; a < n_key; a += 2)
+        OVOneToAny_DelKey(o2a, keys[a]);
+      ok = TestPyMOL_02_Check(G, "OVOneToAny_GetSize after delete all",
+                              OVOneToAny_GetSize(o2a).size, 0) && ok;
+    }
+
+    OVOneToAny_Del(o2a);
+  }
+
+  return ok;
+}
+
+/*
+ * Interns n_str atom-name like strings (few distinct values, many repeats)
+ * from n_thread threads into a private lexicon and checks that all threads
+ * got the same identifiers, then releases them again.
+ */
+static int TestPyMOL_02_01(PyMOLGlobals * G, int n_str, int n_thread)
+{
+  static const char *names[] = {
+    "N", "CA", "C", "O", "CB", "CG", "CD", "CE", "NZ", "OG", "SG", "CZ"
+  };
+  const int n_name = sizeof(names) / sizeof(names[0]);
+  OVLexicon *lex = OVLexicon_New(G->Context->heap);
+  std::vector<std::vector<ov_word> > ids(n_thread, std::vector<ov_word>(n_str));
+  int ok = (lex != NULL);
+  double t;
+  char what[64];
+
+  if(!ok)
+    return false;
+
+  t = UtilGetSeconds(G);
+  pymol::parallel_for(n_thread, n_thread, [&](int thread) {
+    char buf[16];
+    for(int a = 0; a < n_str; a++) {
+      if(a % 4) {
+        ids[thread][a] = OVLexicon_GetFromCString(lex, names[a % n_name]).word;
+      } else {
+        sprintf(buf, "R%d", a % 10000);
+        ids[thread][a] = OVLexicon_GetFromCString(lex, buf).word;
+      }
+    }
+  });
+  sprintf(what, "OVLexicon_GetFromCString (%d threads)", n_thread);
+  TestPyMOL_02_Report(G, what, n_str * n_thread, UtilGetSeconds(G) - t);
+
+  for(int thread = 1; thread < n_thread; thread++)
+    if(ids[thread] != ids[0])
+      ok = false;
+
+  t = UtilGetSeconds(G);
+  pymol::parallel_for(n_thread, n_thread, [&](int thread) {
+    for(int a = 0; a < n_str; a++)
+      OVLexicon_DecRef(lex, ids[thread][a]);
+  });
+  sprintf(what, "OVLexicon_DecRef (%d threads)", n_thread);
+  TestPyMOL_02_Report(G, what, n_str * n_thread, UtilGetSeconds(G) - t);
+
+  if(OVLexicon_GetNActive(lex))
+    ok = false;
+
+  OVLexicon_Del(lex);
+
+  if(!ok) {
+    PRINTFB(G, FB_Executive, FB_Errors)
+      " Benchmark-Error: inconsistent lexicon identifiers\n" ENDFB(G);
+  }
+  return ok;
+}
+
+/*
+ * Rebuilds the unique id -> atom dictionary of the current session (as
+ * after adding or removing atoms) and looks up every atom with a unique id
+ * in it and in the per-atom settings, like alignment objects, measurements
+ * and per-atom settings/labels do. Load something label/setting-heavy first.
+ */
+static int TestPyMOL_02_02(PyMOLGlobals * G, int n_rep)
+{
+  std::vector<ExecutiveObjectOffset> atoms;
+  std::vector<int> ids;
+  ObjectMolecule *obj = NULL;
+  void *hidden = NULL;
+  int ok = true;
+  long n_found = 0, n_setting = 0, n_has_setting = 0;
+  double t;
+
+  while(ExecutiveIterateObjectMolecule(G, &obj, &hidden)) {
+    const AtomInfoType *ai = obj->AtomInfo;
+    for(int a = 0; a < obj->NAtom; a++, ai++) {
+      if(ai->unique_id) {
+        ExecutiveObjectOffset eoo = { obj, a };
+        atoms.push_back(eoo);
+        ids.push_back(ai->unique_id);
+        n_has_setting += ai->has_setting;
+      }
+    }
+  }
+
+  int n_id = (int) ids.size();
+  if(!n_id) {
+    PRINTFB(G, FB_Executive, FB_Errors)
+      " Benchmark-Error: no atoms with unique ids (set per-atom settings first)\n"
+      ENDFB(G);
+    return false;
+  }
+
+  t = UtilGetSeconds(G);
+  for(int r = 0; r < n_rep; r++) {
+    ExecutiveUniqueIDAtomDictInvalidate(G);
+    ExecutiveUniqueIDAtomDictGet(G, ids[0]);
+  }
+  TestPyMOL_02_Report(G, "unique id dictionary build (per atom)", n_rep * n_id,
+                      UtilGetSeconds(G) - t);
+
+  t = UtilGetSeconds(G);
+  for(int r = 0; r < n_rep; r++) {
+    n_found = 0;
+    for(int a = 0; a < n_id; a++) {
+      const ExecutiveObjectOffset *eoo = ExecutiveUniqueIDAtomDictGet(G, ids[a]);
+      n_found += (eoo && eoo->obj == atoms[a].obj && eoo->atm == atoms[a].atm);
+    }
+  }
+  TestPyMOL_02_Report(G, "ExecutiveUniqueIDAtomDictGet", n_rep * n_id,
+                      UtilGetSeconds(G) - t);
+  ok = TestPyMOL_02_Check(G, "ExecutiveUniqueIDAtomDictGet", n_found, n_id) && ok;
+
+  t = UtilGetSeconds(G);
+  for(int r = 0; r < n_rep; r++) {
+    n_setting = 0;
+    for(int a = 0; a < n_id; a++) {
+      n_setting += SettingUniqueCheck(G, ids[a], cSetting_label_color);
+      n_setting += SettingUniqueCheck(G, ids[a], cSetting_sphere_scale);
+    }
+  }
+  TestPyMOL_02_Report(G, "SettingUniqueCheck", 2 * n_rep * n_id,
+                      UtilGetSeconds(G) - t);
+
+  PRINTFB(G, FB_Executive, FB_Blather)
+    " Benchmark: %d atoms with unique ids, %ld with settings, %ld settings found\n",
+    n_id, n_has_setting, n_setting ENDFB(G);
+  return ok;
+}
+
 #define STR_MAX 100
 
 static char *get_st(const char array[][STR_MAX])
@@ -288,6 +608,7 @@ static const char mol_01_02[][STR_MAX] = {
 
 int TestPyMOLRun(PyMOLGlobals * G, int group, int test)
 {
+  int ok = true;
   switch (group) {
   case 0:                      /* development tests */
     switch (test) {
@@ -333,6 +654,21 @@ int TestPyMOLRun(PyMOLGlobals * G, int group, int test)
       break;
     }
     break;
+  case 2:                      /* micro-benchmarks */
+    switch (test) {
+    case 0:
+      ok = TestPyMOL_02_00(G, 1000000, false) && ok;
+      ok = TestPyMOL_02_00(G, 1000000, true) && ok;
+      break;
+    case 1:
+      ok = TestPyMOL_02_01(G, 1000000, 1) && ok;
+      ok = TestPyMOL_02_01(G, 1000000, std::max(2, SettingGetGlobal_i(G, cSetting_max_threads))) && ok;
+      break;
+    case 2:
+      ok = TestPyMOL_02_02(G, 10);
+      break;
+    }
+    break;
   case 1:
     /* set up for test usage as a simple viewer */
 
@@ -458,5 +794,5 @@ int TestPyMOLRun(PyMOLGlobals * G, int group, int test)
       break;
     }
   }
-  return 1;
+  return ok;
 }
@@ -33,7 +33,10 @@
 #include "os_python.h"
 #include "os_std.h"
 
+#include <vector>
+
 #include "ce_types.h"
+#include "Parallel.h"
 
 #include "tnt/tnt.h"
 #include "tnt/jama_lu.h"
@@ -50,33 +53,30 @@ TA2<double> transpose(const TA2<double>& v);
 /////////////////////////////////////////////////////////////////////////////
 // CE Specific
 /////////////////////////////////////////////////////////////////////////////
-double** calcDM(pcePoint coords, int len)
+double* calcDM(pcePoint coords, int len, int nThread)
 {
-  int i = 0;
-
-  double** dm = (double**) malloc(sizeof(double*)*len);
-  for (i = 0; i < len; i++)
-    dm[i] = (double*) malloc( sizeof(double)*len);
-
-  int row=0, col=0;
-  for (row = 0; row < len; row++) {
-    for (col = 0; col < len; col++) {
-      dm[row][col] = sqrt(pow(coords[row].x - coords[col].x,2) +
-			  pow(coords[row].y - coords[col].y,2) +
-			  pow(coords[row].z - coords[col].z,2) );
+  double* dm = (double*) malloc(sizeof(double)*len*len);
+
+  pymol::parallel_for_chunks(pymol::parallel_chunk_count(nThread, len, 64), len,
+                             [&](int, size_t begin, size_t end) {
+    for (size_t row = begin; row < end; row++) {
+      double* dmRow = dm + row*len;
+      for (int col = 0; col < len; col++) {
+	double dx = coords[row].x - coords[col].x;
+	double dy = coords[row].y - coords[col].y;
+	double dz = coords[row].z - coords[col].z;
+	dmRow[col] = sqrt(dx*dx + dy*dy + dz*dz);
+      }
     }
-  }
+  });
   return dm;
 }
 
-double** calcS(double** d1, double** d2, int lenA, int lenB, int wSize)
+double* calcS(const double* d1, const double* d2, int lenA, int lenB, int wSize, int nThread)
 {
-  int i;
   double winSize = (double) wSize;
   // initialize the 2D similarity matrix
-  double** S = (double**) malloc(sizeof(double*)*lenA);
-  for (i = 0; i < lenA; i++)
-    S[i] = (double*) malloc( sizeof(double)*lenB);
+  double* S = (double*) malloc(sizeof(double)*lenA*lenB);
   
   double sumSize = (winSize-1.0)*(winSize-2.0) / 2.0;
   //
@@ -85,10 +85,14 @@ double** calcS(double** d1, double** d2, int lenA, int lenB, int wSize)
   // i - i+winSize in protein A, match to residues j - j+winSize in protein
   // B.  A value of 0 means absolute match; a value >> 1 means bad match.
   //
+  // rows are independent, the loops keep their serial layout
+  pymol::parallel_for_chunks(pymol::parallel_chunk_count(nThread, lenA, 16), lenA,
+                             [&](int, size_t begin, size_t end) {
   int iA, iB, row, col;
-  for (iA = 0; iA < lenA; iA++) {
+  for (iA = begin; iA < (int) end; iA++) {
+    double* SRow = S + (size_t) iA*lenB;
     for (iB = 0; iB < lenB; iB++) {
-      S[iA][iB] = -1.0;
+      SRow[iB] = -1.0;
       if (iA > lenA - wSize || iB > lenB - wSize)
 	continue;
 		
@@ -102,14 +106,17 @@ double** calcS(double** d1, double** d2, int lenA, int lenB, int wSize)
       // this tell us nothing, so it doesn't help so ignore it.
       //
       for (row = 0; row <  wSize - 2; row++) {
+	const double* rowA = d1 + (size_t) (iA+row)*lenA + iA;
+	const double* rowB = d2 + (size_t) (iB+row)*lenB + iB;
 	for (col = row + 2; col <  wSize; col++) {
-	  score += fabs( d1[iA+row][iA+col] - d2[iB+row][iB+col] );
+	  score += fabs( rowA[col] - rowB[col] );
 	}
       }
 
-      S[iA][iB] = score / sumSize;
+      SRow[iB] = score / sumSize;
     }
   }
+  });
   return S;
 }
 
@@ -153,7 +160,149 @@ pcePoint getCoords(PyObject* L, int length)
 
 
 
-pathCache findPath( double** S, double** dA, double** dB, int lenA, int lenB, float D0, float D1, int winSize, int gapMax, int * bufferSize )
+//
+// The search in findPath is split into two parts: growing the path
+// from a single seed (iA, iB), which only depends on the seed, and
+// comparing the grown paths against the best ones seen so far, which
+// depends on the seed order. The first part is evaluated for batches of
+// seeds in parallel, the second part visits the seeds in order, so the
+// results are identical to a serial search.
+//
+struct ceSeed {
+  int iA, iB;
+  // the grown path
+  std::vector<afp> path;
+  // scores[k] is the total score of path[0 .. k+1]
+  std::vector<double> scores;
+};
+
+static void extendSeed( const double* S, const double* dA, const double* dB, int lenA, int lenB, float D0, float D1, int winSize, int gapMax, const int* winCache, int winSum, afp* curPath, double* allScoreBuffer, int* tIndex, ceSeed& seed )
+{
+  const int nGap = gapMax*2+1;
+  const int iA = seed.iA, iB = seed.iB;
+
+  curPath[0].first = iA;
+  curPath[0].second = iB;
+  int curPathLength = 1;
+  tIndex[curPathLength-1] = 0;
+  double curTotalScore = 0.0;
+
+  //
+  // Check all possible paths starting from iA, iB
+  //
+  for (;;) {
+    double gapBestScore = 1e6;
+    int gapBestIndex = -1;
+    int g;
+
+    //
+    // Check all possible gaps [1..gapMax] from here
+    //
+    for ( g = 0; g < nGap; g++ ) {
+      int jA = curPath[curPathLength-1].first + winSize;
+      int jB = curPath[curPathLength-1].second + winSize;
+
+      if ( (g+1) % 2 == 0 ) {
+	jA += (g+1)/2;
+      }
+      else { // ( g odd )
+	jB += (g+1)/2;
+      }
+
+      //
+      // Following are three heuristics to ensure high quality
+      // long paths and make sure we don't run over the end of
+      // the S, matrix.
+					
+      // 1st: If jA and jB are at the end of the matrix
+      if ( jA > lenA-winSize || jB > lenB-winSize ){
+	// FIXME, was: jA > lenA-winSize-1 || jB > lenB-winSize-1
+	continue;
+      }
+      // 2nd: If this gapped octapeptide is bad, ignore it.
+      if ( S[jA*lenB + jB] > D0 )
+	continue;
+      // 3rd: if too close to end, ignore it.
+      if ( S[jA*lenB + jB] == -1.0 )
+	continue;
+					
+      double curScore = 0.0;
+      int s;
+      for ( s = 0; s < curPathLength; s++ ) {
+	const double* rowA = dA + (size_t) curPath[s].first*lenA + jA;
+	const double* rowB = dB + (size_t) curPath[s].second*lenB + jB;
+	curScore += fabs( rowA[0] - rowB[0] );
+	curScore += fabs( rowA[(winSize-1)*(lenA+1)] - rowB[(winSize-1)*(lenB+1)] );
+	int k;
+	for ( k = 1; k < winSize-1; k++ )
+	  curScore += fabs( rowA[k*lenA + (winSize-1) - k] -
+			    rowB[k*lenB + (winSize-1) - k] );
+      }
+					
+      curScore /= (double) winSize * (double) curPathLength;
+
+      if ( curScore >= D1 ) {
+	continue;
+      }
+
+      // store GAPPED best					
+      if ( curScore < gapBestScore ) {
+	curPath[curPathLength].first = jA;
+	curPath[curPathLength].second = jB;
+	gapBestScore = curScore;
+	gapBestIndex = g;
+	allScoreBuffer[(curPathLength-1)*nGap + g] = curScore;
+      }
+    } /// ROF -- END GAP SEARCHING
+				
+    //
+    // DONE GAPPING:
+    //
+
+    // if there was no good gapped path, we're done with this seed
+    if ( gapBestIndex == -1 )
+      break;
+
+    // calculate curTotalScore
+    int jGap, gA, gB;
+    double score1=0.0, score2=0.0;
+				
+    jGap = (gapBestIndex + 1 ) / 2;
+    if ((gapBestIndex + 1 ) % 2 == 0) {
+      gA = curPath[ curPathLength-1 ].first + winSize + jGap;
+      gB = curPath[ curPathLength-1 ].second + winSize;
+    }
+    else {
+      gA = curPath[ curPathLength-1 ].first + winSize;
+      gB = curPath[ curPathLength-1 ].second + winSize + jGap;
+    }
+
+    // perfect
+    score1 = (allScoreBuffer[(curPathLength-1)*nGap + gapBestIndex] * winSize * curPathLength
+	      + S[gA*lenB + gB]*winSum)/(winSize*curPathLength+winSum);
+
+    // perfect
+    score2 = ((curPathLength > 1 ? (allScoreBuffer[(curPathLength-2)*nGap + tIndex[curPathLength-1]])
+	       : S[iA*lenB + iB])
+	      * winCache[curPathLength-1] 
+	      + score1 * (winCache[curPathLength] - winCache[curPathLength-1]))
+      / winCache[curPathLength];
+
+    curTotalScore = score2;
+    // heuristic -- path is getting sloppy, stop looking
+    if ( curTotalScore > D1 )
+      break;
+
+    allScoreBuffer[(curPathLength-1)*nGap + gapBestIndex] = curTotalScore;
+    tIndex[curPathLength] = gapBestIndex;
+    curPathLength++;
+    seed.scores.push_back(curTotalScore);
+  }
+
+  seed.path.assign(curPath, curPath + seed.scores.size() + 1);
+}
+
+pathCache findPath( const double* S, const double* dA, const double* dB, int lenA, int lenB, float D0, float D1, int winSize, int gapMax, int * bufferSize, int nThread )
 {
   // CE-specific cutoffs
   const int MAX_KEPT = 20;
@@ -169,7 +318,7 @@ pathCache findPath( double** S, double** dA, double** dB, int lenA, int lenB, fl
   path bestPath = (path) malloc(sizeof(afp)*smaller);
 
   // index variable for below
-  int i, j;
+  int i;
   for ( i = 0; i < smaller; i++ ) {
     bestPath[i].first = -1;
     bestPath[i].second = -1;
@@ -192,22 +341,15 @@ pathCache findPath( double** S, double** dA, double** dB, int lenA, int lenB, fl
   // winCache
   // this array stores a list of residues seen.  We use it to calculate the
   // total score of a path from 1..M and then add it to M+1..N.
-  int* winCache = (int*) malloc(sizeof(int)*smaller);
+  std::vector<int> winCache(smaller);
   for ( i = 0; i < smaller; i++ )
     winCache[i] = (i+1)*i*winSize/2 + (i+1)*winSum;
 
-  // allScoreBuffer
-  // this 2D array keeps track of all partial gapped scores
-  double** allScoreBuffer = (double**) malloc(sizeof(double*)*smaller);
-  for ( i = 0; i < smaller; i++ ) {
-    allScoreBuffer[i] = (double*) malloc( (gapMax*2+1) * sizeof(double));
-    // initialize the ASB
-    for ( j = 0; j < gapMax*2+1; j++ )
-      allScoreBuffer[i][j] = 1e6;
-  }
-	
-  int* tIndex = (int*) malloc(sizeof(int)*smaller);
-  int gapBestIndex = -1;
+  // seeds which are grown together, at least one row of S at a time
+  const size_t batchSize = (nThread > 1) ? 64 * nThread : 1;
+  std::vector<ceSeed> seeds;
+  size_t next = 0;
+  int endA = 0;
 
   //======================================================================
   // Start the search through the CE matrix.
@@ -217,156 +359,63 @@ pathCache findPath( double** S, double** dA, double** dB, int lenA, int lenB, fl
     if ( iA > lenA - winSize*(bestPathLength-1) )
       break;
 
-    for ( iB = 0; iB < lenB; iB++ ) {
-      if ( S[iA][iB] >= D0 )
-	continue;
-			
-      if ( S[iA][iB] == -1.0 )
-	continue;
-			
-      if ( iB > lenB - winSize*(bestPathLength-1) )
-	break;
-
+    if ( iA == endA ) {
       //
-      // Restart curPath here.
+      // Collect the seeds of the next rows and grow their paths.
+      // bestPathLength only grows, so the current cutoffs include every
+      // seed the search below will visit.
       //
-      path curPath = (path) malloc( sizeof(afp)*smaller );
+      int maxA = lenA - winSize*(bestPathLength-1);
+      int maxB = lenB - winSize*(bestPathLength-1);
+      seeds.clear();
+      next = 0;
+
+      for ( ; endA < lenA && endA <= maxA && (endA == iA || seeds.size() < batchSize); endA++ ) {
+	const double* SRow = S + (size_t) endA*lenB;
+	for ( iB = 0; iB < lenB; iB++ ) {
+	  if ( SRow[iB] >= D0 )
+	    continue;
+	  if ( SRow[iB] == -1.0 )
+	    continue;
+	  if ( iB > maxB )
+	    break;
 
-      int i;
-      for ( i = 0; i < smaller; i++ ) {
-	curPath[i].first = -1;
-	curPath[i].second = -1;
+	  seeds.emplace_back();
+	  seeds.back().iA = endA;
+	  seeds.back().iB = iB;
+	}
       }
-      curPath[0].first = iA;
-      curPath[0].second = iB;
-      int curPathLength = 1;
-      tIndex[curPathLength-1] = 0;
-      double curTotalScore = 0.0;
-
-      //
-      // Check all possible paths starting from iA, iB
-      //
-      int done = 0;
-      while ( ! done ) {
-	double gapBestScore = 1e6;
-	gapBestIndex = -1;
-	int g;
-
-	//
-	// Check all possible gaps [1..gapMax] from here
-	//
-	for ( g = 0; g < (gapMax*2)+1; g++ ) {
-	  int jA = curPath[curPathLength-1].first + winSize;
-	  int jB = curPath[curPathLength-1].second + winSize;
-
-	  if ( (g+1) % 2 == 0 ) {
-	    jA += (g+1)/2;
-	  }
-	  else { // ( g odd )
-	    jB += (g+1)/2;
-	  }
 
-	  //
-	  // Following are three heuristics to ensure high quality
-	  // long paths and make sure we don't run over the end of
-	  // the S, matrix.
-					
-	  // 1st: If jA and jB are at the end of the matrix
-	  if ( jA > lenA-winSize || jB > lenB-winSize ){
-	    // FIXME, was: jA > lenA-winSize-1 || jB > lenB-winSize-1
-	    continue;
-	  }
-	  // 2nd: If this gapped octapeptide is bad, ignore it.
-	  if ( S[jA][jB] > D0 )
-	    continue;
-	  // 3rd: if too close to end, ignore it.
-	  if ( S[jA][jB] == -1.0 )
-	    continue;
-					
-	  double curScore = 0.0;
-	  int s;
-	  for ( s = 0; s < curPathLength; s++ ) {
-	    curScore += fabs( dA[curPath[s].first][jA] - dB[curPath[s].second][jB] );
-	    curScore += fabs( dA[curPath[s].first  + (winSize-1)][jA+(winSize-1)] - 
-			      dB[curPath[s].second + (winSize-1)][jB+(winSize-1)] );
-	    int k;
-	    for ( k = 1; k < winSize-1; k++ )
-	      curScore += fabs( dA[curPath[s].first  + k][ jA + (winSize-1) - k ] - 
-				dB[curPath[s].second + k][ jB + (winSize-1) - k ] );
-	  }
-					
-	  curScore /= (double) winSize * (double) curPathLength;
+      pymol::parallel_for_chunks(pymol::parallel_chunk_count(nThread, seeds.size(), 8), seeds.size(),
+				 [&](int, size_t begin, size_t end) {
+	std::vector<afp> curPath(smaller);
+	std::vector<double> allScoreBuffer(smaller*(gapMax*2+1), 1e6);
+	std::vector<int> tIndex(smaller);
+
+	for ( size_t k = begin; k < end; k++ )
+	  extendSeed(S, dA, dB, lenA, lenB, D0, D1, winSize, gapMax,
+		     winCache.data(), winSum, curPath.data(),
+		     allScoreBuffer.data(), tIndex.data(), seeds[k]);
+      });
+    }
 
-	  if ( curScore >= D1 ) {
-	    continue;
-	  }
+    // skip what is left of the previous row
+    while ( next < seeds.size() && seeds[next].iA < iA )
+      next++;
 
-	  // store GAPPED best					
-	  if ( curScore < gapBestScore ) {
-	    curPath[curPathLength].first = jA;
-	    curPath[curPathLength].second = jB;
-	    gapBestScore = curScore;
-	    gapBestIndex = g;
-	    allScoreBuffer[curPathLength-1][g] = curScore;
-	  }
-	} /// ROF -- END GAP SEARCHING
-				
-	//
-	// DONE GAPPING:
-	//
-
-	// calculate curTotalScore
-	curTotalScore = 0.0;
-	int jGap, gA, gB;
-	double score1=0.0, score2=0.0;
-				
-	if ( gapBestIndex != -1 ) {
-	  jGap = (gapBestIndex + 1 ) / 2;
-	  if ((gapBestIndex + 1 ) % 2 == 0) {
-	    gA = curPath[ curPathLength-1 ].first + winSize + jGap;
-	    gB = curPath[ curPathLength-1 ].second + winSize;
-	  }
-	  else {
-	    gA = curPath[ curPathLength-1 ].first + winSize;
-	    gB = curPath[ curPathLength-1 ].second + winSize + jGap;
-	  }
+    for ( ; next < seeds.size() && seeds[next].iA == iA; next++ ) {
+      const ceSeed& seed = seeds[next];
+      iB = seed.iB;
 
-	  // perfect
-	  score1 = (allScoreBuffer[curPathLength-1][gapBestIndex] * winSize * curPathLength
-		    + S[gA][gB]*winSum)/(winSize*curPathLength+winSum);
-
-	  // perfect
-	  score2 = ((curPathLength > 1 ? (allScoreBuffer[curPathLength-2][tIndex[curPathLength-1]])
-		     : S[iA][iB])
-		    * winCache[curPathLength-1] 
-		    + score1 * (winCache[curPathLength] - winCache[curPathLength-1]))
-	    / winCache[curPathLength];
-
-	  curTotalScore = score2;
-	  // heuristic -- path is getting sloppy, stop looking
-	  if ( curTotalScore > D1 ) {
-	    done = 1;
-	    gapBestIndex=-1;
-	    break;
-	  }
-	  else {
-	    allScoreBuffer[curPathLength-1][gapBestIndex] = curTotalScore;
-	    tIndex[curPathLength] = gapBestIndex;
-	    curPathLength++;
-	  }
-	}
-	else {
-	  // if here, then there was no good gapped path
-	  // so quit and restart from iA, iB+1
-	  done = 1;
-	  curPathLength--;
-	  break;
-	}
+      if ( iB > lenB - winSize*(bestPathLength-1) )
+	break;
 
-	//
-	// test this gapped path against the best seen
-	// starting from iA, iB
-	// 
+      //
+      // test each gapped path grown from iA, iB against the best seen
+      //
+      for ( size_t k = 0; k < seed.scores.size(); k++ ) {
+	int curPathLength = k + 2;
+	double curTotalScore = seed.scores[k];
 
 	// if our currently best gapped path from iA and iB is LONGER
 	// than the current best; or, it's equal length and the score's
@@ -375,19 +424,17 @@ pathCache findPath( double** S, double** dA, double** dB, int lenA, int lenB, fl
 	     (curPathLength == bestPathLength && curTotalScore < bestPathScore )) {
 	  bestPathLength = curPathLength;
 	  bestPathScore = curTotalScore;
-	  // deep copy curPath
-	  path tempPath = (path) malloc( sizeof(afp)*smaller );
-
-	  int i;
+	  // copy curPath
 	  for ( i = 0; i < smaller; i++ ) {
-	    tempPath[i].first = curPath[i].first;
-	    tempPath[i].second = curPath[i].second;
+	    if ( i < curPathLength ) {
+	      bestPath[i] = seed.path[i];
+	    } else {
+	      bestPath[i].first = -1;
+	      bestPath[i].second = -1;
+	    }
 	  }
-
-	  free(bestPath);
-	  bestPath = tempPath;
 	}
-      } /// END WHILE
+      }
 
       //
       // At this point, we've found the best path starting at iA, iB.
@@ -402,7 +449,6 @@ pathCache findPath( double** S, double** dA, double** dB, int lenA, int lenB, fl
 	*bufferSize = ( *bufferSize < MAX_KEPT ) ? (*bufferSize)+1 : MAX_KEPT;
 	path pathCopy = (path) malloc( sizeof(afp)*smaller );
 
-	int i;
 	for ( i = 0; i < smaller; i++ ) {
 	  pathCopy[i].first = bestPath[i].first;
 	  pathCopy[i].second = bestPath[i].second;
@@ -423,16 +469,10 @@ pathCache findPath( double** S, double** dA, double** dB, int lenA, int lenB, fl
 	  lenBuffer[bufferIndex-1] = bestPathLength;
 	}
       }
-      free(curPath); curPath=0;
     } // ROF -- end for iB
   } // ROF -- end for iA
 
   // free memory
-  for ( i = 0; i < smaller; i++ )
-    free(allScoreBuffer[i]);
-  free(allScoreBuffer);
-  free(tIndex);
-  free(winCache);
   free(bestPath);
 
   return pathBuffer;
@@ -441,7 +481,17 @@ pathCache findPath( double** S, double** dA, double** dB, int lenA, int lenB, fl
 
 
 
-PyObject* findBest( pcePoint coordsA, pcePoint coordsB, pathCache paths, int bufferSize, int smaller, int winSize )
+//
+// Superposition of the coordinates aligned by one path (see findBest)
+//
+struct ceSuperposition {
+  double rmsd;
+  int len;
+  TA2<double> U;
+  TA1<double> COM1, COM2;
+};
+
+PyObject* findBest( pcePoint coordsA, pcePoint coordsB, pathCache paths, int bufferSize, int smaller, int winSize, int nThread )
 {
   // keep the best values
   double bestRMSD = 1e6;
@@ -449,9 +499,11 @@ PyObject* findBest( pcePoint coordsA, pcePoint coordsB, pathCache paths, int buf
   TA1<double> bestCOM1, bestCOM2;
   int bestLen = 0;
   int bestO = -1;
-	
-  // loop through the buffer
-  for ( int o = 0; o < bufferSize; o++ ) {
+
+  // superpose all paths in the buffer (independent of each other)
+  std::vector<ceSuperposition> superpositions(bufferSize);
+
+  pymol::parallel_for(nThread, bufferSize, [&](int o) {
 
     // grab the current path
     TA2<double> c1(smaller, 3, 0.0);
@@ -593,15 +645,27 @@ PyObject* findBest( pcePoint coordsA, pcePoint coordsB, pathCache paths, int buf
 		
     double curRMSD = sqrt(fabs((E0 - 2*sig) / (double) m ));
 
+    ceSuperposition& cur = superpositions[o];
+    cur.rmsd = curRMSD;
+    cur.len = curLen;
+    cur.U = U;
+    cur.COM1 = c1COM;
+    cur.COM2 = c2COM;
+  });
+	
+  // loop through the buffer
+  for ( int o = 0; o < bufferSize; o++ ) {
+    const ceSuperposition& cur = superpositions[o];
+
     //
     // Save the best
     //
-    if ( curRMSD < bestRMSD || ( curRMSD == bestRMSD && c1.dim1() > bestLen )) {
-      bestU = U.copy();
-      bestRMSD = curRMSD;
-      bestCOM1 = c1COM.copy();
-      bestCOM2 = c2COM.copy();
-      bestLen = curLen;
+    if ( cur.rmsd < bestRMSD || ( cur.rmsd == bestRMSD && smaller > bestLen )) {
+      bestU = cur.U;
+      bestRMSD = cur.rmsd;
+      bestCOM1 = cur.COM1;
+      bestCOM2 = cur.COM2;
+      bestLen = cur.len;
       bestO = o;
     }
   }
@@ -23,19 +23,23 @@ typedef struct {
 /////////////////////////////////////////////////////////////////////////////
 // Function Declarations
 /////////////////////////////////////////////////////////////////////////////
+//
+// Matrices are stored as contiguous row-major arrays, e.g. element
+// (row, col) of a lenA x lenB matrix is m[row * lenB + col].
+//
 // Calculates the CE Similarity Matrix
-double** calcS(double** d1, double** d2, int lenA, int lenB, int wSize);
+double* calcS(const double* d1, const double* d2, int lenA, int lenB, int wSize, int nThread);
 
 // calculates a simple distance matrix
-double** calcDM(pcePoint coords, int len);
+double* calcDM(pcePoint coords, int len, int nThread);
 
 // Converter: Python Object -> C Structs
 pcePoint getCoords( PyObject* L, int len );
 
 // Optimal path finding algorithm (CE).
-pathCache findPath(double** S, double** dA, double**dB, int lenA, int lenB, float D0, float D1, int winSize, int gapMax, int* bufferSize);
+pathCache findPath(const double* S, const double* dA, const double* dB, int lenA, int lenB, float D0, float D1, int winSize, int gapMax, int* bufferSize, int nThread);
 
 // filter through the results and find the best
-PyObject* findBest( pcePoint coordsA, pcePoint coordsB, pathCache paths, int bufferSize, int smaller, int winSize );
+PyObject* findBest( pcePoint coordsA, pcePoint coordsB, pathCache paths, int bufferSize, int smaller, int winSize, int nThread );
 
 #endif
@@ -5,11 +5,13 @@ from .importing import \
       finish_object,      \
       load,               \
       loadall,            \
+      load_batch,         \
       load_brick,         \
       load_callback,      \
       load_cgo,           \
       load_coords,        \
       load_coordset,      \
+      set_atom_property_array, \
       load_embedded,      \
       load_map,           \
       load_model,         \
@@ -113,13 +115,19 @@ from .querying import \
       get_object_settings,\
       get_object_state,   \
       get_color_tuple,    \
+      get_angle_series,   \
+      get_atom_areas,     \
       get_atom_coords,    \
+      get_atom_property_array, \
       get_coords,         \
       get_coordset,       \
       get_dihedral,       \
+      get_dihedral_series, \
       get_distance,       \
+      get_distance_series, \
       get_drag_object_name, \
       get_extent,         \
+      get_gyration_series, \
       get_idtf,           \
       get_modal_draw,     \
       get_model,          \
@@ -137,6 +145,8 @@ from .querying import \
       get_povray,         \
       get_raw_alignment,  \
       get_renderer,       \
+      get_rep_cache_stats, \
+      get_rmsf,           \
       get_selection_state,\
       get_symmetry,       \
       get_title,          \
@@ -148,6 +158,7 @@ from .querying import \
       id_atom,            \
       identify,           \
       index,              \
+      memory_report,      \
       overlap,            \
       phi_psi
 
@@ -175,7 +186,8 @@ from .exporting import \
       multifilenamegen,   \
       multisave,          \
       png,                \
-      save               
+      save,               \
+      save_traj
 
 #--------------------------------------------------------------------
 from . import editing
@@ -281,6 +293,7 @@ from .wizarding import \
 #--------------------------------------------------------------------
 from .fitting import \
       align,             \
+      align_matrix,      \
       alignto,		 \
       extra_fit,	 \
       fit,               \
@@ -76,6 +76,7 @@ def get_auto_arg_list(self_cmd=cmd):
 # 1st
         {
         'align'          : aa_sel_c,
+        'align_matrix'   : aa_sel_e,
         'alignto'        : aa_obj_c,
         'alter'          : aa_sel_e,
         'alphatoall'     : aa_sel_c,
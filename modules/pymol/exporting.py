@@ -619,18 +619,92 @@ ARGUMENTS
         if format not in ('pdb', 'cif'):
             raise pymol.CmdException(format + ' format not supported with multisave')
 
-        s = get_str(format, pattern, state, '', -1, 1, quiet, _self)
+        filename = _self.exp_path(filename)
+
+        with _self.lockcm:
+            r = _cmd.save_molecule(_self._COb, str(filename), str(format),
+                    str(pattern), int(state) - 1, '', -1, 1,
+                    int(append), int(quiet))
+
+        if _self._raising(r, _self): raise QuietException
+        return r
+
+    def save_traj(filename, selection='all', start=1, stop=-1, interval=1,
+                  format='', quiet=1, _self=cmd):
+        '''
+DESCRIPTION
+
+    "save_traj" writes the coordinates of a multi-state selection as a
+    binary trajectory file (e.g. DCD or TRR), one frame per state. Frames
+    are written as they are produced, so the whole trajectory never has
+    to be held in memory in file format.
+
+USAGE
+
+    save_traj filename [, selection [, start [, stop [, interval [, format ]]]]]
+
+ARGUMENTS
+
+    filename = string: file path to be written
+
+    selection = string: atoms to save {default: all}
+
+    start = int: first state {default: 1}
+
+    stop = int: last state {default: -1 (last state)}
+
+    interval = int: write every Nth state {default: 1}
+
+    format = string: file format, any trajectory format with a molfile
+    writer (dcd, trr, binpos, crd, namdbin, ...) {default: guess from
+    extension}
 
-        if s is None:
-            if _self._raising(): raise QuietException
-            return DEFAULT_ERROR
+NOTES
+
+    The atom order is the order of the selection, matching "save" of the
+    same selection to a topology file (e.g. PDB). States in which not all
+    selected atoms have coordinates are skipped. Single-state objects are
+    written to every frame if "static_singletons" is on.
+
+SEE ALSO
+
+    save, load_traj
+        '''
+        from pymol.importing import filename_to_format
+        _, _, format_guessed, zipped = filename_to_format(filename)
+
+        if zipped:
+            raise pymol.CmdException(zipped + ' not supported with save_traj')
+
+        if not format:
+            format = format_guessed
+
+        with _self.lockcm:
+            plugin = _cmd.find_molfile_plugin(_self._COb, str(format), 0x10)
+
+        if not plugin:
+            raise pymol.CmdException('no trajectory writer for format "%s"' % format)
 
         filename = _self.exp_path(filename)
+        selection = selector.process(selection)
 
-        with open(filename, 'a' if int(append) else 'w') as handle:
-            handle.write(s)
+        with _self.lockcm:
+            r = _cmd.save_traj(_self._COb, str(filename), str(selection),
+                    int(start) - 1, int(stop) - 1 if int(stop) > 0 else -1,
+                    int(interval), str(plugin), int(quiet))
 
-        return DEFAULT_SUCCESS
+        if _self._raising(r, _self): raise QuietException
+        return r
+
+    def _save_traj_state(filename, selection, state, format, quiet, _self):
+        # save: state=0 writes all states, otherwise a single frame
+        state = int(state)
+        if state == -1:
+            state = _self.get_selection_state(selection)
+        if state > 0:
+            return save_traj(filename, selection, state, state, 1, format,
+                    quiet, _self)
+        return save_traj(filename, selection, 1, -1, 1, format, quiet, _self)
 
     def assign_atom_types( selection, format = "mol2", state=1, quiet=1, _self=cmd):
         r = DEFAULT_ERROR
@@ -788,7 +862,7 @@ NOTES
     The file format is automatically chosen if the extesion is one of
     the supported output formats: pdb, pqr, mol, sdf, pkl, pkla, mmd, out,
     dat, mmod, cif, pov, png, pse, psw, aln, fasta, obj, mtl, wrl, dae, idtf,
-    or mol2.
+    mol2, dcd, or trr.
 
     If the file format is not recognized, then a PDB file is written
     by default.
@@ -837,7 +911,14 @@ SEE ALSO
 
         contents = None
 
-        if format in savefunctions:
+        if not zipped and savefunctions.get(format) is get_str:
+            # molecular file formats: stream from the exporter directly to
+            # the file, without holding its contents in memory
+            with _self.lockcm:
+                r = _cmd.save_molecule(_self._COb, str(filename), str(format),
+                        str(selection), int(state) - 1, str(ref),
+                        int(ref_state), -1, 0, quiet)
+        elif format in savefunctions:
             # generic forwarding to format specific save functions
             func = savefunctions[format]
             func = _eval_func(func)
@@ -967,6 +1048,10 @@ SEE ALSO
         'mol': get_str,
         'mmtf': get_bytes,
 
+        # binary trajectories
+        'dcd': _save_traj_state,
+        'trr': _save_traj_state,
+
         'pse': get_psestr,
         'psw': get_psestr,
 
@@ -389,6 +389,79 @@ SEE ALSO
                 if _self._raising(r,_self): raise pymol.CmdException             
                 return r
 
+        def align_matrix(selection='(all)', cutoff=2.0, cycles=5, gap=-10.0,
+                         extend=-0.5, max_gap=50, matrix="BLOSUM62", state=0,
+                         quiet=1, max_skip=0, _self=cmd):
+                '''
+DESCRIPTION
+
+        "align_matrix" aligns every object in the selection against every
+        other object (like "align" with transform=0) and returns the
+        pairwise results as matrices. No coordinates are modified.
+
+USAGE
+
+        align_matrix [ selection [, cutoff [, cycles [, gap [, extend
+                [, max_gap [, matrix [, state [, quiet ]]]]]]]]]
+
+ARGUMENTS
+
+        selection = string: atom selection of multiple objects, or list
+        of selections which each derive from one object {default: all}
+
+        cutoff, cycles, gap, extend, max_gap, matrix: see "align"
+
+        state = int: object state {default: 0 = all states}
+
+NOTES
+
+        Returns (names, rms, n_atom, score), where rms[i][j] is the
+        RMSD of names[i] (mobile) aligned onto names[j] (target) after
+        outlier rejection, or -1.0 if the pair could not be aligned.
+        With a list of selections, names are the selections. As with
+        "align", two selections from the same object give -1.0.
+
+        The substitution matrix and the residue lists of each object are
+        only read once, and the pairs are aligned on up to "max_threads"
+        threads.
+
+PYMOL API
+
+        cmd.align_matrix(string selection, ...)
+
+SEE ALSO
+
+        align, extra_fit
+                '''
+                r = DEFAULT_ERROR
+                if _self.is_string(selection):
+                        selection = selector.process(selection)
+                        names = _self.get_object_list("(" + selection + ")") or []
+                        seles = ["?%s & (%s)" % (name, selection) for name in names]
+                else:
+                        names = seles = [selector.process(s) for s in selection]
+                matrix = str(matrix)
+                if matrix.lower() in ['none', '']:
+                        mfile = ''
+                elif os.path.exists(matrix):
+                        mfile = matrix
+                else:
+                        mfile = cmd.exp_path("$PYMOL_DATA/pymol/matrices/"+matrix)
+                try:
+                        _self.lock(_self)
+                        r = _cmd.align_matrix(_self._COb, seles,
+                                              float(cutoff),int(cycles),float(gap),
+                                              float(extend),int(max_gap),str(mfile),
+                                              int(state)-1,int(quiet),int(max_skip),
+                                              -1.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0, 0.0)
+                finally:
+                        _self.unlock(r,_self)
+                if _self._raising(r,_self): raise pymol.CmdException
+                n = len(names)
+                rms, n_atom, score = [[m[i * n:(i + 1) * n] for i in range(n)]
+                                      for m in r]
+                return (names, rms, n_atom, score)
+
         def intra_fit(selection, state=1, quiet=1, mix=0, _self=cmd):
                 '''
 DESCRIPTION
@@ -411,6 +484,11 @@ PYMOL API
 
         cmd.intra_fit( string selection, int state )
 
+NOTES
+
+        States are fitted on up to "max_threads" threads, unless mix
+        is set.
+
 EXAMPLES
 
         intra_fit ( name CA )
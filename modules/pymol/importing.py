@@ -809,6 +809,85 @@ SEE ALSO
         if _self._raising(r,_self): raise pymol.CmdException
         return r
 
+    # formats which load_batch can parse in parallel
+    _batch_formats = ('pdb', 'pqr', 'pdbqt', 'cif', 'mol', 'mol2', 'sdf',
+                      'xyz', 'mmod')
+
+    def load_batch(files, state=0, discrete=-1, quiet=1, multiplex=None,
+                   zoom=-1, _self=cmd):
+        '''
+DESCRIPTION
+
+    "load_batch" loads many molecular files at once. The files are read
+    and parsed in parallel (see "max_threads"), and the new objects are
+    then created in one pass. Object names are taken from the file names.
+
+USAGE
+
+    load_batch files [, state [, discrete [, quiet [, multiplex [, zoom ]]]]]
+
+ARGUMENTS
+
+    files = str or list: file names, or a pattern like "poses/*.sdf"
+
+EXAMPLE
+
+    load_batch docking/*.sdf
+
+NOTES
+
+    PDB, PQR, PDBQT, mmCIF, MOL, MOL2, SDF, XYZ and MacroModel files are
+    parsed in parallel. Other formats, compressed files and files which
+    append to an existing object are loaded with "load". Files are always
+    processed in the given order.
+
+SEE ALSO
+
+    load
+        '''
+        import glob
+
+        if is_string(files):
+            pattern = _self.exp_path(unquote(files))
+            files = sorted(glob.glob(pattern))
+            if not files:
+                raise pymol.CmdException('no files match "%s"' % pattern)
+
+        if multiplex is None:
+            multiplex = -2
+
+        state, discrete, quiet = int(state), int(discrete), int(quiet)
+        multiplex, zoom = int(multiplex), int(zoom)
+        batch = ([], [], [])
+
+        def flush():
+            if not batch[0]:
+                return
+            r = DEFAULT_ERROR
+            with _self.lockcm:
+                r = _cmd.load_batch(_self._COb, batch[0], batch[1], batch[2],
+                                    state - 1, zoom, discrete, multiplex, quiet)
+            for b in batch:
+                del b[:]
+            if _self._raising(r, _self):
+                raise pymol.CmdException
+
+        for filename in files:
+            filename = _self.exp_path(str(filename))
+            noext, ext, format, zipped = filename_to_format(filename)
+
+            if format in _batch_formats and not zipped:
+                batch[0].append(filename)
+                batch[1].append(noext)
+                batch[2].append(getattr(_loadable, format))
+            else:
+                flush()
+                _self.load(filename, state=state, discrete=discrete,
+                           quiet=quiet, multiplex=multiplex, zoom=zoom)
+
+        flush()
+        return DEFAULT_SUCCESS
+
     def load_pse(filename, partial=0, quiet=1, format='pse', _self=cmd):
         try:
             contents = _self.file_read(filename)
@@ -1450,6 +1529,38 @@ ARGUMENTS
             r = _cmd.load_coords(_self._COb, selection, coords, int(state)-1)
         return r
 
+    def set_atom_property_array(name, values, selection='all', _self=cmd):
+        '''
+DESCRIPTION
+
+    API only. Set an atom property for all atoms in the selection from a
+    sequence (preferably a numpy array) with one value per atom, in the
+    same order as with "iterate". Equivalent to, but much faster than
+
+    PyMOL> values = iter(values)
+    PyMOL> cmd.alter(selection, name + ' = next(values)')
+
+    Representations of the modified objects are invalidated.
+
+ARGUMENTS
+
+    name = str: atom property, see get_atom_property_array
+
+    values = list: one value per atom, for string properties also a
+    (codes, categories) tuple
+
+    selection = str: atom selection {default: all}
+
+SEE ALSO
+
+    get_atom_property_array, load_coords, alter
+        '''
+        selection = selector.process(selection)
+        with _self.lockcm:
+            r = _cmd.set_atom_property(_self._COb, selection, str(name), values)
+        if _self._raising(r, _self): raise pymol.CmdException
+        return r
+
     def load_idx(filename, object, state=0, quiet=1, zoom=-1, _self=cmd):
         '''
 DESCRIPTION
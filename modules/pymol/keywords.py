@@ -15,6 +15,7 @@ def get_command_keywords(self_cmd=cmd):
         'accept'        : [ self_cmd.accept            , 0 , 0 , ''  , parsing.STRICT ],
         'alias'         : [ self_cmd.alias             , 0 , 0 , ''  , parsing.LITERAL1 ], # insecure
         'align'         : [ self_cmd.align             , 0 , 0 , ''  , parsing.STRICT ],
+        'align_matrix'  : [ self_cmd.align_matrix      , 0 , 0 , ''  , parsing.STRICT ],
         'alignto'       : [ self_cmd.alignto           , 0 , 0 , ''  , parsing.STRICT ],
         'alter'         : [ self_cmd.alter             , 0 , 0 , ''  , parsing.LITERAL1 ], # insecure
         '_alt'          : [ self_cmd._alt              , 0 , 0 , ''  , parsing.STRICT ],                
@@ -140,6 +141,7 @@ def get_command_keywords(self_cmd=cmd):
         'label'         : [ self_cmd.label             , 0 , 0 , ''  , parsing.LITERAL1 ], # insecure
         'load'          : [ self_cmd.load              , 0 , 0 , ''  , parsing.STRICT ],
         'loadall'       : [ self_cmd.loadall           , 0 , 0 , ''  , parsing.STRICT ],
+        'load_batch'    : [ self_cmd.load_batch        , 0 , 0 , ''  , parsing.STRICT ],
         'space'         : [ self_cmd.space             , 0 , 0 , ''  , parsing.STRICT ],
         'load_embedded' : [ self_cmd.load_embedded     , 0 , 0 , ''  , parsing.STRICT ],
         'load_mtz'      : [ self_cmd.load_mtz          , 0 , 0 , ''  , parsing.STRICT ],
@@ -163,6 +165,7 @@ def get_command_keywords(self_cmd=cmd):
         'mcopy'         : [ self_cmd.mcopy             , 0 , 0 , ''  , parsing.STRICT ],                
         'mdelete'       : [ self_cmd.mdelete           , 0 , 0 , ''  , parsing.STRICT ],
         'mem'           : [ self_cmd.mem               , 0 , 0 , ''  , parsing.STRICT ],
+        'memory_report' : [ self_cmd.memory_report     , 0 , 0 , ''  , parsing.STRICT ],
         'meter_reset'   : [ self_cmd.meter_reset       , 0 , 0 , ''  , parsing.STRICT ],
         'minsert'       : [ self_cmd.minsert           , 0 , 0 , ''  , parsing.STRICT ],
         'mmove'         : [ self_cmd.mmove             , 0 , 0 , ''  , parsing.STRICT ],        
@@ -223,6 +226,7 @@ def get_command_keywords(self_cmd=cmd):
         'rms'           : [ self_cmd.rms               , 0 , 0 , ''  , parsing.STRICT ],
         'rms_cur'       : [ self_cmd.rms_cur           , 0 , 0 , ''  , parsing.STRICT ],
         'save'          : [ self_cmd.save              , 0 , 0 , ''  , parsing.SECURE ],
+        'save_traj'     : [ self_cmd.save_traj         , 0 , 0 , ''  , parsing.SECURE ],
         'scene'         : [ self_cmd.scene             , 0 , 0 , ''  , parsing.STRICT ],
         'scene_order'   : [ self_cmd.scene_order       , 0 , 0 , ''  , parsing.STRICT ],
         'sculpt_purge'  : [ self_cmd.sculpt_purge      , 0 , 0 , ''  , parsing.STRICT ],   
@@ -926,6 +926,92 @@ DESCRIPTION
 
         return r
 
+    def get_rep_cache_stats(reset=0, quiet=1, _self=cmd):
+        '''
+DESCRIPTION
+
+    API only. Get statistics of the representation cache as a dictionary
+    with keys "bytes", "peak", "budget" (in bytes), "entries" (number of
+    states holding representations), "hits", "builds", "evictions" and
+    "prefetched" (states built ahead of display during movie playback).
+
+ARGUMENTS
+
+    reset = 0/1: reset the counters and the peak after reading them
+    {default: 0}
+
+NOTES
+
+    The budget is set with "rep_cache_max" (in MB, 0 = unlimited). When
+    the estimated size of all representations exceeds it, the least
+    recently displayed states are purged and get rebuilt on demand.
+
+    With "movie_prefetch" set to N > 0, the next N states are built on
+    background threads during movie playback.
+        '''
+        with _self.lockcm:
+            r = _cmd.get_rep_cache_stats(_self._COb, int(reset))
+        if r is None:
+            raise pymol.CmdException
+
+        if not int(quiet):
+            print(" RepCache: %.1f MB in %d states (peak %.1f MB, budget %s)" % (
+                r['bytes'] / 1048576., r['entries'], r['peak'] / 1048576.,
+                ('%d MB' % (r['budget'] >> 20)) if r['budget'] else 'unlimited'))
+            print(" RepCache: %d hits, %d builds, %d evictions, %d prefetched" % (
+                r['hits'], r['builds'], r['evictions'], r['prefetched']))
+
+        return r
+
+    def memory_report(quiet=0, _self=cmd):
+        '''
+DESCRIPTION
+
+    "memory_report" prints how much memory is held by the different
+    subsystems (atoms, coordinates, CGOs, map fields, selections), by each
+    object, by representations and by the movie image cache.
+
+USAGE
+
+    memory_report
+
+PYMOL API
+
+    cmd.memory_report(quiet=0)
+
+    Returns a dictionary with keys "tags" ({subsystem: (bytes, count)},
+    process wide), "objects" ({name: {"atoms", "coords", "reps", "cgo",
+    "fields"}} in bytes), "movie" and "rep_cache" (in bytes).
+
+NOTES
+
+    Subsystem totals are live counters of tagged allocations and are
+    always on. Buffers which are not tagged are counted as "other".
+        '''
+        with _self.lockcm:
+            r = _cmd.get_memory_report(_self._COb)
+        if r is None:
+            raise pymol.CmdException
+
+        if not int(quiet):
+            MB = 1048576.
+            print(" Memory by subsystem:")
+            for name, (size, count) in sorted(r['tags'].items(),
+                    key=lambda item: -item[1][0]):
+                print("  %-10s %10.1f MB in %d blocks" % (name, size / MB, count))
+            if r['objects']:
+                print(" Memory by object (MB):")
+                print("  %-20s %9s %9s %9s %9s %9s" % ('name', 'atoms',
+                    'coords', 'reps', 'cgo', 'fields'))
+                for name, o in r['objects'].items():
+                    print("  %-20s %9.1f %9.1f %9.1f %9.1f %9.1f" % (name,
+                        o['atoms'] / MB, o['coords'] / MB, o['reps'] / MB,
+                        o['cgo'] / MB, o['fields'] / MB))
+            print(" Representations: %.1f MB, movie images: %.1f MB" % (
+                r['rep_cache'] / MB, r['movie'] / MB))
+
+        return r
+
     def get_phipsi(selection="(name CA)",state=-1,_self=cmd):
         # preprocess selections
         selection = selector.process(selection)
@@ -1000,6 +1086,44 @@ ARGUMENTS
             r = _cmd.get_coordset(_self._COb, name, int(state) - 1, int(copy))
             return r
 
+    def get_atom_property_array(name, selection='all', codes=0, _self=cmd):
+        '''
+DESCRIPTION
+
+    API only. Get an atom property for all atoms in the selection as a
+    numpy array, without a Python callback per atom. Values are in the
+    same order as with "iterate".
+
+ARGUMENTS
+
+    name = str: atom property, any numeric or string property from
+    "iterate" (b, q, vdw, partial_charge, formal_charge, resv, color,
+    reps, protons, ID, rank, flags, index, name, resn, chain, segi, elem,
+    ss, ...)
+
+    selection = str: atom selection {default: all}
+
+    codes = 0/1: for string properties, return a (codes, categories)
+    tuple, where codes is an int32 array of indices into the list of
+    distinct values {default: 0, object array of strings}
+
+EXAMPLE
+
+    b = cmd.get_atom_property_array('b', 'polymer')
+    cmd.set_atom_property_array('b', b / b.max(), 'polymer')
+
+SEE ALSO
+
+    set_atom_property_array, get_coords, iterate
+        '''
+        selection = selector.process(selection)
+        with _self.lockcm:
+            r = _cmd.get_atom_property(_self._COb, selection, str(name),
+                    int(codes))
+        if r is None:
+            raise pymol.CmdException('get_atom_property_array failed')
+        return r
+
     
     def get_position(quiet=1, _self=cmd):
         '''
@@ -1142,6 +1266,106 @@ PYMOL API
             print(" cmd.get_dihedral: %5.3f degrees."%r)
         return r
 
+    def _get_series(name, args, first, last, _self):
+        first, last = int(first), int(last)
+        with _self.lockcm:
+            r = getattr(_cmd, name)(_self._COb, args, first - 1,
+                    last - 1 if last > 0 else -1)
+        if r is None:
+            raise pymol.CmdException
+        return r
+
+    def get_distance_series(atom1="pk1", atom2="pk2", first=1, last=-1, _self=cmd):
+        '''
+DESCRIPTION
+
+    API only. Get the distance between two atoms in every state from
+    "first" to "last" as a numpy array, like calling "get_distance"
+    for each state.
+
+ARGUMENTS
+
+    atom1, atom2 = str: single atom selections
+
+    first = int: first state {default: 1}
+
+    last = int: last state or -1 for the last state {default: -1}
+
+NOTES
+
+    Selections are only evaluated once, and states are processed on up
+    to "max_threads" threads. Single-state objects are treated as
+    static. States in which an atom has no coordinates give NaN.
+
+SEE ALSO
+
+    get_distance, get_angle_series, get_dihedral_series
+        '''
+        atoms = [selector.process(a) for a in (atom1, atom2)]
+        return _get_series('get_geometry_series', atoms, first, last, _self)
+
+    def get_angle_series(atom1="pk1", atom2="pk2", atom3="pk3", first=1, last=-1, _self=cmd):
+        '''
+DESCRIPTION
+
+    API only. Get the angle (in degrees) between three atoms in every
+    state from "first" to "last" as a numpy array.
+
+SEE ALSO
+
+    get_angle, get_distance_series
+        '''
+        atoms = [selector.process(a) for a in (atom1, atom2, atom3)]
+        return _get_series('get_geometry_series', atoms, first, last, _self)
+
+    def get_dihedral_series(atom1="pk1", atom2="pk2", atom3="pk3", atom4="pk4",
+            first=1, last=-1, _self=cmd):
+        '''
+DESCRIPTION
+
+    API only. Get the dihedral angle (in degrees) between four atoms in
+    every state from "first" to "last" as a numpy array.
+
+SEE ALSO
+
+    get_dihedral, get_distance_series
+        '''
+        atoms = [selector.process(a) for a in (atom1, atom2, atom3, atom4)]
+        return _get_series('get_geometry_series', atoms, first, last, _self)
+
+    def get_gyration_series(selection="all", first=1, last=-1, _self=cmd):
+        '''
+DESCRIPTION
+
+    API only. Get the radius of gyration (not mass weighted) of a
+    selection in every state from "first" to "last" as a numpy array.
+
+SEE ALSO
+
+    get_distance_series, get_rmsf
+        '''
+        selection = selector.process(selection)
+        return _get_series('get_gyration_series', selection, first, last, _self)
+
+    def get_rmsf(selection="all", first=1, last=-1, _self=cmd):
+        '''
+DESCRIPTION
+
+    API only. Get the root mean square fluctuation of every atom in the
+    selection about its mean position over the states "first" to "last"
+    as a numpy array (in atom order, like "iterate").
+
+NOTES
+
+    No fitting is done, use "intra_fit" first.
+
+SEE ALSO
+
+    intra_fit, get_gyration_series
+        '''
+        selection = selector.process(selection)
+        return _get_series('get_rmsf', selection, first, last, _self)
+
     def get_model(selection="(all)",state=1,ref='',ref_state=0,_self=cmd):
         '''
 DESCRIPTION
@@ -1216,6 +1440,38 @@ SEE ALSO
             print(" cmd.get_area: %5.3f Angstroms^2."%r)
         return r
 
+    def get_atom_areas(selection="all", state=1, _self=cmd):
+        '''
+DESCRIPTION
+
+    API only. Get the surface area of every atom in the selection as a
+    numpy array (in atom order, like "iterate"). Uses the same settings
+    as "get_area" ("dot_solvent", "dot_density", "solvent_radius").
+
+ARGUMENTS
+
+    selection = str: atom selection {default: all}
+
+    state = int: state index, -1 for the current state, or 0 for all
+    states (returns an array with one row per state) {default: 1}
+
+NOTES
+
+    Each object is treated separately, atoms of other objects don't
+    occlude. Atoms without coordinates in a state give NaN. States are
+    processed on up to "max_threads" threads.
+
+SEE ALSO
+
+    get_area
+        '''
+        selection = selector.process(selection)
+        with _self.lockcm:
+            r = _cmd.get_atom_areas(_self._COb, selection, int(state) - 1)
+        if r is None:
+            raise pymol.CmdException
+        return r
+
     def get_chains(selection="(all)",state=0,quiet=1,_self=cmd):
         '''
 DESCRIPTION
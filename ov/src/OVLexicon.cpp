@@ -1,94 +1,57 @@
+#include <atomic>
+#include <mutex>
+#include <new>
 
 #include "OVLexicon.h"
 #include "OVOneToOne.h"
-#include "OVHeapArray.h"
 #include "OVreturns.h"
 
 
+/* The lexicon is split into shards (selected by the string hash), each
+ * with its own lock, hash index and entries, so that several threads can
+ * intern strings concurrently. Entries live in pages which are never moved
+ * (the first holds LEX_PAGE0 entries, each following page twice as many),
+ * and short strings are stored inline, so OVLexicon_FetchCString
+ * does not lock: the string of a referenced id stays put until its last
+ * reference is released.
+ *
+ * Identifiers are (local index << LEX_SHARD_BITS) | shard. Shards fill up
+ * evenly, so identifiers stay roughly dense (useful for id-indexed tables).
+ *
+ * NOTE: with OVHeap_TRACKING, the heap itself is not thread safe.
+ */
+
+#define LEX_SHARD_BITS 4
+#define LEX_N_SHARD (1 << LEX_SHARD_BITS)
+#define LEX_PAGE0_BITS 6
+#define LEX_PAGE0 (1 << LEX_PAGE0_BITS)
+#define LEX_MAX_PAGE 21         /* keeps identifiers below 2^31 */
+#define LEX_INLINE 24
+
 /* should only be accessed by special methods */
 
 typedef struct {
-  ov_word offset;
-  ov_word next;                 /* NOTE: 1-based, 0 is the sentinel */
-  ov_word ref_cnt;
+  std::atomic<ov_word> ref_cnt;
+  ov_word next;                 /* NOTE: 1-based local index, 0 is the sentinel */
   ov_uword hash;
-  ov_size size;
+  ov_char8 *str;                /* either buf or a heap copy */
+  ov_char8 buf[LEX_INLINE];
 } lex_entry;
 
+typedef struct {
+  std::mutex mutex;             /* guards up, next, free_index and entry setup */
+  OVOneToOne *up;               /* maps hash_key to local index of first entry */
+  std::atomic<lex_entry *> page[LEX_MAX_PAGE];
+  std::atomic<ov_word> n_entry; /* next unused local index (0 is never used) */
+  std::atomic<ov_word> n_active;
+  ov_word free_index;           /* NOTE: 1-based, 0 is the sentinel */
+} lex_shard;
+
 struct _OVLexicon {
   OVHeap *heap;
-  OVOneToOne *up;               /* maps hash_key to index of first zero-based entry */
-  lex_entry *entry;             /* maintained as a 1-based index */
-  ov_uword n_entry, n_active;
-  ov_char8 *data;
-  ov_uword data_size;
-  ov_uword data_unused;
-  ov_word free_index;           /* NOTE: 1-based, 0 is the sentinel */
+  lex_shard shard[LEX_N_SHARD];
 };
 
-ov_uword OVLexicon_GetNActive(OVLexicon * uk)
-{
-  return uk->n_active;
-}
-
-OVLexicon *OVLexicon_New(OVHeap * heap)
-{
-  OVLexicon *I = NULL;
-  if(heap) {
-    I = OVHeap_ALLOC(heap, OVLexicon);
-    if(I) {
-      I->heap = heap;
-      I->up = OVOneToOne_New(heap);
-      if(!(I->up)) {
-        OVLexicon_DEL_AUTO_NULL(I);
-      }
-    }
-  }
-  return I;
-}
-
-void OVLexicon_Del(OVLexicon * I)
-{
-  if(I) {
-    OVOneToOne_DEL_AUTO_NULL(I->up);
-    if(I->entry) {
-      I->entry++;               /* allow for 1-based indexing */
-      OVHeapArray_FREE_AUTO_NULL(I->entry);
-    }
-    OVHeapArray_FREE_AUTO_NULL(I->data);
-    OVHeap_Free(I->heap, I);
-  }
-}
-
-static OVstatus OVLexicon_CheckStorage(OVLexicon * uk, ov_word entry_size,
-                                       ov_size data_size)
-{
-  if(!uk->entry) {              /* auto zero to initialize ref_cnt fields */
-    uk->entry = OVHeapArray_CALLOC(uk->heap, lex_entry, entry_size);
-    if(!uk->entry) {
-      return_OVstatus_OUT_OF_MEMORY;
-    }
-    uk->entry--;                /* allow for 1-based indexing */
-
-  } else {
-    uk->entry++;                /* allow for 1-based indexing */
-    if(!OVHeapArray_CHECK(uk->entry, lex_entry, (ov_size) (entry_size - 1))) {
-      return_OVstatus_OUT_OF_MEMORY;
-    }
-    uk->entry--;                /* allow for 1-based indexing */
-  }
-
-  if(!uk->data) {
-    uk->data = OVHeapArray_MALLOC(uk->heap, ov_char8, data_size);
-    if(!uk->data) {
-      return_OVstatus_OUT_OF_MEMORY;
-    }
-  } else if(!OVHeapArray_CHECK(uk->data, ov_char8, data_size - 1)) {
-    return_OVstatus_OUT_OF_MEMORY;
-  }
-  return_OVstatus_SUCCESS;
-}
-
 /*============================================================================
  * _GetCStringHash -- returns a djb2 string hash key of the input
  * PARAMS
@@ -112,117 +75,224 @@ static ov_word _GetCStringHash(ov_uchar8 * str)
   return x;
 }
 
-OVstatus OVLexicon_Pack(OVLexicon * uk)
+static ov_uword ShardOf(ov_word hash)
 {
+  /* top bits of a multiplicative mix, independent of the low bits used
+   * by the per-shard hash index */
+  ov_uint32 h = (ov_uint32) hash * 0x9E3779B1U;
+  return h >> (32 - LEX_SHARD_BITS);
+}
 
-  if(uk->entry && uk->data && uk->n_entry && uk->data_unused) {
-    ov_size new_count = 0;
-    ov_size new_size = 0;
-
-    {                           /* compute storage requirements */
-      ov_size a;
-      ov_size n_entry = uk->n_entry;
-      lex_entry *cur_entry = uk->entry + 1;     /* NOTE: 1-based array */
-      for(a = 0; a < n_entry; a++) {
-        if(cur_entry->ref_cnt > 0) {
-          new_size += cur_entry->size;
-          new_count++;
-        }
-        cur_entry++;
+/* page number of a local index, and its offset in that page */
+static int PageOf(ov_word local, ov_uword * offset)
+{
+  ov_uword j = (ov_uword) local + LEX_PAGE0;
+  int msb;
+#ifdef __GNUC__
+  msb = (int) (sizeof(unsigned long long) * 8 - 1) - __builtin_clzll(j);
+#else
+  for(msb = LEX_PAGE0_BITS; (j >> msb) > 1; msb++);
+#endif
+  *offset = j - ((ov_uword) 1 << msb);
+  return msb - LEX_PAGE0_BITS;
+}
+
+static lex_entry *Entry(lex_shard * sh, ov_word local)
+{
+  ov_uword offset;
+  int page = PageOf(local, &offset);
+  return sh->page[page].load(std::memory_order_acquire) + offset;
+}
+
+/* returns the entry of a handed out identifier, or NULL */
+static lex_entry *Lookup(OVLexicon * uk, ov_word id)
+{
+  if(id > 0) {
+    lex_shard *sh = uk->shard + (id & (LEX_N_SHARD - 1));
+    ov_word local = id >> LEX_SHARD_BITS;
+    if(local < sh->n_entry.load(std::memory_order_acquire))
+      return Entry(sh, local);
+  }
+  return NULL;
+}
+
+static void ReleaseString(OVLexicon * uk, lex_entry * entry)
+{
+  if(entry->str && entry->str != entry->buf)
+    OVHeap_Free(uk->heap, entry->str);
+  entry->str = entry->buf;
+  entry->buf[0] = 0;
+}
+
+/* finds str in the hash chain (shard must be locked), 0 if not present */
+static ov_word FindLocked(lex_shard * sh, ov_word hash, const ov_char8 * str,
+                          ov_word * first)
+{
+  OVreturn_word search = OVOneToOne_GetForward(sh->up, hash);
+  ov_word index = 0;
+  if(OVreturn_IS_OK(search)) {
+    index = (*first = search.word);
+    while(index) {
+      lex_entry *entry_ptr = Entry(sh, index);
+      if(strcmp(entry_ptr->str, str) != 0) {    /* verify match */
+        index = entry_ptr->next;        /* not a match? keep looking */
+      } else {
+        break;
       }
     }
-    if((!new_count) && (!new_size)) {   /* if lexicon is completely empty, then purge both */
-      uk->entry++;              /* alloc for 1-based indexing */
-      OVHeapArray_FREE_AUTO_NULL(uk->entry);
-      OVHeapArray_FREE_AUTO_NULL(uk->data);
-      OVOneToOne_Reset(uk->up);
-      uk->n_entry = 0;
-      uk->n_active = 0;
-      uk->data_unused = 0;
-      uk->data_size = 0;
-      uk->free_index = 0;
-    } else {                    /* otherwise, pack the string fields, and track the free entries */
-      OVstatus status;
-      ov_char8 *old_data = uk->data;
-      uk->data = NULL;
-
-      if(OVreturn_IS_ERROR(status = OVLexicon_CheckStorage(uk, uk->n_entry, new_size))) {
-        uk->data = old_data;
-        return status;
-      }
+  }
+  return index;
+}
 
-      {                         /* copy data */
-        ov_word a;
-        ov_size n_entry = uk->n_entry, new_size = 0;
-        lex_entry *cur_entry = uk->entry + 1;  /* NOTE: 1-based array */
-        ov_char8 *data = old_data;
-        ov_char8 *new_data = uk->data;
-        ov_word free_index = 0;
-        ov_size entry_size;
-
-        for(a = 1; a <= (ov_word) n_entry; a++) {
-          if(cur_entry->ref_cnt > 0) {
-            entry_size = cur_entry->size;
-            memcpy(new_data, data + cur_entry->offset, entry_size);
-            cur_entry->offset = new_size;
-            new_size += entry_size;
-            new_data += entry_size;
-          } else {
-            /*  remember for later */
-            cur_entry->next = free_index;
-            cur_entry->ref_cnt = 0;
-            free_index = a;
-          }
-          cur_entry++;
-        }
+/* hands out a new local index (shard must be locked), 0 when out of memory */
+static ov_word NewEntryLocked(OVLexicon * uk, lex_shard * sh)
+{
+  ov_word index;
+  if(sh->free_index) {
+    index = sh->free_index;
+    sh->free_index = Entry(sh, index)->next;
+  } else {
+    ov_uword offset;
+    int page;
+    index = sh->n_entry.load(std::memory_order_relaxed);
+    page = PageOf(index, &offset);
+    if(page >= LEX_MAX_PAGE)
+      return 0;
+    if(!sh->page[page].load(std::memory_order_relaxed)) {
+      lex_entry *entry = OVHeap_CALLOC(uk->heap, lex_entry, (ov_size) LEX_PAGE0 << page);
+      if(!entry)
+        return 0;
+      sh->page[page].store(entry, std::memory_order_release);
+    }
+    sh->n_entry.store(index + 1, std::memory_order_release);
+  }
+  return index;
+}
 
-        OVHeapArray_FREE(old_data);
-        uk->data_unused = 0;
-        uk->data_size = new_size;
-        uk->free_index = free_index;
+ov_uword OVLexicon_GetNActive(OVLexicon * uk)
+{
+  ov_uword n_active = 0;
+  int a;
+  for(a = 0; a < LEX_N_SHARD; a++)
+    n_active += uk->shard[a].n_active.load(std::memory_order_relaxed);
+  return n_active;
+}
 
+OVLexicon *OVLexicon_New(OVHeap * heap)
+{
+  OVLexicon *I = NULL;
+  if(heap) {
+    I = new(std::nothrow) OVLexicon();
+    if(I) {
+      int a;
+      I->heap = heap;
+      for(a = 0; a < LEX_N_SHARD; a++) {
+        lex_shard *sh = I->shard + a;
+        sh->n_entry = 1;
+        sh->up = OVOneToOne_New(heap);
+        if(!sh->up) {
+          OVLexicon_DEL_AUTO_NULL(I);
+          break;
+        }
       }
     }
   }
+  return I;
+}
+
+static void PurgeShard(OVLexicon * I, lex_shard * sh)
+{
+  ov_word n_entry = sh->n_entry.load(std::memory_order_relaxed);
+  ov_word a;
+  for(a = 1; a < n_entry; a++)
+    ReleaseString(I, Entry(sh, a));
+  for(a = 0; a < LEX_MAX_PAGE; a++) {
+    lex_entry *page = sh->page[a].load(std::memory_order_relaxed);
+    if(!page)
+      break;
+    OVHeap_Free(I->heap, page);
+    sh->page[a].store(NULL, std::memory_order_relaxed);
+  }
+  sh->n_entry.store(1, std::memory_order_release);
+  sh->n_active = 0;
+  sh->free_index = 0;
+}
+
+void OVLexicon_Del(OVLexicon * I)
+{
+  if(I) {
+    int a;
+    for(a = 0; a < LEX_N_SHARD; a++) {
+      PurgeShard(I, I->shard + a);
+      OVOneToOne_DEL_AUTO_NULL(I->shard[a].up);
+    }
+    delete I;
+  }
+}
+
+OVstatus OVLexicon_Pack(OVLexicon * uk)
+{
+  /* strings are released as soon as they become unreferenced, and entries
+   * are recycled through the free lists, so only completely unused shards
+   * are worth purging */
+  int a;
+  for(a = 0; a < LEX_N_SHARD; a++) {
+    lex_shard *sh = uk->shard + a;
+    std::lock_guard<std::mutex> lock(sh->mutex);
+    if(!sh->n_active && sh->n_entry > 1) {
+      PurgeShard(uk, sh);
+      OVOneToOne_Reset(sh->up);
+    }
+  }
   return_OVstatus_SUCCESS;
 }
 
 OVstatus OVLexicon_DecRef(OVLexicon * uk, ov_word id)
 {
-  if((!uk->entry) || (id < 1) || (id > (ov_word) uk->n_entry)) {        /* range checking */
+  lex_entry *cur_entry = Lookup(uk, id);
+  if(!cur_entry) {              /* range checking */
     if(id)
       printf("OVLexicon_DecRef-Warning: key %zd not found, this might be a bug\n", id);
     return_OVstatus_NOT_FOUND;
   } else {
-    lex_entry *cur_entry = uk->entry + id;
-    ov_word ref_cnt = (--cur_entry->ref_cnt);
+    /* fast path: this can't be the last reference */
+    ov_word ref_cnt = cur_entry->ref_cnt.load(std::memory_order_relaxed);
+    while(ref_cnt > 1) {
+      if(cur_entry->ref_cnt.compare_exchange_weak(ref_cnt, ref_cnt - 1))
+        return_OVstatus_SUCCESS;
+    }
+  }
+  {
+    lex_shard *sh = uk->shard + (id & (LEX_N_SHARD - 1));
+    ov_word local = id >> LEX_SHARD_BITS;
+    std::lock_guard<std::mutex> lock(sh->mutex);
+    ov_word ref_cnt = --cur_entry->ref_cnt;
     if(ref_cnt < 0) {
       printf("OVLexicon_DecRef-Warning: key %zd with ref_cnt %zd, this might be a bug\n", id, ref_cnt);
       return_OVstatus_INVALID_REF_CNT;
     } else if(!ref_cnt) {
-      OVreturn_word result = OVOneToOne_GetForward(uk->up, cur_entry->hash);
+      OVreturn_word result = OVOneToOne_GetForward(sh->up, cur_entry->hash);
       if(OVreturn_IS_OK(result)) {
         ov_word index = result.word;
-        if(index != id) {
-          lex_entry *entry = uk->entry;
+        if(index != local) {
           ov_word next;
-          while(index && (next = entry[index].next) != id)
+          while(index && (next = Entry(sh, index)->next) != local)
             index = next;
           if(index)
-            entry[index].next = entry[id].next; /* excise from list */
+            Entry(sh, index)->next = cur_entry->next;   /* excise from list */
         } else {
           /* remove entry from OneToOne */
-          OVOneToOne_DelReverse(uk->up, id);
+          OVOneToOne_DelReverse(sh->up, local);
           /* if non-terminal, then add next entry to OneToOne */
           if(cur_entry->next) {
-            OVOneToOne_Set(uk->up, cur_entry->hash, cur_entry->next);   /* NOTE: no error checking performed! */
+            OVOneToOne_Set(sh->up, cur_entry->hash, cur_entry->next);   /* NOTE: no error checking performed! */
           }
         }
       }
-      uk->data_unused += cur_entry->size;
-      uk->n_active--;
-      if(uk->data_unused >= (uk->data_size >> 1))       /* if 50% unutilized, then pack */
-        OVLexicon_Pack(uk);
+      ReleaseString(uk, cur_entry);
+      cur_entry->next = sh->free_index;
+      sh->free_index = local;
+      sh->n_active--;
     }
     return_OVstatus_SUCCESS;
   }
@@ -230,16 +300,14 @@ OVstatus OVLexicon_DecRef(OVLexicon * uk, ov_word id)
 
 OVstatus OVLexicon_IncRef(OVLexicon * uk, ov_word id)
 {
-  if((!uk->entry) || (id < 1) || (id > (ov_word) uk->n_entry)) {        /* range checking */
+  lex_entry *entry = Lookup(uk, id);
+  if(!entry) {                  /* range checking */
     return_OVstatus_NOT_FOUND;
   } else {
-    lex_entry *entry = uk->entry + id;
     ov_word ref_cnt = (++entry->ref_cnt);
     if(ref_cnt < 2) {           /* was reference count zero or less? */
       /* safety precauations */
       entry->ref_cnt = 0;
-      entry->size = 0;
-      entry->offset = 0;
       return_OVstatus_INVALID_REF_CNT;
     } else {
       return_OVstatus_SUCCESS;
@@ -250,91 +318,66 @@ OVstatus OVLexicon_IncRef(OVLexicon * uk, ov_word id)
 OVreturn_word OVLexicon_GetFromCString(OVLexicon * uk, const ov_char8 * str)
 {
   ov_word hash = _GetCStringHash((ov_uchar8 *) str);
-  OVreturn_word search = OVOneToOne_GetForward(uk->up, hash);
-  ov_word index = 0;
+  ov_uword shard = ShardOf(hash);
+  lex_shard *sh = uk->shard + shard;
   ov_word cur_index = 0;
-  ov_char8 *c;
+  ov_word index;
+  lex_entry *entry_ptr;
+  std::lock_guard<std::mutex> lock(sh->mutex);
 
-  if(OVreturn_IS_OK(search)) {
-    /* the hash key has been registered, so follow the chain
-     * looking for a match... */
-    ov_char8 *data = uk->data;
-    lex_entry *entry = uk->entry, *entry_ptr;
-    cur_index = (index = search.word);
-    while(index) {              /* found */
-      c = data + (entry_ptr = (entry + index))->offset;
-      if(strcmp(c, str) != 0) { /* verify match */
-        index = entry_ptr->next;        /* not a match? keep looking */
-      } else {
-        break;
-      }
-    }
-  }
+  index = FindLocked(sh, hash, str, &cur_index);
   if(!index) {
     /* no match was found (or hash is new) so add this string to the lexicon */
     ov_size st_size = strlen(str) + 1;
-    lex_entry *entry, *entry_ptr, *cur_entry_ptr;
     OVstatus status;
-    {
-      ov_size new_size = uk->data_size + st_size;
-      ov_size new_n_entry = uk->n_entry;
-      if(!uk->free_index)
-        new_n_entry++;
-      /* allocate storage as necessary */
-      if(OVreturn_IS_ERROR(status = OVLexicon_CheckStorage(uk, new_n_entry, new_size))) {
-        OVreturn_word result;
-        result.status = status.status;
-        result.word = 0;
+
+    if(!(index = NewEntryLocked(uk, sh))) {
+      OVreturn_word result = { OVstatus_OUT_OF_MEMORY };
+      return result;
+    }
+    entry_ptr = Entry(sh, index);
+    entry_ptr->str = entry_ptr->buf;
+    if(st_size > LEX_INLINE) {
+      entry_ptr->str = OVHeap_MALLOC(uk->heap, ov_char8, st_size);
+      if(!entry_ptr->str) {
+        entry_ptr->str = entry_ptr->buf;
+        entry_ptr->next = sh->free_index;       /* record this as a free entry */
+        sh->free_index = index;
+        OVreturn_word result = { OVstatus_OUT_OF_MEMORY };
         return result;
       }
     }
-    /* WARNING: uk->entry, uk->data_size, and uk->data may have changed! */
-
-    if(!uk->free_index)
-      index = (++uk->n_entry);  /* NOTE: 1-based indices */
-    else {
-      index = uk->free_index;
-      uk->free_index = uk->entry[index].next;
-    }
-    uk->n_active++;
 
     if(!cur_index) {
       /* if the hash key was new, add it to the OneToOne, and setup entry */
-      if(OVreturn_IS_ERROR(status = OVOneToOne_Set(uk->up, hash, index))) {
+      if(OVreturn_IS_ERROR(status = OVOneToOne_Set(sh->up, hash, index))) {
         OVreturn_word result;
-        uk->entry[index].next = uk->free_index; /* record this as a free entry */
-        uk->free_index = index;
-        uk->n_active--;
+        ReleaseString(uk, entry_ptr);
+        entry_ptr->next = sh->free_index;       /* record this as a free entry */
+        sh->free_index = index;
         result.status = status.status;
         result.word = 0;
         return result;
       }
-      entry_ptr = uk->entry + index;
       entry_ptr->next = 0;
 
     } else {
       /* otherwise, simply add this entry on to the list in position 2 */
-
-      cur_entry_ptr = (entry = uk->entry) + cur_index;
-      entry_ptr = entry + index;
+      lex_entry *cur_entry_ptr = Entry(sh, cur_index);
       entry_ptr->next = cur_entry_ptr->next;
       cur_entry_ptr->next = index;
     }
-    /* increase the counts and sizes to accomodate this new entry & copy info */
+    /* copy info & take the first reference */
     entry_ptr->hash = hash;
-    entry_ptr->size = st_size;
-    entry_ptr->offset = uk->data_size;
-    entry_ptr->ref_cnt++;       /* increase ref_cnt */
-    strcpy(uk->data + uk->data_size, str);
-    uk->data_size += st_size;
+    memcpy(entry_ptr->str, str, st_size);
+    entry_ptr->ref_cnt = 1;
+    sh->n_active++;
   } else {
-    lex_entry *entry_ptr;
-    entry_ptr = uk->entry + index;
-    entry_ptr->ref_cnt++;       /* increase ref_cnt */
+    Entry(sh, index)->ref_cnt++;        /* increase ref_cnt */
   }
   {
     OVreturn_word result = { OVstatus_SUCCESS };
-    result.word = index;
+    result.word = (index << LEX_SHARD_BITS) | shard;
     return result;
   }
 }
@@ -343,27 +386,13 @@ OVreturn_word OVLexicon_BorrowFromCString(OVLexicon * uk, const ov_char8 * str)
 {
   /* get hash token for this word */
   ov_word hash = _GetCStringHash((ov_uchar8 *) str);
-  OVreturn_word search = OVOneToOne_GetForward(uk->up, hash);
-  ov_word index = 0;
-  ov_char8 *c;
-
-  /* error is something like OVstatus_NULL_PTR, OVstatus_NOT_FOUND; see ov/src/OVreturns.h */
-  if(OVreturn_IS_ERROR(search)) {
-    return search;
-  } else {
-    /* the hash key has been registered, so follow the chain
-     * looking for a match... */
-    ov_char8 *data = uk->data;
-    lex_entry *entry = uk->entry, *entry_ptr;
-    index = search.word;
-    while(index) {              /* found */
-      c = data + (entry_ptr = (entry + index))->offset;
-      if(strcmp(c, str) != 0) { /* verify match */
-        index = entry_ptr->next;        /* not a match? keep looking */
-      } else {
-        break;
-      }
-    }
+  ov_uword shard = ShardOf(hash);
+  lex_shard *sh = uk->shard + shard;
+  ov_word cur_index = 0;
+  ov_word index;
+  {
+    std::lock_guard<std::mutex> lock(sh->mutex);
+    index = FindLocked(sh, hash, str, &cur_index);
   }
 
   if(!index) {
@@ -372,14 +401,15 @@ OVreturn_word OVLexicon_BorrowFromCString(OVLexicon * uk, const ov_char8 * str)
     return result;
   } else {
     OVreturn_word result = { OVstatus_SUCCESS };
-    result.word = index;
+    result.word = (index << LEX_SHARD_BITS) | shard;
     return result;
   }
 }
 
 ov_char8 *OVLexicon_FetchCString(OVLexicon * uk, ov_word id)
 {
-  if(id <= (ov_word) uk->n_entry)
-    return uk->data + uk->entry[id].offset;
+  lex_entry *entry = Lookup(uk, id);
+  if(entry)
+    return entry->str;
   return NULL;
 }
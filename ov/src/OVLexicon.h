@@ -8,6 +8,9 @@
 
 /* 
    OVLexicon -- a collection of strings and their identifiers
+
+   Thread safe: strings may be interned, fetched and released from
+   several threads at once.
 */
 
 #ifndef OVLexicon_DEFINED
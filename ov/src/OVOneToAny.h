@@ -24,6 +24,8 @@ OVreturn_word OVOneToAny_GetKey(OVOneToAny * o2o, ov_word forward_value);
 OVstatus OVOneToAny_SetKey(OVOneToAny * o2o, ov_word forward_value,
                            ov_word reverse_value);
 
+/* presizes the tables for size entries (bulk inserts) */
+OVstatus OVOneToAny_Reserve(OVOneToAny * o2o, ov_size size);
 OVstatus OVOneToAny_Pack(OVOneToAny * o2o);
 OVreturn_size OVOneToAny_GetSize(OVOneToAny * o2o);
 OVstatus OVOneToAny_DelKey(OVOneToAny * o2o, ov_word forward_value);
@@ -1,9 +1,30 @@
-
 #include "OVOneToOne.h"
 #include "OVHeapArray.h"
 #include "ov_utility.h"
 
-#define HASH(value,mask) (((value^(value>>24))^((value>>8)^(value>>16)))&mask)
+/* Open addressing with linear probing and Robin Hood displacement: the
+ * forward and reverse tables hold (value, element index) pairs directly,
+ * so that a lookup touches one or two adjacent slots instead of walking
+ * a linked chain through the element array. Sequential values (unique
+ * ids, offsets) land in sequential slots, and the Robin Hood ordering lets
+ * unsuccessful lookups stop early even inside long runs. Tables are kept
+ * at most 1/2 full, and can be presized for bulk inserts with
+ * OVOneToOne_Reserve. Deletion shifts the following entries back, so there
+ * are no tombstones. Elements stay in a dense array (with a free list),
+ * which keeps iteration order stable.
+ */
+
+static ov_uword Hash(ov_word value, ov_uword mask)
+{
+  ov_uword h = (ov_uword) value;
+  return (h ^ (h >> 16)) & mask;
+}
+
+/* distance of slot a from the home slot of value */
+static ov_uword Dist(ov_word value, ov_uword a, ov_uword mask)
+{
+  return (a - Hash(value, mask)) & mask;
+}
 
 
 /* FYI: "up" stands for UniquePair -- a precursor to OneToOne */
@@ -11,17 +32,22 @@
 typedef struct {
   int active;
   ov_word forward_value, reverse_value;
-  ov_size forward_next, reverse_next;
+  ov_size next_inactive;
 } up_element;
 
+typedef struct {
+  ov_word value;
+  ov_size index;                /* 1-based element index, 0 = empty */
+} up_slot;
+
 struct _OVOneToOne {
   OVHeap *heap;
   ov_uword mask;
   ov_size size, n_inactive;
   ov_word next_inactive;
   up_element *elem;
-  ov_word *forward;
-  ov_word *reverse;
+  up_slot *forward;
+  up_slot *reverse;
 };
 
 OVstatus OVOneToOne_Init(OVOneToOne * up, OVHeap * heap)
@@ -68,11 +94,11 @@ void OVOneToOne_Dump(OVOneToOne * up)
   ov_boolean empty = OV_TRUE;
   if(up && up->mask) {
     for(a = 0; a <= up->mask; a++) {
-      if(up->forward[a] || up->reverse[a]) {
+      if(up->forward[a].index || up->reverse[a].index) {
         fprintf(stderr,
-                " OVOneToOne_Dump: Hashes forward[0x%02x]->%d    reverse[0x%02x]->%d\n",
-                (unsigned int) a, (int) up->forward[a],
-                (unsigned int) a, (int) up->reverse[a]);
+                " OVOneToOne_Dump: Slots forward[0x%02x]->%d    reverse[0x%02x]->%d\n",
+                (unsigned int) a, (int) up->forward[a].index,
+                (unsigned int) a, (int) up->reverse[a].index);
         empty = OV_FALSE;
       }
     }
@@ -80,11 +106,9 @@ void OVOneToOne_Dump(OVOneToOne * up)
     for(a = 0; a < up->size; a++)
       if(up->elem[a].active) {
         fprintf(stderr,
-                " OVOneToOne_Dump: Elements %d:    %d (->%d)    %d (->%d)\n",
+                " OVOneToOne_Dump: Elements %d:    %d    %d\n",
                 (int) a + 1,
-                (int) up->elem[a].forward_value,
-                (int) up->elem[a].forward_next,
-                (int) up->elem[a].reverse_value, (int) up->elem[a].reverse_next);
+                (int) up->elem[a].forward_value, (int) up->elem[a].reverse_value);
         empty = OV_FALSE;
       }
   }
@@ -93,61 +117,68 @@ void OVOneToOne_Dump(OVOneToOne * up)
   }
 }
 
-static void Reload(OVOneToOne * up)
-{                               /* assumes hash tables are clean and initialized to zero */
-#ifdef DEBUG_UP
-  fprintf(stderr, "Reload-Debug: entered\n");
-#endif
-  ov_uword mask = up->mask;
+/* returns the slot holding value, or NULL */
+static up_slot *Find(up_slot * table, ov_uword mask, ov_word value)
+{
+  ov_uword a = Hash(value, mask), d = 0;
+  for(;; a = (a + 1) & mask, d++) {
+    if(!table[a].index || Dist(table[a].value, a, mask) < d)
+      return NULL;
+    if(table[a].value == value)
+      return table + a;
+  }
+}
 
-  if(up->elem && mask) {
-    {
-      up_element *elem = up->elem;
-      ov_uword a;
-      for(a = 0; a < up->size; a++) {
-        if(elem->active) {
-          elem->forward_next = 0;       /* 0 is the sentinel for end of list */
-          elem->reverse_next = 0;
-        }
-        elem++;
+static void Insert(up_slot * table, ov_uword mask, ov_word value, ov_size index)
+{
+  up_slot cur = { value, index };
+  ov_uword a = Hash(value, mask), d = 0;
+  for(;; a = (a + 1) & mask, d++) {
+    if(!table[a].index) {
+      table[a] = cur;
+      return;
+    } else {
+      ov_uword e = Dist(table[a].value, a, mask);
+      if(e < d) {               /* take the slot from the richer entry */
+        up_slot tmp = table[a];
+        table[a] = cur;
+        cur = tmp;
+        d = e;
       }
     }
+  }
+}
 
-    {
-      ov_uword a;
-      ov_word *forward = up->forward;
-      ov_word *reverse = up->reverse;
-      up_element *elem = up->elem;
-      {
-        ov_word fwd, rev;
-        ov_word fwd_val;
-        ov_word rev_val;
-        for(a = 0; a < up->size; a++) {
-          if(elem->active) {
-            fwd_val = elem->forward_value;
-            rev_val = elem->reverse_value;
-            fwd = HASH(fwd_val, mask);
-            rev = HASH(rev_val, mask);
-            elem->forward_next = forward[fwd];
-            forward[fwd] = a + 1;       /* NOTE: 1 based indices */
-            elem->reverse_next = reverse[rev];
-            reverse[rev] = a + 1;
-          }
-          elem++;
-        }
-      }
+/* empties slot and moves the following displaced entries back by one */
+static void Excise(up_slot * table, ov_uword mask, up_slot * slot)
+{
+  ov_uword a = slot - table;
+  for(;;) {
+    ov_uword b = (a + 1) & mask;
+    if(!table[b].index || !Dist(table[b].value, b, mask)) {
+      table[a].index = 0;
+      return;
     }
+    table[a] = table[b];
+    a = b;
   }
-#ifdef DEBUG_UP
-  {
+}
+
+static void Reload(OVOneToOne * up)
+{                               /* assumes hash tables are clean and initialized to zero */
+  ov_uword mask = up->mask;
+
+  if(up->elem && mask) {
+    up_element *elem = up->elem;
     ov_uword a;
-    for(a = 0; a <= up->mask; a++) {
-      fprintf(stderr, "Reload-Debug: forward[%d]=%d, reverse[%d]=%d\n",
-              a, up->forward[a], a, up->reverse[a]);
+    for(a = 0; a < up->size; a++) {
+      if(elem->active) {
+        Insert(up->forward, mask, elem->forward_value, a + 1);  /* NOTE: 1 based indices */
+        Insert(up->reverse, mask, elem->reverse_value, a + 1);
+      }
+      elem++;
     }
   }
-#endif
-
 }
 
 OVreturn_word OVOneToOne_GetReverse(OVOneToOne * up, ov_word reverse_value)
@@ -157,19 +188,11 @@ OVreturn_word OVOneToOne_GetReverse(OVOneToOne * up, ov_word reverse_value)
     return result;
   } else {
     if(up->mask) {
-      ov_word hash = HASH(reverse_value, up->mask);
-      up_element *elem = up->elem;
-      ov_word index = up->reverse[hash];
-      up_element *cur_elem = elem + (index - 1);
-
-      while(index) {
-        if(cur_elem->reverse_value == reverse_value) {
-          OVreturn_word result = { OVstatus_SUCCESS };
-          result.word = cur_elem->forward_value;
-          return result;
-        }
-        index = cur_elem->reverse_next;
-        cur_elem = elem + (index - 1);
+      up_slot *slot = Find(up->reverse, up->mask, reverse_value);
+      if(slot) {
+        OVreturn_word result = { OVstatus_SUCCESS };
+        result.word = up->elem[slot->index - 1].forward_value;
+        return result;
       }
     }
     {
@@ -208,20 +231,12 @@ OVreturn_word OVOneToOne_GetForward(OVOneToOne * up, ov_word forward_value)
     OVreturn_word result = { OVstatus_NULL_PTR };
     return result;
   } else {
-    ov_uword mask = up->mask;
-    if(mask) {
-      ov_word hash = HASH(forward_value, mask);
-      up_element *elem = up->elem;
-      ov_word index = up->forward[hash];
-      up_element *cur_elem = elem + (index - 1);
-      while(index) {
-        if(cur_elem->forward_value == forward_value) {
-          OVreturn_word result = { OVstatus_SUCCESS };
-          result.word = cur_elem->reverse_value;
-          return result;
-        }
-        index = cur_elem->forward_next;
-        cur_elem = elem + (index - 1);
+    if(up->mask) {
+      up_slot *slot = Find(up->forward, up->mask, forward_value);
+      if(slot) {
+        OVreturn_word result = { OVstatus_SUCCESS };
+        result.word = up->elem[slot->index - 1].reverse_value;
+        return result;
       }
     }
     {
@@ -237,24 +252,19 @@ static OVstatus Recondition(OVOneToOne * up, ov_uword size, int force)
     return_OVstatus_NULL_PTR;
   } else {
     ov_uword mask = up->mask;
-#ifdef DEBUG_UP
-    fprintf(stderr, "Recondition-Debug: entered for size %d.\n", size);
-#endif
-    if((size > mask) || ((size << 2) < mask) || force) {
+    /* keep tables between 1/8 and 1/2 full */
+    if(((size << 1) > mask) || ((size << 3) < mask) || force) {
 
-      while((size << 2) < mask) {
+      while((size << 3) < mask) {
         mask = mask >> 1;
-        if(mask < 2)
+        if(mask < 4)
           break;
       }
 
-      while(size > mask) {
+      while((size << 1) > mask) {
         mask = (mask << 1) + 1;
       }
 
-#ifdef DEBUG_UP
-      fprintf(stderr, "Recondition-Debug: mask %d\n", mask);
-#endif
       {
         if(!up->elem) {
           up->elem = OVHeapArray_CALLOC(up->heap, up_element, size);
@@ -262,21 +272,26 @@ static OVstatus Recondition(OVOneToOne * up, ov_uword size, int force)
             return_OVstatus_OUT_OF_MEMORY;
           }
         }
+        up_slot *tmp_forward = NULL, *tmp_reverse = NULL;
         if(mask != up->mask) {
-          ov_word *tmp_forward = OVHeap_CALLOC(up->heap, ov_word, mask + 1);
-          ov_word *tmp_reverse = OVHeap_CALLOC(up->heap, ov_word, mask + 1);
+          tmp_forward = OVHeap_CALLOC(up->heap, up_slot, mask + 1);
+          tmp_reverse = OVHeap_CALLOC(up->heap, up_slot, mask + 1);
           if(!(tmp_forward && tmp_reverse)) {   /* validate */
             OVHeap_FREE_AUTO_NULL(up->heap, tmp_forward);
             OVHeap_FREE_AUTO_NULL(up->heap, tmp_reverse);
-            /* being unable to condition is not an error */
-          } else {
-            /* impossible to fail after here... */
-            OVHeap_FREE_AUTO_NULL(up->heap, up->forward);
-            OVHeap_FREE_AUTO_NULL(up->heap, up->reverse);
-            up->forward = tmp_forward;
-            up->reverse = tmp_reverse;
-            up->mask = mask;
+            /* being unable to condition is not an error, as long as
+               there is still an empty slot to terminate probing */
+            if(size > up->mask)
+              return_OVstatus_OUT_OF_MEMORY;
           }
+        }
+        if(tmp_forward) {
+          /* impossible to fail after here... */
+          OVHeap_FREE_AUTO_NULL(up->heap, up->forward);
+          OVHeap_FREE_AUTO_NULL(up->heap, up->reverse);
+          up->forward = tmp_forward;
+          up->reverse = tmp_reverse;
+          up->mask = mask;
         } else {
           ov_utility_zero_range(up->forward, up->forward + (up->mask + 1));
           ov_utility_zero_range(up->reverse, up->reverse + (up->mask + 1));
@@ -288,6 +303,20 @@ static OVstatus Recondition(OVOneToOne * up, ov_uword size, int force)
   return_OVstatus_SUCCESS;
 }
 
+OVstatus OVOneToOne_Reserve(OVOneToOne * up, ov_size size)
+{
+  if(!up) {
+    return_OVstatus_NULL_PTR;
+  } else if(size > up->size) {
+    if(up->elem && (!OVHeapArray_CHECK(up->elem, up_element, size - 1))) {
+      return_OVstatus_OUT_OF_MEMORY;
+    }
+    if((size << 1) > up->mask)
+      return Recondition(up, size, OV_FALSE);
+  }
+  return_OVstatus_SUCCESS;
+}
+
 OVstatus OVOneToOne_Pack(OVOneToOne * up)
 {
   if(!up) {
@@ -333,71 +362,43 @@ OVreturn_size OVOneToOne_GetSize(OVOneToOne * up)
   }
 }
 
-OVstatus OVOneToOne_DelReverse(OVOneToOne * up, ov_word reverse_value)
+/* removes the element referenced by a forward table slot */
+static OVstatus Remove(OVOneToOne * up, up_slot * fwd)
 {
-  if(!up) {
-    return_OVstatus_NULL_PTR;
-  } else {
-    ov_word mask = up->mask;
-    if(mask) {
-      ov_word rev_hash = HASH(reverse_value, mask);
-      ov_word rev = up->reverse[rev_hash];
-
-      if(!rev) {
-        return_OVstatus_NOT_FOUND;
-      } else {
-        up_element *rev_elem = NULL;
-        up_element *elem = up->elem;
-        ov_word rev_last = 0;
-
-        while(rev) {
-          rev_elem = elem + (rev - 1);
-          if(rev_elem->reverse_value == reverse_value)
-            break;
-          rev_last = rev;
-          rev = rev_elem->reverse_next;
-        }
-
-        if(rev_elem) {
-          ov_word rev_fwd_val = rev_elem->forward_value;
-          ov_word fwd_hash = HASH(rev_fwd_val, mask);
-          ov_word fwd = up->forward[fwd_hash];
-          ov_word fwd_last = 0;
-          up_element *fwd_elem = NULL;
-
-          while(fwd) {
-            fwd_elem = elem + (fwd - 1);
-            if(fwd_elem == rev_elem)
-              break;
-            fwd_last = fwd;
-            fwd = fwd_elem->forward_next;
-          }
+  ov_size index = fwd->index;
+  up_element *elem = up->elem + (index - 1);
+  up_slot *rev = Find(up->reverse, up->mask, elem->reverse_value);
 
-          if(rev && (rev == fwd)) {
-
-            /* excise element */
+  if(!rev || rev->index != index) {
+    return_OVstatus_NOT_FOUND;
+  }
 
-            if(rev_last)
-              up->elem[rev_last - 1].reverse_next = rev_elem->reverse_next;
-            else
-              up->reverse[rev_hash] = rev_elem->reverse_next;
+  Excise(up->forward, up->mask, fwd);
+  Excise(up->reverse, up->mask, rev);
 
-            if(fwd_last)
-              up->elem[fwd_last - 1].forward_next = fwd_elem->forward_next;
-            else
-              up->forward[fwd_hash] = fwd_elem->forward_next;
+  /* store as inactive */
 
-            /* store as inactive */
+  elem->active = OV_FALSE;
+  elem->next_inactive = up->next_inactive;
+  up->next_inactive = index;
+  up->n_inactive++;
+  if(up->n_inactive > (up->size >> 1))  /* over half of bits are inactive */
+    OVOneToOne_Pack(up);
+  return_OVstatus_SUCCESS;
+}
 
-            rev_elem->active = OV_FALSE;
-            rev_elem->forward_next = up->next_inactive;
-            up->next_inactive = rev;
-            up->n_inactive++;
-            if(up->n_inactive > (up->size >> 1))        /* over half of bits are inactive */
-              OVOneToOne_Pack(up);
-            return_OVstatus_SUCCESS;
-          }
-        }
+OVstatus OVOneToOne_DelReverse(OVOneToOne * up, ov_word reverse_value)
+{
+  if(!up) {
+    return_OVstatus_NULL_PTR;
+  } else {
+    if(up->mask) {
+      up_slot *rev = Find(up->reverse, up->mask, reverse_value);
+      if(rev) {
+        ov_word forward_value = up->elem[rev->index - 1].forward_value;
+        up_slot *fwd = Find(up->forward, up->mask, forward_value);
+        if(fwd)
+          return Remove(up, fwd);
       }
     }
     return_OVstatus_NOT_FOUND;
@@ -409,66 +410,10 @@ OVstatus OVOneToOne_DelForward(OVOneToOne * up, ov_word forward_value)
   if(!up) {
     return_OVstatus_NULL_PTR;
   } else {
-    ov_word mask = up->mask;
-    if(mask) {
-      ov_word fwd_hash = HASH(forward_value, mask);
-      ov_word fwd = up->forward[fwd_hash];
-      if(!fwd) {
-        return_OVstatus_NOT_FOUND;
-      } else {
-        up_element *fwd_elem = NULL;
-        up_element *elem = up->elem;
-        ov_word fwd_last = 0;
-
-        while(fwd) {
-          fwd_elem = elem + (fwd - 1);
-          if(fwd_elem->forward_value == forward_value)
-            break;
-          fwd_last = fwd;
-          fwd = fwd_elem->forward_next;
-        }
-
-        if(fwd_elem) {
-          ov_word fwd_rev_val = fwd_elem->reverse_value;
-          ov_word rev_hash = HASH(fwd_rev_val, mask);
-          ov_word rev = up->reverse[rev_hash];
-          ov_word rev_last = 0;
-          up_element *rev_elem = NULL;
-
-          while(rev) {
-            rev_elem = elem + (rev - 1);
-            if(rev_elem == fwd_elem)
-              break;
-            rev_last = rev;
-            rev = rev_elem->reverse_next;
-          }
-
-          if(fwd && (fwd == rev)) {
-
-            /* excise elements */
-
-            if(fwd_last)
-              up->elem[fwd_last - 1].forward_next = fwd_elem->forward_next;
-            else
-              up->forward[fwd_hash] = fwd_elem->forward_next;
-
-            if(rev_last)
-              up->elem[rev_last - 1].reverse_next = rev_elem->reverse_next;
-            else
-              up->reverse[rev_hash] = rev_elem->reverse_next;
-
-            /* store as inactive */
-
-            fwd_elem->active = OV_FALSE;
-            fwd_elem->forward_next = up->next_inactive;
-            up->next_inactive = fwd;
-            up->n_inactive++;
-            if(up->n_inactive > (up->size >> 1))        /* over half of bits are inactive */
-              OVOneToOne_Pack(up);
-            return_OVstatus_SUCCESS;
-          }
-        }
-      }
+    if(up->mask) {
+      up_slot *fwd = Find(up->forward, up->mask, forward_value);
+      if(fwd)
+        return Remove(up, fwd);
     }
     return_OVstatus_NOT_FOUND;
   }
@@ -479,41 +424,19 @@ void OVOneToOne_Stats(OVOneToOne * up)
   if(up && up->mask) {
     int max_len = 0;
     ov_uword a;
-    for(a = 0; a < up->mask; a++) {
-      {
-        ov_word index = up->forward[a];
-        up_element *elem = up->elem;
-        int cnt = 0;
-        if(index) {
-          up_element *cur_elem;
-          while(index) {
-            cur_elem = elem + (index - 1);
-            index = cur_elem->forward_next;
-            cnt++;
-          }
-          if(cnt > max_len)
-            max_len = cnt;
-        }
+    for(a = 0; a <= up->mask; a++) {
+      if(up->forward[a].index) {
+        int len = (int) Dist(up->forward[a].value, a, up->mask) + 1;
+        if(len > max_len)
+          max_len = len;
       }
-
-      {
-        ov_word index = up->reverse[a];
-        up_element *elem = up->elem;
-        int cnt = 0;
-        if(index) {
-          up_element *cur_elem;
-          while(index) {
-            cur_elem = elem + (index - 1);
-            index = cur_elem->reverse_next;
-            cnt++;
-          }
-          if(cnt > max_len)
-            max_len = cnt;
-        }
+      if(up->reverse[a].index) {
+        int len = (int) Dist(up->reverse[a].value, a, up->mask) + 1;
+        if(len > max_len)
+          max_len = len;
       }
-
     }
-    fprintf(stderr, " OVOneToOne_Stats: MaxLen=%d ", max_len);
+    fprintf(stderr, " OVOneToOne_Stats: MaxProbe=%d ", max_len);
     fprintf(stderr, "active=%d n_inactive=%d ", (int)( up->size - up->n_inactive),
             (int) up->n_inactive);
     fprintf(stderr, "mask=0x%x n_alloc=%lu\n", (unsigned int) up->mask,
@@ -526,61 +449,13 @@ OVstatus OVOneToOne_Set(OVOneToOne * up, ov_word forward_value, ov_word reverse_
   if(!up) {
     return_OVstatus_NULL_PTR;
   } else {
-    ov_word mask = up->mask;
-    ov_word fwd_hash = HASH(forward_value, mask);
-    ov_word rev_hash = HASH(reverse_value, mask);
-    up_element *fwd_elem = NULL;
-    up_element *rev_elem = NULL;
-    ov_word fwd;
-    ov_word rev;
-    if(!mask) {
-      fwd = 0;
-      rev = 0;
-    } else {
-
-      fwd = up->forward[fwd_hash];
-      rev = up->reverse[rev_hash];
-
-#ifdef DEBUG_OVOneToOne
-      fprintf(stderr, "OVOneToOneSet-Debug: set %d,%d\n", forward_value, reverse_value);
-      fprintf(stderr, "OVOneToOneSet-Debug: fwd_hash %d rev_hash %d mask %d size %d\n",
-              fwd_hash, rev_hash, up->mask, up->size);
-      fprintf(stderr, "OVOneToOneSet-Debug: before search fwd rev %d %d\n", fwd, rev);
-#endif
-
-      {                         /* find elements if they exist, and detect erroneous conditions */
-
-        up_element *elem = up->elem;
-
-#ifdef DEBUG_OVOneToOne
-        {
-          int a;
-          for(a = 0; a < up->size; a++) {
-            fprintf(stderr, "OVOneToOneSet-Debug: on entry %d forward_next: %d\n",
-                    a + 1, elem[a].forward_next);
-          }
-
-          for(a = 0; a <= up->mask; a++) {
-            fprintf(stderr,
-                    "OVOneToOneSet-Debug: on entry %d forward hash %d: reverse_hash: %d\n",
-                    a, up->forward[a], up->reverse[a]);
-          }
-        }
-#endif
+    ov_size fwd = 0, rev = 0;   /* 1-based element indices, 0 = not found */
 
-        while(fwd) {
-          fwd_elem = elem + (fwd - 1);
-          if(fwd_elem->forward_value == forward_value)
-            break;
-          fwd = fwd_elem->forward_next;
-        }
-        while(rev) {
-          rev_elem = elem + (rev - 1);
-          if(rev_elem->reverse_value == reverse_value)
-            break;
-          rev = rev_elem->reverse_next;
-        }
-      }
+    if(up->mask) {
+      up_slot *fwd_slot = Find(up->forward, up->mask, forward_value);
+      up_slot *rev_slot = Find(up->reverse, up->mask, reverse_value);
+      fwd = fwd_slot ? fwd_slot->index : 0;
+      rev = rev_slot ? rev_slot->index : 0;
 
       if((fwd && (!rev)) || (rev && (!fwd))) {
         return_OVstatus_DUPLICATE;
@@ -589,19 +464,18 @@ OVstatus OVOneToOne_Set(OVOneToOne * up, ov_word forward_value, ov_word reverse_
     if(!(fwd || rev)) {
       ov_size new_index;
       /* new pair */
-#ifdef DEBUG_OVOneToOne
-      fprintf(stderr, "OVOneToOneSet-Debug: New pair.\n");
-#endif
       if(up->n_inactive) {
         new_index = up->next_inactive;
-        up->next_inactive = up->elem[new_index - 1].forward_next;
+        up->next_inactive = up->elem[new_index - 1].next_inactive;
         up->n_inactive--;
       } else {
         if(up->elem && (!OVHeapArray_CHECK(up->elem, up_element, up->size))) {
           return_OVstatus_OUT_OF_MEMORY;
         } else {
           OVstatus result;
-          if(OVreturn_IS_ERROR(result = Recondition(up, up->size + 1, OV_FALSE))) {
+          /* only grow here, a reserved table must not shrink back */
+          if(((up->size + 1) << 1) > up->mask &&
+             OVreturn_IS_ERROR(result = Recondition(up, up->size + 1, OV_FALSE))) {
             return result;
           } else {
             /* guaranteed to succeed past this point, so we can increase size */
@@ -615,34 +489,11 @@ OVstatus OVOneToOne_Set(OVOneToOne * up, ov_word forward_value, ov_word reverse_
         elem->reverse_value = reverse_value;
         elem->active = OV_TRUE;
 
-        /* regenerate new hashes */
-        mask = up->mask;
-        fwd_hash = HASH(forward_value, mask);
-        rev_hash = HASH(reverse_value, mask);
-
-        {
-          ov_word *forward_start_index = up->forward + fwd_hash;
-          ov_word *reverse_start_index = up->reverse + rev_hash;
-
-          elem->forward_next = *forward_start_index;
-          *forward_start_index = new_index;     /* note the +1 offset */
-          elem->reverse_next = *reverse_start_index;
-          *reverse_start_index = new_index;     /* note the +1 offset */
-        }
-
-#ifdef DEBUG_OVOneToOne
-        {
-          int a;
-          for(a = 0; a <= up->mask; a++) {
-            fprintf(stderr, "OVOneToOneSet-Debug: forward[%d]=%d, reverse[%d]=%d\n",
-                    a, up->forward[a], a, up->reverse[a]);
-          }
-        }
-#endif
-
+        Insert(up->forward, up->mask, forward_value, new_index);
+        Insert(up->reverse, up->mask, reverse_value, new_index);
       }
 
-    } else if(fwd_elem != rev_elem) {
+    } else if(fwd != rev) {
       return_OVstatus_MISMATCH;
     } else {
       return_OVstatus_NO_EFFECT;
@@ -29,6 +29,8 @@ OVreturn_word OVOneToOne_GetForward(OVOneToOne * o2o, ov_word forward_value);
 OVreturn_word OVOneToOne_GetReverse(OVOneToOne * o2o, ov_word reverse_value);
 OVstatus OVOneToOne_Set(OVOneToOne * o2o, ov_word forward_value, ov_word reverse_value);
 
+/* presizes the tables for size entries (bulk inserts) */
+OVstatus OVOneToOne_Reserve(OVOneToOne * o2o, ov_size size);
 OVstatus OVOneToOne_Pack(OVOneToOne * o2o);
 OVreturn_size OVOneToOne_GetSize(OVOneToOne * o2o);
 OVstatus OVOneToOne_DelReverse(OVOneToOne * o2o, ov_word reverse_value);
@@ -377,6 +377,11 @@ if not (MAC or WIN):
             "glut",
         ]
 
+if not WIN:
+    # std::thread (layer0/Parallel.h)
+    ext_comp_args += ["-pthread"]
+    ext_link_args += ["-pthread"]
+
 if True:
     try:
         import numpy
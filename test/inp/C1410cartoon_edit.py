@@ -0,0 +1,64 @@
+# -c
+
+# Cartoons rebuilt after coordinate edits reuse the extruded runs of the
+# previous build. The result must be identical to building from scratch,
+# and the reused runs must be released once editing stops.
+
+from pymol import cmd
+
+print("BEGIN-LOG")
+
+cmd.feedback("disable", "ray", "details")
+
+edits = [
+   ("chain A and resi 20-22", [0.5, 0.0, 0.0]),
+   ("chain A and resi 21", [0.0, -0.3, 0.2]),
+   ("chain B and resi 40-45", [0.0, 0.0, 1.0]),
+   ("chain A and resi 60-90", [-0.4, 0.4, 0.0]),
+   ("chain A and resi 20-22", [-0.5, 0.0, 0.0]),
+]
+
+def setup():
+   cmd.delete("all")
+   cmd.load("dat/1tii.pdb", "m")
+   cmd.remove("not (polymer and chain A+B)")
+   cmd.show_as("cartoon")
+   cmd.color("green", "m and chain A")
+   cmd.color("cyan", "m and chain B")
+   cmd.set("cartoon_transparency", 0.2, "m and chain B")
+   cmd.refresh()
+
+def reps_size():
+   return cmd.memory_report(quiet=1)["objects"]["m"]["reps"]
+
+def play(from_scratch):
+   setup()
+   scenes = []
+   sizes = []
+   for sele, vector in edits:
+      cmd.translate(vector, sele, camera=0)
+      if from_scratch:
+         cmd.rebuild()
+      cmd.refresh()
+      scenes.append(cmd.get_povray())
+      sizes.append(reps_size())
+   return scenes, sizes
+
+ref, ref_sizes = play(True)
+cached, cached_sizes = play(False)
+for i in range(len(edits)):
+   assert ref[i] == cached[i], i
+   # the runs are kept for the next edit
+   assert cached_sizes[i] > ref_sizes[i], i
+   print("edit %d identical" % (i + 1))
+
+# a scene update without a coordinate change releases the runs
+edited = reps_size()
+cmd.pseudoatom("tmp")
+cmd.disable("tmp")
+cmd.refresh()
+assert reps_size() < edited
+assert cmd.get_povray() == cached[-1]
+print("released")
+
+print("END-LOG")
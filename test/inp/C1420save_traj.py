@@ -0,0 +1,66 @@
+# -c
+
+# save_traj round trip: write a multi-state selection, load it back with
+# load_traj onto a copy and compare the coordinates of every state.
+# Single-state objects are static (static_singletons) and object matrices
+# are applied, like in "save".
+
+import pymol
+from pymol import cmd
+
+print("BEGIN-LOG")
+
+cmd.feedback("disable", "all", "actions details")
+
+def coords(sele, state):
+   return [[round(c, 3) for c in xyz] for xyz in cmd.get_coords(sele, state).tolist()]
+
+def round_trip(label, sele, n_state, expected, **kwargs):
+   cmd.delete("copy")
+   cmd.create("copy", sele, 1, 1)
+   # the trajectory has the object matrix applied already
+   cmd.reset(object="copy")
+   cmd.save_traj("tmp/C1420save_traj.trr", sele, **kwargs)
+   cmd.load_traj("tmp/C1420save_traj.trr", "copy", state=1)
+   assert cmd.count_states("copy") == n_state, (label, cmd.count_states("copy"))
+   for state in range(1, n_state + 1):
+      assert coords("copy", state) == expected(state), (label, state)
+   print("%-24s %d atoms %d states" % (label, cmd.count_atoms("copy"), n_state))
+
+cmd.load("dat/pept.pdb", "m")
+for state in range(2, 6):
+   cmd.create("m", "m and state 1", 1, state)
+   cmd.translate([state, -state, 0.5 * state], "m", state=state, camera=0)
+cmd.load("dat/pept.pdb", "s")
+cmd.alter("s", "chain = 'S'")
+cmd.translate([0, 0, 20], "s", camera=0)
+
+round_trip("multi-state", "m", 5, lambda state: coords("m", state))
+
+round_trip("interval", "m", 2, lambda state: coords("m", 2 * state),
+           start=2, stop=4, interval=2)
+
+# single-state object in every frame, after the atoms of "m"
+round_trip("static singleton", "m or s", 5,
+           lambda state: coords("m", state) + coords("s", 1))
+
+# without static_singletons only the first state has all coordinates
+cmd.set("static_singletons", 0, "s")
+round_trip("no static singleton", "m or s", 1,
+           lambda state: coords("m", state) + coords("s", 1))
+cmd.unset("static_singletons", "s")
+
+# object matrix (TTT) is applied
+cmd.translate([0, 5, 0], "m", state=0, camera=0, object="m")
+round_trip("object matrix", "m", 5, lambda state: coords("m", state))
+
+# writers which need a structure are rejected instead of crashing
+try:
+   cmd.save_traj("tmp/C1420save_traj.xyz", "m")
+except pymol.CmdException:
+   print("xyz rejected")
+
+# selections are preprocessed like in "save" (object/index tuple)
+round_trip("index tuple", ("m", 5), 5, lambda state: coords("m`5", state))
+
+print("END-LOG")
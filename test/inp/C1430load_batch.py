@@ -0,0 +1,106 @@
+# -c
+
+# load_batch must give the same result as a cmd.load loop over the same
+# files: object names (also when a name repeats or is only unique before
+# ExecutiveProcessObjectName, so the file is loaded serially), atom
+# counts, carbon auto colors, state counts and the order of feedback.
+
+import os
+import shutil
+import sys
+from pymol import cmd
+
+print("BEGIN-LOG")
+
+cmd.feedback("disable", "all", "details")
+
+# test files (PDB, multi-entry SDF, MOL2, CIF)
+shutil.rmtree("tmp/batch", True)
+for d in ("a", "b"):
+   os.makedirs("tmp/batch/" + d)
+cmd.load("dat/pept.pdb", "pept")
+cmd.save("tmp/batch/a/pept.cif", "pept")
+cmd.save("tmp/batch/b/dipept.cif", "pept and resi 1-2")
+cmd.save("tmp/batch/a/x y.pdb", "pept and resi 1-5")
+shutil.copy("dat/pept.pdb", "tmp/batch/a/pept.pdb")
+shutil.copy("dat/tiny.pdb", "tmp/batch/a/x_y.pdb")
+shutil.copy("dat/small02.pdb", "tmp/batch/a/small02.pdb")
+shutil.copy("dat/small02.pdb", "tmp/batch/b/small02.pdb")
+shutil.copy("dat/ligs3d.sdf", "tmp/batch/a/ligs3d.sdf")
+shutil.copy("dat/small01.mol", "tmp/batch/b/small01.mol")
+shutil.copy("dat/small03.mol2", "tmp/batch/b/small03.mol2")
+cmd.delete("all")
+
+files = [
+   "tmp/batch/a/pept.pdb",
+   "tmp/batch/a/small02.pdb",
+   "tmp/batch/a/ligs3d.sdf",
+   "tmp/batch/b/small03.mol2",
+   "tmp/batch/b/dipept.cif",
+   "tmp/batch/a/x y.pdb",
+   "tmp/batch/b/small02.pdb",     # same name: appended as state 2
+   "tmp/batch/a/pept.cif",        # same name: appended as state 2
+   "tmp/batch/a/x_y.pdb",         # "x y" is processed into "x_y" too
+   "tmp/batch/b/small01.mol",
+]
+
+def feedback_of(func):
+   '''stdout of func(), including feedback from the C layer'''
+   sys.stdout.flush()
+   saved = os.dup(1)
+   with open("tmp/batch/out.txt", "w") as handle:
+      os.dup2(handle.fileno(), 1)
+      try:
+         func()
+      finally:
+         sys.stdout.flush()
+         os.dup2(saved, 1)
+         os.close(saved)
+   return open("tmp/batch/out.txt").read().splitlines()
+
+def summary():
+   out = []
+   for name in cmd.get_names("objects"):
+      colors = set()
+      cmd.iterate(name + " and elem C", "colors.add(color)",
+                  space={"colors": colors})
+      out.append((name, cmd.count_atoms(name), cmd.count_states(name),
+                  sorted(colors)))
+   return out
+
+for multiplex in (-2, 1):
+   kwargs = {"quiet": 0}
+   if multiplex != -2:
+      kwargs["multiplex"] = multiplex
+
+   cmd.delete("all")
+   cmd.set("auto_color_next", 0)
+   def load_loop():
+      for filename in files:
+         cmd.load(filename, **kwargs)
+   ref_output = feedback_of(load_loop)
+   ref = summary()
+
+   cmd.delete("all")
+   cmd.set("auto_color_next", 0)
+   output = feedback_of(lambda: cmd.load_batch(files, **kwargs))
+   result = summary()
+
+   assert [r[0] for r in result] == [r[0] for r in ref], (multiplex, result, ref)
+   for r, r_ref in zip(result, ref):
+      assert r == r_ref, (multiplex, r, r_ref)
+   assert output == ref_output, (multiplex, output, ref_output)
+
+   print("multiplex %d:" % multiplex)
+   for r in result:
+      print("  %-12s %3d atoms %d states colors %s" % r)
+   print("  %d feedback lines" % len(output))
+
+# glob pattern
+cmd.delete("all")
+cmd.load_batch("tmp/batch/b/*.mol*")
+print(cmd.get_names("objects"))
+
+shutil.rmtree("tmp/batch", True)
+
+print("END-LOG")
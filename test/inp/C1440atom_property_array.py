@@ -0,0 +1,139 @@
+# -c
+
+# get_atom_property_array/set_atom_property_array against iterate/alter:
+# numeric and string columns (object arrays and (codes, categories)),
+# the alter side effects of elem, resv, ss and formal_charge, and errors
+# in the middle of a column, which keep the atoms set so far.
+
+import io
+import sys
+import numpy
+import pymol
+from pymol import cmd
+
+print("BEGIN-LOG")
+
+cmd.feedback("disable", "all", "errors")
+
+props = ("name", "resn", "resi", "resv", "chain", "segi", "alt", "elem",
+         "b", "q", "vdw", "type", "formal_charge", "partial_charge", "ss",
+         "protons", "color", "ID", "rank", "flags", "text_type")
+
+def iterate(sele, prop):
+   out = []
+   cmd.iterate(sele, "out.append(%s)" % prop, space={"out": out})
+   return out
+
+def dump(sele):
+   return iterate(sele, "(" + ", ".join(props) + ",)")
+
+cmd.load("dat/pept.pdb", "m")
+cmd.load("dat/small03.mol2", "l", discrete=1)
+cmd.dss("m")
+sele = "(m and not resi 3) or (l and state 2)"
+
+# numeric columns
+for prop, dtype in [("b", "float32"), ("q", "float32"), ("vdw", "float32"),
+                    ("partial_charge", "float32"), ("formal_charge", "int8"),
+                    ("resv", "int32"), ("color", "int32"), ("protons", "int8"),
+                    ("ID", "int32"), ("rank", "int32"), ("index", "int32")]:
+   array = cmd.get_atom_property_array(prop, sele)
+   assert array.dtype == dtype, (prop, array.dtype)
+   assert array.tolist() == numpy.array(iterate(sele, prop), dtype).tolist(), prop
+   print("get %-15s %s" % (prop, array.dtype))
+
+# string columns
+for prop in ("name", "resn", "chain", "segi", "alt", "elem", "ss", "text_type"):
+   ref = iterate(sele, prop)
+   array = cmd.get_atom_property_array(prop, sele)
+   assert array.dtype == object and array.tolist() == ref, prop
+   codes, categories = cmd.get_atom_property_array(prop, sele, codes=1)
+   assert codes.dtype == "int32", prop
+   assert len(categories) == len(set(ref)), prop
+   assert [categories[c] for c in codes] == ref, prop
+   print("get %-15s %d categories" % (prop, len(categories)))
+
+# setting must give the same atoms as alter, including side effects
+def compare(label, prop, values, expr):
+   cmd.delete("a c")
+   cmd.create("a", "m")
+   cmd.create("c", "m")
+   cmd.set_atom_property_array(prop, values, "a")
+   it = iter(list(values) if not isinstance(values, tuple) else
+             [values[1][c] for c in values[0]])
+   cmd.alter("c", expr, space={"it": it})
+   assert dump("a") == dump("c"), label
+   print("set %-15s same as alter" % label)
+
+n = cmd.count_atoms("m")
+compare("b (float64)", "b", numpy.linspace(0, 10, n), "b = next(it)")
+compare("q (list)", "q", [0.5] * n, "q = next(it)")
+compare("formal_charge", "formal_charge", numpy.arange(n) % 3 - 1,
+        "formal_charge = next(it)")
+compare("resv", "resv", numpy.arange(n) // 7 + 100, "resv = next(it)")
+compare("elem", "elem", numpy.array(["N", "O", "S"] * n, object)[:n],
+        "elem = next(it)")
+compare("ss", "ss", (numpy.arange(n) % 3, ["h", "s", "l"]), "ss = next(it)")
+compare("name (codes)", "name", (numpy.arange(n) % 2, ["X1", "X2"]),
+        "name = next(it)")
+compare("chain", "chain", ["Q"] * n, "chain = next(it)")
+
+# the memoized selection terms see the new values
+cmd.set_atom_property_array("b", numpy.full(n, 42.0), "m")
+assert cmd.count_atoms("m and b > 41") == n
+cmd.set_atom_property_array("name", ["ZZ"] * n, "m")
+assert cmd.count_atoms("m and name ZZ") == n
+print("selections updated")
+
+# errors
+def fails(func):
+   # the Python error is printed by the C layer, keep it out of the log
+   stderr, sys.stderr = sys.stderr, io.StringIO()
+   try:
+      func()
+   except pymol.CmdException:
+      return True
+   finally:
+      sys.stderr = stderr
+   return False
+
+cmd.delete("a")
+cmd.create("a", "m")
+cmd.alter("a", "b = 1.0")
+before = dump("a")
+
+assert fails(lambda: cmd.set_atom_property_array("b", [2.0] * (n - 1), "a"))
+assert fails(lambda: cmd.set_atom_property_array("index", [1] * n, "a"))
+assert fails(lambda: cmd.set_atom_property_array("no_such_prop", [1] * n, "a"))
+# numeric columns are converted as a whole before any atom is set
+values = [2.0] * n
+values[n // 2] = "x"
+assert fails(lambda: cmd.set_atom_property_array("b", values, "a"))
+assert dump("a") == before
+print("rejected before any change")
+
+# bad value in the middle: atoms before it are set, the rest unchanged
+class Unprintable:
+   def __str__(self):
+      raise ValueError("no string")
+
+values = ["Y"] * n
+values[n // 2] = Unprintable()
+assert fails(lambda: cmd.set_atom_property_array("segi", values, "a"))
+segi = iterate("a", "segi")
+assert segi[:n // 2] == ["Y"] * (n // 2)
+assert segi[n // 2:] == iterate("m", "segi")[n // 2:]
+assert cmd.count_atoms("a and segi Y") == n // 2
+print("failed at %d of %d, kept %d" % (n // 2 + 1, n, n // 2))
+
+# bad category code in the middle
+codes = numpy.zeros(n, "int32")
+codes[n // 3] = 5
+assert fails(lambda: cmd.set_atom_property_array("chain", (codes, ["C"]), "a"))
+chain = iterate("a", "chain")
+assert chain[:n // 3] == ["C"] * (n // 3)
+assert chain[n // 3:] == iterate("m", "chain")[n // 3:]
+assert cmd.count_atoms("a and chain C") == n // 3
+print("failed at %d of %d, kept %d" % (n // 3 + 1, n, n // 3))
+
+print("END-LOG")
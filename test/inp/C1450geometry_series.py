@@ -0,0 +1,92 @@
+# -c
+
+# get_distance/angle/dihedral/gyration_series and get_rmsf against loops
+# over states with get_distance, get_angle, get_dihedral, get_coords and
+# rms_cur, on a small multi-state object. The last state lacks some
+# atoms (NaN), the second object is single-state (static).
+
+import math
+import numpy
+import pymol
+from pymol import cmd
+
+print("BEGIN-LOG")
+
+cmd.feedback("disable", "all", "everything")
+
+cmd.load("dat/pept.pdb", "pept")
+cmd.create("m", "pept", 1, 1)
+for state in range(2, 6):
+   cmd.create("m", "pept", 1, state)
+   cmd.alter_state(state, "m", "(x, y, z) = (x + 0.3 * sin(ID * k), "
+                   "y + 0.2 * cos(ID + k), z - 0.1 * k)",
+                   space={"sin": math.sin, "cos": math.cos, "k": state})
+cmd.create("m", "pept and resi 1-5", 1, 6)
+cmd.create("s", "pept and resi 10", 1, 1)
+cmd.translate([3, 0, 0], "s", camera=0)
+
+n_state = cmd.count_states("m")
+
+def close(a, b):
+   if math.isnan(a) or math.isnan(b):
+      return math.isnan(a) and math.isnan(b)
+   return abs(a - b) < 1e-3
+
+def loop(func, *atoms):
+   out = []
+   for state in range(1, n_state + 1):
+      try:
+         out.append(func(*atoms, state=state))
+      except pymol.CmdException:
+         out.append(float("nan"))
+   return out
+
+def check(label, series, ref):
+   series = series.tolist()
+   assert len(series) == len(ref), (label, len(series), len(ref))
+   for state, (a, b) in enumerate(zip(series, ref), 1):
+      assert close(a, b), (label, state, a, b)
+   print("%-20s %s" % (label, " ".join("%.3f" % v for v in series)))
+
+a1, a2, a3, a4 = "m///2/N", "m///2/CA", "m///2/C", "m///3/N"
+far = "m///8/CA"
+static = "s///10/CA"
+
+check("distance", cmd.get_distance_series(a1, a2), loop(cmd.get_distance, a1, a2))
+check("distance (missing)", cmd.get_distance_series(a1, far),
+      loop(cmd.get_distance, a1, far))
+check("distance (static)", cmd.get_distance_series(a2, static),
+      loop(cmd.get_distance, a2, static))
+check("angle", cmd.get_angle_series(a1, a2, a3), loop(cmd.get_angle, a1, a2, a3))
+check("dihedral", cmd.get_dihedral_series(a1, a2, a3, a4),
+      loop(cmd.get_dihedral, a1, a2, a3, a4))
+
+# first/last
+series = cmd.get_distance_series(a1, a2, first=2, last=4)
+check("distance 2-4", series, loop(cmd.get_distance, a1, a2)[1:4])
+
+# radius of gyration from the coordinates
+def gyration(state):
+   xyz = cmd.get_coords("m", state)
+   return math.sqrt(((xyz - xyz.mean(0)) ** 2).sum(1).mean())
+
+check("gyration", cmd.get_gyration_series("m"),
+      [gyration(state) for state in range(1, n_state + 1)])
+
+# RMSF over the complete states 1-5: per atom from the coordinates, and
+# overall (mean square over atoms) from rms_cur against the mean structure
+xyz = numpy.array([cmd.get_coords("m", state) for state in range(1, 6)])
+mean = xyz.mean(0)
+rmsf = cmd.get_rmsf("m", first=1, last=5)
+ref = numpy.sqrt(((xyz - mean) ** 2).sum(2).mean(0))
+assert rmsf.shape == ref.shape
+assert numpy.allclose(rmsf, ref, atol=1e-3)
+
+cmd.create("avg", "m", 1, 1)
+cmd.load_coords(mean, "avg", state=1)
+rms = [cmd.rms_cur("m", "avg", state, 1, matchmaker=-1) for state in range(1, 6)]
+assert close(math.sqrt((rmsf ** 2).mean()), math.sqrt(numpy.mean(numpy.square(rms))))
+print("rmsf %d atoms, max %.3f, overall %.3f" % (len(rmsf), rmsf.max(),
+      math.sqrt((rmsf ** 2).mean())))
+
+print("END-LOG")
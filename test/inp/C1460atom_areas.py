@@ -0,0 +1,45 @@
+# -c
+
+# get_atom_areas: the per-atom areas must add up to get_area for the same
+# selection and state, with dot_solvent off (solvent excluded) and on
+# (solvent accessible). state=-1 is the current state, state=0 all states.
+
+import math
+from pymol import cmd
+
+print("BEGIN-LOG")
+
+cmd.load("dat/pept.pdb", "m")
+cmd.create("m", "m", 1, 2)
+cmd.translate([0.5, 0, 0], "m and resi 3", state=2, camera=0)
+cmd.create("m", "m and resi 1-5", 1, 3)
+
+def close(a, b):
+   return abs(a - b) < 1e-3 * max(1.0, abs(b))
+
+for dot_solvent in (0, 1):
+   cmd.set("dot_solvent", dot_solvent)
+   for sele in ("m", "m and resi 2-5", "m and name CA"):
+      for state in (1, 2):
+         areas = cmd.get_atom_areas(sele, state)
+         assert len(areas) == cmd.count_atoms(sele)
+         total = cmd.get_area(sele, state)
+         assert close(areas.sum(), total), (dot_solvent, sele, state)
+         print("dot_solvent %d %-16s state %d %9.2f" % (dot_solvent, sele,
+               state, total))
+
+   # current state
+   cmd.frame(2)
+   assert close(cmd.get_atom_areas("m", -1).sum(), cmd.get_area("m", 2))
+
+   # all states, atoms without coordinates give NaN
+   areas = cmd.get_atom_areas("m", 0)
+   assert areas.shape == (3, cmd.count_atoms("m"))
+   for state in (1, 2):
+      assert close(areas[state - 1].sum(), cmd.get_area("m", state))
+   n_nan = sum(math.isnan(a) for a in areas[2])
+   assert n_nan == cmd.count_atoms("m and not resi 1-5")
+   print("dot_solvent %d all states %s, %d without coordinates" % (
+         dot_solvent, areas.shape, n_nan))
+
+print("END-LOG")
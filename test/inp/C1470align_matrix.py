@@ -0,0 +1,69 @@
+# -c
+
+# align_matrix: every off-diagonal RMSD, atom count and score must equal
+# a separate "align" of the same pair (transform=0). Two of the
+# selections come from the same object: align excludes the mobile object
+# from the target, so both must fail for that pair.
+
+import os
+import sys
+from pymol import cmd
+
+print("BEGIN-LOG")
+
+cmd.feedback("disable", "all", "actions results details")
+
+def feedback_of(func):
+   '''stdout of func(), including feedback from the C layer'''
+   sys.stdout.flush()
+   saved = os.dup(1)
+   with open("tmp/align_matrix.txt", "w") as handle:
+      os.dup2(handle.fileno(), 1)
+      try:
+         func()
+      finally:
+         sys.stdout.flush()
+         os.dup2(saved, 1)
+         os.close(saved)
+   out = open("tmp/align_matrix.txt").read().splitlines()
+   os.remove("tmp/align_matrix.txt")
+   return out
+
+cmd.load("dat/1tii.pdb", "t")
+for chain in "DEF":
+   cmd.create(chain.lower(), "t and chain " + chain)
+cmd.rotate("y", 30, "e", camera=0)
+cmd.translate([5, 0, 0], "f", camera=0)
+cmd.remove("f and resi 50-60")
+
+seles = ["d", "e", "f and resi 1-80", "t and chain G", "t and chain H"]
+
+for cycles in (0, 5):
+   out = feedback_of(lambda: cmd.align_matrix(seles, cycles=cycles))
+   assert out == [], out
+   names, rms, n_atom, score = cmd.align_matrix(seles, cycles=cycles)
+   assert names == seles
+   for i, mobile in enumerate(seles):
+      for j, target in enumerate(seles):
+         if i == j:
+            continue
+         if mobile.startswith("t ") and target.startswith("t "):
+            out = feedback_of(lambda: cmd.align(mobile, target,
+                                                cycles=cycles, transform=0))
+            assert out == [" ExecutiveAlign: invalid selections for alignment."], out
+            assert rms[i][j] == -1.0 and n_atom[i][j] == 0
+            continue
+         r = cmd.align(mobile, target, cycles=cycles, transform=0)
+         assert abs(rms[i][j] - r[0]) < 1e-4, (cycles, mobile, target, rms[i][j], r)
+         assert n_atom[i][j] == r[1], (cycles, mobile, target, n_atom[i][j], r)
+         assert abs(score[i][j] - r[5]) < 1e-3, (cycles, mobile, target, score[i][j], r)
+   print("cycles %d:" % cycles)
+   for i in range(len(seles)):
+      print("  " + " ".join("%5.2f/%4d" % (rms[i][j], n_atom[i][j])
+                            for j in range(len(seles))))
+
+# selection string: one entry per object
+names = cmd.align_matrix("d or e or (t and chain G)")[0]
+print(names)
+
+print("END-LOG")
@@ -0,0 +1,46 @@
+# -c
+
+# Benchmark: distance-based bond perception (ObjectMoleculeConnect) on
+# a large PDB assembly without CONECT records, serial vs. threaded.
+# Tiles are far enough apart to not bond with each other, so every
+# thread count must find the same bonds as 64 separate copies.
+
+import time
+from pymol import cmd
+
+print("BEGIN-LOG")
+
+# tile 1tii into a 8 x 8 grid (~360k atoms)
+lines = [l for l in open("dat/1tii.pdb") if l.startswith(("ATOM", "HETATM"))]
+pdb = []
+for k in range(64):
+   dx = 80.0 * (k % 8)
+   dy = 80.0 * (k // 8)
+   for l in lines:
+      x = float(l[30:38]) + dx
+      y = float(l[38:46]) + dy
+      pdb.append("%s%8.3f%8.3f%s" % (l[:30], x, y, l[46:]))
+pdb = "".join(pdb) + "END\n"
+
+cmd.read_pdbstr("".join(lines) + "END\n", "tile")
+n_tile_atom = cmd.count_atoms("tile")
+n_tile_bond = len(cmd.get_bonds("tile"))
+cmd.delete("tile")
+
+ref = None
+for n_thread in (1, 2, 4, 8):
+   cmd.set("max_threads", n_thread)
+   t0 = time.time()
+   cmd.read_pdbstr(pdb, "big")
+   t1 = time.time()
+   bonds = cmd.get_bonds("big")
+   if ref is None:
+      ref = bonds
+   assert cmd.count_atoms("big") == 64 * n_tile_atom
+   assert len(bonds) == 64 * n_tile_bond
+   assert bonds == ref
+   print("max_threads %d: %d atoms %d bonds %.2fs" % (
+      n_thread, cmd.count_atoms("big"), len(bonds), t1 - t0))
+   cmd.delete("big")
+
+print("END-LOG")
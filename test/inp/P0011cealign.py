@@ -0,0 +1,48 @@
+# -c
+
+# Benchmark: cealign over a fixed set of chain pairs, serial vs.
+# threaded. RMSD, alignment length and rotation matrix of every pair must
+# be identical to the serial (max_threads 1) result.
+
+import time
+from pymol import cmd
+
+print("BEGIN-LOG")
+
+cmd.load("dat/1tii.pdb", "t")
+cmd.load("dat/3al1.pdb", "a")
+cmd.load("dat/il2.pdb", "i")
+
+names = []
+for obj in ("t", "a", "i"):
+   for chain in cmd.get_chains(obj):
+      name = "%s_%s" % (obj, chain or "x")
+      cmd.create(name, "%s and chain '%s' and polymer" % (obj, chain))
+      if cmd.count_atoms(name + " and name CA") > 30:
+         names.append(name)
+
+# multi-chain pairs
+cmd.create("t_all", "t and polymer")
+cmd.create("a_all", "a and polymer")
+names += ["t_all", "a_all"]
+
+pairs = [(a, b) for a in names for b in names if a < b]
+
+ref = None
+for n_thread in (1, 2, 4, 8):
+   cmd.set("max_threads", n_thread)
+   results = []
+   t0 = time.time()
+   for (target, mobile) in pairs:
+      r = cmd.cealign(target, mobile, transform=0)
+      results.append((r["alignment_length"], r["RMSD"], r["rotation_matrix"]))
+   t1 = time.time()
+   if ref is None:
+      ref = results
+   for pair, r, r_ref in zip(pairs, results, ref):
+      assert r[0] == r_ref[0], (n_thread, pair, "alignment_length", r[0], r_ref[0])
+      assert r[1] == r_ref[1], (n_thread, pair, "RMSD", r[1], r_ref[1])
+      assert r[2] == r_ref[2], (n_thread, pair, "rotation_matrix")
+   print("max_threads %d: %d pairs %.2fs" % (n_thread, len(pairs), t1 - t0))
+
+print("END-LOG")
@@ -0,0 +1,56 @@
+# -c
+
+# Benchmark: movie playback with and without movie_prefetch. Each frame
+# is followed by a fixed display time, during which prefetched states
+# get built in the background. Reports the time spent updating each
+# frame on the main thread; all states must render identically.
+
+import time
+from pymol import cmd
+
+print("BEGIN-LOG")
+
+cmd.load("dat/1tii.pdb", "m")
+for state in range(2, 13):
+   cmd.create("m", "m and state 1", 1, state)
+   cmd.translate([0.1 * state, 0, 0], "m", state=state, camera=0)
+cmd.show_as("cartoon sticks surface", "chain G")
+cmd.set("defer_builds_mode", 1)
+cmd.set("max_threads", 4)
+
+display_time = 0.5
+ref = None
+busy_ref = None
+for prefetch in (0, 2, 4):
+   cmd.rebuild()
+   cmd.set("movie_prefetch", prefetch)
+   cmd.frame(1)
+   cmd.refresh()
+   cmd.get_rep_cache_stats(reset=1)
+   cmd.mplay()
+   busy = []
+   for frame in range(2, 13):
+      t0 = time.time()
+      cmd.frame(frame)
+      cmd.refresh()
+      busy.append(time.time() - t0)
+      time.sleep(display_time)
+   cmd.mstop()
+   stats = cmd.get_rep_cache_stats()
+
+   scenes = []
+   for frame in range(1, 13):
+      cmd.frame(frame)
+      scenes.append(cmd.get_povray())
+   if ref is None:
+      ref = scenes
+      busy_ref = sum(busy)
+   assert scenes == ref
+   if prefetch:
+      # upcoming states were built while the previous ones were shown
+      assert stats["prefetched"] > 0
+      assert sum(busy) < busy_ref
+   print("movie_prefetch %d: %d prefetched, update %.2fs (max %.2fs per frame)" % (
+      prefetch, stats["prefetched"], sum(busy), max(busy)))
+
+print("END-LOG")
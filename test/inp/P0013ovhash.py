@@ -0,0 +1,44 @@
+# -c
+
+# Benchmark: the ov hash tables (cmd.test group 2). Test 0 times and
+# checks inserts, lookups, misses, reverse lookups and deletes on 1M
+# sequential and random keys. Test 2 rebuilds the unique id -> atom
+# dictionary of a label/setting-heavy session and looks up every atom in
+# it and in the per-atom settings. cmd.test raises if any check fails.
+
+import time
+from pymol import cmd
+
+print("BEGIN-LOG")
+
+cmd.feedback("enable", "executive", "results")
+
+cmd.test(2, 0)
+
+# tile 1tii into a 4 x 4 grid (~100k atoms) with per-atom settings and labels
+lines = [l for l in open("dat/1tii.pdb") if l.startswith(("ATOM", "HETATM"))]
+pdb = []
+for k in range(16):
+   dx = 80.0 * (k % 4)
+   dy = 80.0 * (k // 4)
+   for l in lines:
+      x = float(l[30:38]) + dx
+      y = float(l[38:46]) + dy
+      pdb.append("%s%8.3f%8.3f%s" % (l[:30], x, y, l[46:]))
+cmd.read_pdbstr("".join(pdb) + "END\n", "big")
+cmd.set("sphere_scale", 0.3, "big and elem C")
+cmd.set("label_color", "red", "big and name CA")
+cmd.label("big and name CA", "resn")
+
+cmd.test(2, 2)
+
+# session round trip of the per-atom settings
+session = cmd.get_session()
+t0 = time.time()
+cmd.set_session(session)
+t1 = time.time()
+assert cmd.count_atoms("big") == len(lines) * 16
+cmd.test(2, 2)
+print("set_session %.2fs" % (t1 - t0))
+
+print("END-LOG")